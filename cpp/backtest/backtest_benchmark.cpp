@@ -0,0 +1,83 @@
+// BacktestEngine throughput on a day-sized synthetic tape: events (trades
+// plus fills) per second through the whole loop, with a strategy that
+// keeps a limit order working on each side and a final execution model,
+// against the same loop through the virtual ExecutionModel interface.
+//
+// Run: bazel run -c opt //cpp/backtest:backtest_benchmark
+
+#include "backtest_engine.h"
+#include "cpp/execution/trade_through_execution.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace signalforge {
+namespace {
+
+const std::vector<Trade>& tape() {
+    static const std::vector<Trade> trades = [] {
+        std::mt19937_64 rng(5);
+        std::uniform_int_distribution<int> step(-2, 2);
+        std::vector<Trade> t;
+        const size_t n = 1000000;
+        t.reserve(n);
+        Price price = 4250000;
+        for (size_t i = 0; i < n; ++i) {
+            price += step(rng);
+            t.push_back({i, price, 1705276800000 + i * 80});
+        }
+        return t;
+    }();
+    return trades;
+}
+
+// Quotes one unit `offset` ticks either side of the last trade whenever
+// the previous quote on that side has filled
+class QuotingStrategy : public Strategy {
+public:
+    explicit QuotingStrategy(Price offset) : offset_(offset) {}
+
+    void on_trade(Price price, uint64_t) override {
+        if (!bid_open_) {
+            exec_->submit({Side::BID, OrderType::LIMIT, price - offset_, 1});
+            bid_open_ = true;
+        }
+        if (!ask_open_) {
+            exec_->submit({Side::ASK, OrderType::LIMIT, price + offset_, 1});
+            ask_open_ = true;
+        }
+    }
+
+    void on_fill(const Fill& fill) override {
+        (fill.side == Side::BID ? bid_open_ : ask_open_) = false;
+    }
+
+private:
+    Price offset_;
+    bool bid_open_ = false;
+    bool ask_open_ = false;
+};
+
+template <typename Execution>
+void BM_Backtest(benchmark::State& state) {
+    const std::vector<Trade>& trades = tape();
+    BacktestResults r;
+    for (auto _ : state) {
+        QuotingStrategy strategy(static_cast<Price>(state.range(0)));
+        TradeOnlyMarketView market;
+        BasicTradeThroughExecution<TradeOnlyMarketView> exec(market);
+        BasicBacktestEngine<Execution> engine(strategy, exec, market);
+        engine.run(trades);
+        r = engine.finish();
+        benchmark::DoNotOptimize(r.total_pnl);
+    }
+    state.counters["fills"] = static_cast<double>(r.fills);
+    state.counters["events/s"] = benchmark::Counter(static_cast<double>(state.iterations() * r.events),
+                                                    benchmark::Counter::kIsRate);
+}
+BENCHMARK_TEMPLATE(BM_Backtest, BasicTradeThroughExecution<TradeOnlyMarketView>)
+    ->Arg(2)->Arg(20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Backtest, ExecutionModel)->Arg(2)->Arg(20)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace signalforge
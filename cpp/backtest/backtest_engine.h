@@ -0,0 +1,142 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "position_tracker.h"
+#include "results.h"
+#include "strategy.h"
+#include "cpp/interfaces/execution_model.h"
+#include "cpp/market/trade_only_market_view.h"
+#include "cpp/trades/trade_csv_loader.h"
+
+namespace signalforge {
+
+// Event loop of a single-instrument backtest. For each trade, in order:
+//   1. the market view takes the trade price
+//   2. the execution model moves to the trade's timestamp and ticks,
+//      matching the orders already submitted (or, under LatencyExecution,
+//      already arrived)
+//   3. cancel/replace outcomes go to Strategy::on_order_event
+//   4. each fill goes to the position tracker, then to Strategy::on_fill
+//   5. Strategy::on_trade sees the trade and may submit, cancel or replace
+// An order is therefore first matched against the trade after the one the
+// strategy reacted to, never at a price it has already seen.
+//
+// BacktestResults are kept up to date as events arrive (drawdown of the
+// marked-to-market PnL after every trade, win/loss per closing fill), so
+// nothing is recorded per event and the loop does not allocate. With final
+// Execution and Market types (e.g. BasicTradeThroughExecution over a
+// TradeOnlyMarketView) only the strategy is called virtually.
+//
+// Replays are deterministic: the same trades and strategy give the same
+// results, apart from the timing fields.
+template <typename Execution = ExecutionModel, typename Market = TradeOnlyMarketView>
+class BasicBacktestEngine {
+public:
+    // Connects the strategy to the execution model. The engine holds
+    // references; all three must outlive it.
+    BasicBacktestEngine(Strategy& strategy, Execution& execution, Market& market)
+        : strategy_(strategy), execution_(execution), market_(market) {
+        strategy_.set_execution_model(&execution_);
+    }
+
+    // Replays trades in order. Later calls continue from where the last
+    // one stopped, e.g. one day per call. The first call initializes the
+    // strategy.
+    void run(const Trade* trades, size_t count) {
+        if (!started_) {
+            started_ = true;
+            strategy_.intialize();
+        }
+        if (count == 0) return;
+        if (results_.events == 0) results_.start_timestamp = trades[0].timestamp;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            const Trade& trade = trades[i];
+            market_.on_trade(trade.price);
+            execution_.advance_time(trade.timestamp);
+            execution_.on_tick();
+
+            OrderEvent event;
+            while (execution_.poll_event(event)) strategy_.on_order_event(event);
+            Fill fill;
+            while (execution_.poll_fill(fill)) on_fill(fill);
+
+            strategy_.on_trade(trade.price, trade.timestamp);
+
+            const double equity = tracker_.total_pnl(trade.price);
+            peak_equity_ = std::max(peak_equity_, equity);
+            results_.max_drawdown = std::max(results_.max_drawdown, peak_equity_ - equity);
+        }
+        run_time_ += std::chrono::steady_clock::now() - start;
+
+        last_price_ = trades[count - 1].price;
+        results_.end_timestamp = trades[count - 1].timestamp;
+        results_.events += count;
+    }
+
+    void run(const std::vector<Trade>& trades) { run(trades.data(), trades.size()); }
+
+    // Results so far, with the open position marked at the last trade
+    BacktestResults results() const {
+        BacktestResults r = results_;
+        r.realized_pnl = tracker_.realized_pnl();
+        r.unrealized_pnl = tracker_.unrealized_pnl(last_price_);
+        r.total_pnl = r.realized_pnl + r.unrealized_pnl;
+        r.win_rate = r.total_trades == 0 ? 0.0 : 100.0 * static_cast<double>(r.winning_trades) / r.total_trades;
+        const double seconds = std::chrono::duration<double>(run_time_).count();
+        r.events_per_second = seconds > 0 ? static_cast<double>(r.events) / seconds : 0.0;
+        return r;
+    }
+
+    // Finalizes the strategy, once, and returns the results
+    BacktestResults finish() {
+        if (!finished_) {
+            finished_ = true;
+            strategy_.finalize();
+        }
+        return results();
+    }
+
+    const PositionTracker& tracker() const { return tracker_; }
+
+private:
+    void on_fill(const Fill& fill) {
+        const Quantity before = tracker_.position();
+        const double realized_before = tracker_.realized_pnl();
+        tracker_.on_fill(fill);
+
+        // A fill against the open position closes (part of) it
+        const bool closing = (before > 0 && fill.side == Side::ASK) || (before < 0 && fill.side == Side::BID);
+        if (closing) {
+            ++results_.total_trades;
+            const double realized = tracker_.realized_pnl() - realized_before;
+            if (realized > 0) ++results_.winning_trades;
+            if (realized < 0) ++results_.losing_trades;
+        }
+        ++results_.fills;
+        ++results_.events;
+        results_.max_position = std::max(results_.max_position, static_cast<double>(std::abs(tracker_.position())));
+
+        strategy_.on_fill(fill);
+    }
+
+    Strategy& strategy_;
+    Execution& execution_;
+    Market& market_;
+    PositionTracker tracker_;
+    BacktestResults results_;
+    double peak_equity_ = 0.0;
+    Price last_price_ = 0;
+    std::chrono::steady_clock::duration run_time_{0};
+    bool started_ = false;
+    bool finished_ = false;
+};
+
+using BacktestEngine = BasicBacktestEngine<>;
+
+}  // namespace signalforge
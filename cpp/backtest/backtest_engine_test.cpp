@@ -0,0 +1,216 @@
+#include "backtest_engine.h"
+#include "cpp/execution/latency_execution.h"
+#include "cpp/execution/trade_through_execution.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace signalforge {
+
+namespace {
+
+// Submits scripted orders at given trade indices and logs every callback
+class ScriptedStrategy : public Strategy {
+public:
+    struct Step {
+        size_t at_trade;
+        OrderIntent intent;
+    };
+
+    explicit ScriptedStrategy(std::vector<Step> script) : script_(std::move(script)) {}
+
+    void intialize() override { log.push_back("init"); }
+    void finalize() override { log.push_back("final"); }
+
+    void on_trade(Price price, uint64_t) override {
+        log.push_back("trade " + std::to_string(price));
+        for (const Step& s : script_) {
+            if (s.at_trade == trades_) exec_->submit(s.intent);
+        }
+        ++trades_;
+    }
+
+    void on_fill(const Fill& fill) override {
+        log.push_back("fill " + std::to_string(fill.order_id) + " @" + std::to_string(fill.price));
+    }
+
+    std::vector<std::string> log;
+
+private:
+    std::vector<Step> script_;
+    size_t trades_ = 0;
+};
+
+std::vector<Trade> trades_at(const std::vector<Price>& prices) {
+    std::vector<Trade> trades;
+    for (size_t i = 0; i < prices.size(); ++i) trades.push_back({i + 1, prices[i], 1000 + i});
+    return trades;
+}
+
+}  // namespace
+
+TEST(BacktestEngineTest, CallbackOrderAndNoSameTradeFill) {
+    ScriptedStrategy strategy({{0, {Side::BID, OrderType::MARKET, 0, 1}}});
+    TradeOnlyMarketView market;
+    BasicTradeThroughExecution<TradeOnlyMarketView> exec(market);
+    BasicBacktestEngine<BasicTradeThroughExecution<TradeOnlyMarketView>> engine(strategy, exec, market);
+
+    engine.run(trades_at({100, 101, 102}));
+    engine.finish();
+    engine.finish();
+
+    // The market order placed on the first trade fills at the second
+    const std::vector<std::string> want = {"init", "trade 100", "fill 1 @101", "trade 101", "trade 102", "final"};
+    EXPECT_EQ(strategy.log, want);
+    EXPECT_EQ(engine.tracker().position(), 1);
+}
+
+// Trade timestamps drive the latency wrapper: an order sent on the first
+// trade (t=1000) with 2 ms of delay first meets the market at t=1002
+TEST(BacktestEngineTest, LatencyDelaysOrdersByTradeTime) {
+    ScriptedStrategy strategy({{0, {Side::BID, OrderType::MARKET, 0, 1}}});
+    TradeOnlyMarketView market;
+    BasicTradeThroughExecution<TradeOnlyMarketView> inner(market);
+    FixedLatency delay(2);
+    LatencyExecution<BasicTradeThroughExecution<TradeOnlyMarketView>> exec(inner, delay);
+    BasicBacktestEngine<LatencyExecution<BasicTradeThroughExecution<TradeOnlyMarketView>>> engine(strategy, exec,
+                                                                                                   market);
+
+    engine.run(trades_at({100, 101, 102, 103}));
+    const std::vector<std::string> want = {"init", "trade 100", "trade 101", "fill 1 @102", "trade 102", "trade 103"};
+    EXPECT_EQ(strategy.log, want);
+}
+
+TEST(BacktestEngineTest, ResultsFromRoundTrips) {
+    // Prices in ticks; each order fills at the trade after it is placed
+    ScriptedStrategy strategy({
+        {0, {Side::BID, OrderType::MARKET, 0, 1}},   // fills @10000
+        {2, {Side::ASK, OrderType::MARKET, 0, 1}},   // fills @10300, +3 win
+        {3, {Side::ASK, OrderType::MARKET, 0, 2}},   // short 2 @10200
+        {5, {Side::BID, OrderType::MARKET, 0, 1}},   // cover 1 @10400, -2 loss
+        {6, {Side::BID, OrderType::MARKET, 0, 1}},   // cover 1 @10200, break even
+    });
+    TradeOnlyMarketView market;
+    TradeThroughExecution exec(market);
+    BacktestEngine engine(strategy, exec, market);
+
+    engine.run(trades_at({9900, 10000, 10100, 10300, 10200, 10500, 10400, 10200, 10100}));
+    const BacktestResults r = engine.finish();
+
+    EXPECT_EQ(r.fills, 5);
+    EXPECT_EQ(r.total_trades, 3);
+    EXPECT_EQ(r.winning_trades, 1);
+    EXPECT_EQ(r.losing_trades, 1);
+    EXPECT_DOUBLE_EQ(r.win_rate, 100.0 / 3);
+    EXPECT_DOUBLE_EQ(r.realized_pnl, 1.0);
+    EXPECT_DOUBLE_EQ(r.unrealized_pnl, 0.0);
+    EXPECT_DOUBLE_EQ(r.total_pnl, 1.0);
+    EXPECT_DOUBLE_EQ(r.max_position, 2.0);
+    // Peak +3 after the first round trip, trough -3 marked at 10500 while
+    // short 2 from 10200
+    EXPECT_DOUBLE_EQ(r.max_drawdown, 6.0);
+    EXPECT_EQ(r.start_timestamp, 1000);
+    EXPECT_EQ(r.end_timestamp, 1008);
+    EXPECT_EQ(r.events, 9 + 5);
+    EXPECT_GT(r.events_per_second, 0.0);
+}
+
+TEST(BacktestEngineTest, RunsContinueAcrossCalls) {
+    const auto trades = trades_at({100, 99, 98, 101, 104, 100, 97, 103, 105, 102});
+    const std::vector<ScriptedStrategy::Step> script = {
+        {1, {Side::BID, OrderType::LIMIT, 98, 1}},
+        {3, {Side::ASK, OrderType::LIMIT, 104, 1}},
+        {5, {Side::BID, OrderType::LIMIT, 97, 2}},
+    };
+
+    ScriptedStrategy whole_strategy(script);
+    TradeOnlyMarketView whole_market;
+    TradeThroughExecution whole_exec(whole_market);
+    BacktestEngine whole(whole_strategy, whole_exec, whole_market);
+    whole.run(trades);
+    const BacktestResults a = whole.finish();
+
+    ScriptedStrategy split_strategy(script);
+    TradeOnlyMarketView split_market;
+    TradeThroughExecution split_exec(split_market);
+    BacktestEngine split(split_strategy, split_exec, split_market);
+    split.run(trades.data(), 4);
+    split.run(trades.data(), 0);
+    split.run(trades.data() + 4, trades.size() - 4);
+    const BacktestResults b = split.finish();
+
+    EXPECT_EQ(split_strategy.log, whole_strategy.log);
+    EXPECT_EQ(a.fills, 3);
+    EXPECT_EQ(b.fills, a.fills);
+    EXPECT_EQ(b.total_trades, a.total_trades);
+    EXPECT_DOUBLE_EQ(b.total_pnl, a.total_pnl);
+    EXPECT_DOUBLE_EQ(b.max_drawdown, a.max_drawdown);
+    EXPECT_EQ(b.start_timestamp, a.start_timestamp);
+    EXPECT_EQ(b.end_timestamp, a.end_timestamp);
+    EXPECT_EQ(b.events, a.events);
+}
+
+// Re-quotes on the second trade: cancels one bid and moves the other up
+class RequotingStrategy : public Strategy {
+public:
+    void on_trade(Price price, uint64_t) override {
+        log.push_back("trade " + std::to_string(price));
+        if (trades_ == 0) {
+            first_ = exec_->submit({Side::BID, OrderType::LIMIT, 100, 1});
+            second_ = exec_->submit({Side::BID, OrderType::LIMIT, 90, 1});
+        } else if (trades_ == 1) {
+            exec_->cancel(first_);
+            exec_->replace(second_, 100, 2);
+            exec_->cancel(first_);
+        }
+        ++trades_;
+    }
+
+    void on_order_event(const OrderEvent& event) override {
+        const char* names[] = {"cancelled", "cancel rejected", "replaced", "replace rejected"};
+        log.push_back(std::string(names[static_cast<int>(event.type)]) + " " + std::to_string(event.order_id));
+    }
+
+    void on_fill(const Fill& fill) override {
+        log.push_back("fill " + std::to_string(fill.order_id) + " x" + std::to_string(fill.qty));
+    }
+
+    std::vector<std::string> log;
+
+private:
+    size_t trades_ = 0;
+    OrderId first_ = 0;
+    OrderId second_ = 0;
+};
+
+TEST(BacktestEngineTest, OrderEventsArriveBeforeTheNextTradesFills) {
+    RequotingStrategy strategy;
+    TradeOnlyMarketView market;
+    TradeThroughExecution exec(market);
+    BacktestEngine engine(strategy, exec, market);
+
+    engine.run(trades_at({105, 104, 99}));
+    const std::vector<std::string> want = {
+        "trade 105", "trade 104",
+        "cancelled 1", "replaced 2", "cancel rejected 1", "fill 2 x2", "trade 99",
+    };
+    EXPECT_EQ(strategy.log, want);
+    EXPECT_EQ(engine.results().fills, 1u);
+}
+
+TEST(BacktestEngineTest, EmptyRun) {
+    ScriptedStrategy strategy({});
+    TradeOnlyMarketView market;
+    TradeThroughExecution exec(market);
+    BacktestEngine engine(strategy, exec, market);
+
+    engine.run({});
+    const BacktestResults r = engine.finish();
+    EXPECT_EQ(r.events, 0);
+    EXPECT_DOUBLE_EQ(r.total_pnl, 0.0);
+    EXPECT_DOUBLE_EQ(r.win_rate, 0.0);
+    EXPECT_DOUBLE_EQ(r.events_per_second, 0.0);
+    EXPECT_EQ(strategy.log, (std::vector<std::string>{"init", "final"}));
+}
+
+}  // namespace signalforge
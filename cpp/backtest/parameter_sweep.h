@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "backtest_engine.h"
+#include "results.h"
+#include "work_stealing.h"
+#include "cpp/execution/trade_through_execution.h"
+#include "cpp/market/trade_only_market_view.h"
+#include "cpp/trades/data_manager.h"
+
+namespace signalforge {
+
+// One row of a sweep's results table
+template <typename Params>
+struct SweepResult {
+    Params params;
+    BacktestResults results;
+};
+
+// Engine a sweep run uses: a final execution model over a trade-only view,
+// so only the strategy is called virtually
+using SweepExecution = BasicTradeThroughExecution<TradeOnlyMarketView>;
+using SweepEngine = BasicBacktestEngine<SweepExecution, TradeOnlyMarketView>;
+
+// Runs one backtest per entry of `grid`, spread over `threads` threads
+// (0: one per hardware thread) with parallel_for; replay(engine) feeds a
+// run its trades. The run_parameter_sweep overloads below are the usual
+// entry points.
+//
+// Each run gets its own strategy, from make_strategy(params) which returns
+// a std::unique_ptr<Strategy> and is called from the worker threads, and
+// its own TradeOnlyMarketView,
+// TradeThroughExecution and PositionTracker. The trades are loaded once by
+// the caller and only read, so runs share no mutable state and take no
+// locks.
+//
+// Rows are in grid order and each holds exactly what a sequential run of
+// that parameter set gives, whatever the thread count and scheduling;
+// only the timing field events_per_second varies. If make_strategy or a
+// run throws, the error of the first such entry in grid order is rethrown.
+template <typename Params, typename MakeStrategy, typename Replay>
+std::vector<SweepResult<Params>> run_sweep_with(
+    const std::vector<Params>& grid,
+    MakeStrategy make_strategy,
+    Replay replay,
+    size_t threads = 0
+) {
+    std::vector<SweepResult<Params>> table;
+    table.reserve(grid.size());
+    for (const Params& params : grid) table.push_back({params, {}});
+
+    parallel_for(grid.size(), threads, [&](size_t i) {
+        std::unique_ptr<Strategy> strategy = make_strategy(grid[i]);
+        TradeOnlyMarketView market;
+        SweepExecution execution(market);
+        SweepEngine engine(*strategy, execution, market);
+        replay(engine);
+        table[i].results = engine.finish();
+    });
+    return table;
+}
+
+// A sweep over one block of trades
+template <typename Params, typename MakeStrategy>
+std::vector<SweepResult<Params>> run_parameter_sweep(
+    const std::vector<Trade>& trades,
+    const std::vector<Params>& grid,
+    MakeStrategy make_strategy,
+    size_t threads = 0
+) {
+    return run_sweep_with(grid, make_strategy, [&](SweepEngine& engine) { engine.run(trades); }, threads);
+}
+
+// A sweep over the days of a DataManager::load_range result, replayed in
+// date order with positions carried across days
+template <typename Params, typename MakeStrategy>
+std::vector<SweepResult<Params>> run_parameter_sweep(
+    const std::vector<DataManager::DayTrades>& days,
+    const std::vector<Params>& grid,
+    MakeStrategy make_strategy,
+    size_t threads = 0
+) {
+    return run_sweep_with(grid, make_strategy, [&](SweepEngine& engine) {
+        for (const DataManager::DayTrades& day : days) engine.run(day.trades);
+    }, threads);
+}
+
+}  // namespace signalforge
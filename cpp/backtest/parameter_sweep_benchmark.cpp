@@ -0,0 +1,80 @@
+// Parameter sweep scaling: 32 quoting-strategy runs over one shared
+// day-sized synthetic tape, on 1, 2, 4 and 8 threads. Wall-clock time;
+// events/s is summed over all runs, so near-linear scaling shows as
+// events/s growing with the thread count up to the number of cores.
+//
+// Run: bazel run -c opt //cpp/backtest:parameter_sweep_benchmark
+
+#include "parameter_sweep.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace signalforge {
+namespace {
+
+const std::vector<Trade>& tape() {
+    static const std::vector<Trade> trades = [] {
+        std::mt19937_64 rng(5);
+        std::uniform_int_distribution<int> step(-2, 2);
+        std::vector<Trade> t;
+        const size_t n = 1000000;
+        t.reserve(n);
+        Price price = 4250000;
+        for (size_t i = 0; i < n; ++i) {
+            price += step(rng);
+            t.push_back({i, price, 1705276800000 + i * 80});
+        }
+        return t;
+    }();
+    return trades;
+}
+
+class QuotingStrategy : public Strategy {
+public:
+    explicit QuotingStrategy(Price offset) : offset_(offset) {}
+
+    void on_trade(Price price, uint64_t) override {
+        if (!bid_open_) {
+            exec_->submit({Side::BID, OrderType::LIMIT, price - offset_, 1});
+            bid_open_ = true;
+        }
+        if (!ask_open_) {
+            exec_->submit({Side::ASK, OrderType::LIMIT, price + offset_, 1});
+            ask_open_ = true;
+        }
+    }
+
+    void on_fill(const Fill& fill) override {
+        (fill.side == Side::BID ? bid_open_ : ask_open_) = false;
+    }
+
+private:
+    Price offset_;
+    bool bid_open_ = false;
+    bool ask_open_ = false;
+};
+
+void BM_ParameterSweep(benchmark::State& state) {
+    const std::vector<Trade>& trades = tape();
+    std::vector<Price> offsets;
+    for (Price offset = 1; offset <= 32; ++offset) offsets.push_back(offset);
+
+    size_t events = 0;
+    for (auto _ : state) {
+        const auto table = run_parameter_sweep(trades, offsets, [](Price offset) {
+            return std::make_unique<QuotingStrategy>(offset);
+        }, static_cast<size_t>(state.range(0)));
+        events = 0;
+        for (const auto& row : table) events += row.results.events;
+        benchmark::DoNotOptimize(table.data());
+    }
+    state.counters["runs/s"] = benchmark::Counter(static_cast<double>(state.iterations() * offsets.size()),
+                                                  benchmark::Counter::kIsRate);
+    state.counters["events/s"] = benchmark::Counter(static_cast<double>(state.iterations() * events),
+                                                    benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ParameterSweep)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace signalforge
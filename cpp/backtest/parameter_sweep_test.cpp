@@ -0,0 +1,146 @@
+#include "parameter_sweep.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace signalforge {
+
+namespace {
+
+struct QuoteParams {
+    Price offset;
+    Quantity size;
+};
+
+// Quotes `size` units `offset` ticks either side of the last trade
+// whenever the previous quote on that side has filled
+class QuotingStrategy : public Strategy {
+public:
+    explicit QuotingStrategy(const QuoteParams& p) : p_(p) {}
+
+    void on_trade(Price price, uint64_t) override {
+        if (!bid_open_) {
+            exec_->submit({Side::BID, OrderType::LIMIT, price - p_.offset, p_.size});
+            bid_open_ = true;
+        }
+        if (!ask_open_) {
+            exec_->submit({Side::ASK, OrderType::LIMIT, price + p_.offset, p_.size});
+            ask_open_ = true;
+        }
+    }
+
+    void on_fill(const Fill& fill) override {
+        (fill.side == Side::BID ? bid_open_ : ask_open_) = false;
+    }
+
+private:
+    QuoteParams p_;
+    bool bid_open_ = false;
+    bool ask_open_ = false;
+};
+
+std::unique_ptr<Strategy> make_quoting(const QuoteParams& p) {
+    return std::make_unique<QuotingStrategy>(p);
+}
+
+std::vector<Trade> random_walk(size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> step(-3, 3);
+    std::vector<Trade> trades;
+    Price price = 4250000;
+    for (size_t i = 0; i < n; ++i) {
+        price += step(rng);
+        trades.push_back({i, price, 1705276800000 + i * 100});
+    }
+    return trades;
+}
+
+std::vector<QuoteParams> grid() {
+    std::vector<QuoteParams> g;
+    for (Price offset = 1; offset <= 12; ++offset) {
+        for (Quantity size : {1, 3}) g.push_back({offset, size});
+    }
+    return g;
+}
+
+BacktestResults sequential(const std::vector<std::vector<Trade>>& days, const QuoteParams& p) {
+    QuotingStrategy strategy(p);
+    TradeOnlyMarketView market;
+    SweepExecution exec(market);
+    SweepEngine engine(strategy, exec, market);
+    for (const std::vector<Trade>& trades : days) engine.run(trades);
+    return engine.finish();
+}
+
+// Every field but the timing one
+void expect_same(const BacktestResults& a, const BacktestResults& b) {
+    EXPECT_EQ(a.total_pnl, b.total_pnl);
+    EXPECT_EQ(a.realized_pnl, b.realized_pnl);
+    EXPECT_EQ(a.unrealized_pnl, b.unrealized_pnl);
+    EXPECT_EQ(a.total_trades, b.total_trades);
+    EXPECT_EQ(a.winning_trades, b.winning_trades);
+    EXPECT_EQ(a.losing_trades, b.losing_trades);
+    EXPECT_EQ(a.win_rate, b.win_rate);
+    EXPECT_EQ(a.fills, b.fills);
+    EXPECT_EQ(a.max_drawdown, b.max_drawdown);
+    EXPECT_EQ(a.max_position, b.max_position);
+    EXPECT_EQ(a.start_timestamp, b.start_timestamp);
+    EXPECT_EQ(a.end_timestamp, b.end_timestamp);
+    EXPECT_EQ(a.events, b.events);
+}
+
+}  // namespace
+
+TEST(ParameterSweepTest, MatchesSequentialRunsOnAnyThreadCount) {
+    const std::vector<Trade> trades = random_walk(20000, 1);
+    const std::vector<QuoteParams> g = grid();
+
+    for (size_t threads : {1, 3, 8}) {
+        const auto table = run_parameter_sweep(trades, g, make_quoting, threads);
+        ASSERT_EQ(table.size(), g.size());
+        for (size_t i = 0; i < g.size(); ++i) {
+            SCOPED_TRACE(testing::Message() << threads << " threads, row " << i);
+            EXPECT_EQ(table[i].params.offset, g[i].offset);
+            EXPECT_EQ(table[i].params.size, g[i].size);
+            expect_same(table[i].results, sequential({trades}, g[i]));
+        }
+    }
+
+    // The runs differ, so the rows could not be matched up by accident
+    const auto table = run_parameter_sweep(trades, g, make_quoting, 2);
+    EXPECT_NE(table.front().results.fills, table.back().results.fills);
+    EXPECT_GT(table.back().results.fills, 0u);
+}
+
+TEST(ParameterSweepTest, ReplaysDaysInOrder) {
+    std::vector<DataManager::DayTrades> days;
+    std::vector<std::vector<Trade>> blocks;
+    for (uint64_t d = 0; d < 3; ++d) {
+        blocks.push_back(random_walk(5000, 10 + d));
+        days.push_back({"2024-01-1" + std::to_string(5 + d), blocks.back(), {5000, 5000, 1.0, false}});
+    }
+
+    const std::vector<QuoteParams> g = grid();
+    const auto table = run_parameter_sweep(days, g, make_quoting, 4);
+    ASSERT_EQ(table.size(), g.size());
+    for (size_t i = 0; i < g.size(); ++i) expect_same(table[i].results, sequential(blocks, g[i]));
+}
+
+TEST(ParameterSweepTest, EmptyGridAndErrors) {
+    const std::vector<Trade> trades = random_walk(100, 2);
+    EXPECT_TRUE(run_parameter_sweep(trades, std::vector<QuoteParams>{}, make_quoting).empty());
+
+    auto failing = [](const QuoteParams& p) -> std::unique_ptr<Strategy> {
+        if (p.offset >= 5) throw std::invalid_argument("offset " + std::to_string(p.offset));
+        return make_quoting(p);
+    };
+    try {
+        run_parameter_sweep(trades, grid(), failing, 4);
+        FAIL() << "expected an exception";
+    } catch (const std::invalid_argument& e) {
+        EXPECT_STREQ(e.what(), "offset 5");
+    }
+}
+
+}  // namespace signalforge
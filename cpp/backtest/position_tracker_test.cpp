@@ -80,4 +80,17 @@ TEST(PositionTrackerTest, AverageEntryPrice) {
     EXPECT_EQ(pt.position(), 2);
 }
 
+TEST(PositionTrackerTest, RealizedPnLAccumulates) {
+    PositionTracker pt;
+
+    // +$500 on a long, then -$200 on a short
+    pt.on_fill({1, Side::BID, 4250000, 1});
+    pt.on_fill({2, Side::ASK, 4300000, 1});
+    pt.on_fill({3, Side::ASK, 4300000, 1});
+    pt.on_fill({4, Side::BID, 4320000, 1});
+
+    EXPECT_EQ(pt.position(), 0);
+    EXPECT_DOUBLE_EQ(pt.realized_pnl(), 300.0);
+}
+
 }  // namespace signalforge
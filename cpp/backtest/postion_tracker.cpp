@@ -23,10 +23,10 @@ namespace signalforge {
 
             if (position_ > 0) {
                 //closing long: PnL = (exit - entry)  qty
-                realized_pnl_ = (exit_price_dollars - entry_price_dollars) * close_qty;
+                realized_pnl_ += (exit_price_dollars - entry_price_dollars) * close_qty;
             } else {
                 //closing short
-                realized_pnl_ = (entry_price_dollars - exit_price_dollars) * close_qty;
+                realized_pnl_ += (entry_price_dollars - exit_price_dollars) * close_qty;
             }
 
             position_ += fill_qty;
@@ -10,20 +10,27 @@ struct BacktestResults {
     double realized_pnl = 0.0;
     double unrealized_pnl = 0.0;
 
-    // Trade statistics
+    // Trade statistics. A trade is a fill that closes some position; it
+    // wins or loses by the PnL it realizes.
     size_t total_trades = 0;
     size_t winning_trades = 0;
     size_t losing_trades = 0;
     double win_rate = 0.0;  // Percentage
 
+    size_t fills = 0;
+
     // Performance
-    double max_drawdown = 0.0;
-    double max_position = 0.0;
+    double max_drawdown = 0.0;  // largest fall of marked-to-market PnL from its peak
+    double max_position = 0.0;  // largest absolute position
 
     // Time
     uint64_t start_timestamp = 0;
     uint64_t end_timestamp = 0;
 
+    // Engine throughput: market events plus fills, per second of run time
+    size_t events = 0;
+    double events_per_second = 0.0;
+
     void print() const {
         std::cout << "=== Backtest Results ===" << std::endl;
         std::cout << "Total PnL: $" << total_pnl << std::endl;
@@ -32,6 +39,8 @@ struct BacktestResults {
         std::cout << "Total Trades: " << total_trades << std::endl;
         std::cout << "Win Rate: " << win_rate << "%" << std::endl;
         std::cout << "Max Drawdown: $" << max_drawdown << std::endl;
+        std::cout << "Max Position: " << max_position << std::endl;
+        std::cout << "Events/s: " << events_per_second << std::endl;
     }
 };
 
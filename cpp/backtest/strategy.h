@@ -14,6 +14,8 @@ namespace signalforge
 
             virtual void on_fill(const Fill& fill) = 0; // Called on each fill
 
+            virtual void on_order_event(const OrderEvent&) {} // Called on each cancel/replace outcome
+
             virtual void finalize() {} // Called once at end of backtest
 
             void set_execution_model(ExecutionModel* exec) { exec_ = exec; }
@@ -0,0 +1,98 @@
+#include "work_stealing.h"
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace signalforge {
+
+namespace {
+
+// Indices [begin, end) still to run by one thread. Padded to a cache line
+// so owners taking from neighbouring ranges do not share one.
+struct alignas(64) WorkRange {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+}  // namespace
+
+void parallel_for(size_t count, size_t threads, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, count);
+
+    std::unique_ptr<WorkRange[]> ranges(new WorkRange[threads]);
+    for (size_t t = 0; t < threads; ++t) {
+        ranges[t].begin = count * t / threads;
+        ranges[t].end = count * (t + 1) / threads;
+    }
+
+    // Each slot is written by the one thread that ran its index
+    std::vector<std::exception_ptr> errors(count);
+    auto run = [&](size_t i) {
+        try {
+            task(i);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    auto work = [&](size_t self) {
+        WorkRange& own = ranges[self];
+        for (;;) {
+            size_t i;
+            {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                i = own.begin < own.end ? own.begin++ : count;
+            }
+            if (i < count) {
+                run(i);
+                continue;
+            }
+
+            // Own range is empty: take the back half of the first non-empty
+            // range after ours. Work is never created, only moved, so an
+            // empty sweep means every index is taken or owned by a thread
+            // that will run it.
+            bool stole = false;
+            for (size_t k = 1; k < threads && !stole; ++k) {
+                WorkRange& victim = ranges[(self + k) % threads];
+                size_t from, to;
+                {
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    if (victim.begin >= victim.end) continue;
+                    from = victim.begin + (victim.end - victim.begin) / 2;
+                    to = victim.end;
+                    victim.end = from;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    own.begin = from;
+                    own.end = to;
+                }
+                stole = true;
+            }
+            if (!stole) return;
+        }
+    };
+
+    if (threads <= 1) {
+        work(0);
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (size_t t = 1; t < threads; ++t) pool.emplace_back(work, t);
+        work(0);
+        for (std::thread& thread : pool) thread.join();
+    }
+
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+}  // namespace signalforge
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+namespace signalforge {
+
+// Calls task(i) for every i in [0, count) on up to `threads` threads
+// (0: one per hardware thread), the calling thread included.
+//
+// Each thread starts on its own contiguous share of the indices and takes
+// them front to back. A thread that runs out steals the back half of
+// another thread's remaining share, so uneven task costs (a slow parameter
+// set, a core shared with something else) do not leave threads idle while
+// one of them works through a long tail.
+//
+// Every index runs exactly once. If tasks throw, the exception of the
+// lowest failing index is rethrown once all threads are done, whatever
+// the thread timing.
+void parallel_for(size_t count, size_t threads, const std::function<void(size_t)>& task);
+
+}  // namespace signalforge
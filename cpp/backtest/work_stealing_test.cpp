@@ -0,0 +1,52 @@
+#include "work_stealing.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace signalforge {
+
+TEST(WorkStealingTest, RunsEveryIndexOnce) {
+    for (size_t count : {0, 1, 7, 1000}) {
+        for (size_t threads : {0, 1, 3, 16}) {
+            std::vector<std::atomic<int>> runs(count);
+            parallel_for(count, threads, [&](size_t i) { runs[i].fetch_add(1); });
+            for (size_t i = 0; i < count; ++i) ASSERT_EQ(runs[i].load(), 1) << count << " " << threads << " " << i;
+        }
+    }
+}
+
+TEST(WorkStealingTest, IdleThreadsStealFromASlowShare) {
+    // All the slow tasks sit in the first thread's share; the others must
+    // take them over for the set to finish on more than one thread
+    const size_t count = 64;
+    std::vector<std::thread::id> ran_on(count);
+    parallel_for(count, 4, [&](size_t i) {
+        if (i < count / 4) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        ran_on[i] = std::this_thread::get_id();
+    });
+
+    std::vector<std::thread::id> slow_share(ran_on.begin(), ran_on.begin() + count / 4);
+    size_t other_threads = 0;
+    for (const std::thread::id& id : slow_share) other_threads += id != slow_share.front();
+    EXPECT_GT(other_threads, 0u);
+}
+
+TEST(WorkStealingTest, RethrowsLowestFailingIndex) {
+    std::atomic<size_t> ran{0};
+    try {
+        parallel_for(100, 4, [&](size_t i) {
+            ran.fetch_add(1);
+            if (i == 30 || i == 70 || i == 99) throw std::runtime_error(std::to_string(i));
+        });
+        FAIL() << "expected an exception";
+    } catch (const std::runtime_error& e) {
+        EXPECT_STREQ(e.what(), "30");
+    }
+    EXPECT_EQ(ran.load(), 100u);
+}
+
+}  // namespace signalforge
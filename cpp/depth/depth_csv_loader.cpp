@@ -0,0 +1,118 @@
+#include "depth_csv_loader.h"
+#include <cstring>
+#include "cpp/io/fixed_point.h"
+#include "cpp/io/mapped_file.h"
+
+namespace signalforge {
+
+namespace {
+
+// Fields are parsed in place, so each parser stops at the next comma
+bool expect_comma(const char*& p, const char* end) {
+    if (p == end || *p != ',') return false;
+    ++p;
+    return true;
+}
+
+bool parse_flag(const char*& p, const char* end, bool& out) {
+    const char* comma = static_cast<const char*>(std::memchr(p, ',', static_cast<size_t>(end - p)));
+    if (comma == nullptr) return false;
+
+    const size_t len = static_cast<size_t>(comma - p);
+    if ((len == 4 && std::memcmp(p, "true", 4) == 0) || (len == 1 && *p == '1')) {
+        out = true;
+    } else if ((len == 5 && std::memcmp(p, "false", 5) == 0) || (len == 1 && *p == '0')) {
+        out = false;
+    } else {
+        return false;
+    }
+    p = comma;
+    return true;
+}
+
+bool parse_side(const char*& p, const char* end, Side& out) {
+    const char* comma = static_cast<const char*>(std::memchr(p, ',', static_cast<size_t>(end - p)));
+    if (comma == nullptr) return false;
+
+    const size_t len = static_cast<size_t>(comma - p);
+    if ((len == 1 && *p == 'b') || (len == 3 && std::memcmp(p, "bid", 3) == 0)) {
+        out = Side::BID;
+    } else if ((len == 1 && *p == 'a') || (len == 3 && std::memcmp(p, "ask", 3) == 0)) {
+        out = Side::ASK;
+    } else {
+        return false;
+    }
+    p = comma;
+    return true;
+}
+
+}  // namespace
+
+DepthLog DepthCsvLoader::load(const std::string& filepath) {
+    MappedFile file(filepath);
+    file.advise_sequential();
+
+    DepthLog log;
+    skipped_rows_ = 0;
+
+    const char* p = file.begin();
+    const char* const end = file.end();
+    bool first_line = true;
+
+    while (p < end) {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (eol == nullptr) eol = end;
+        const char* line_end = (eol > p && eol[-1] == '\r') ? eol - 1 : eol;
+        const char* row = p;
+        p = eol == end ? end : eol + 1;
+
+        // Skip header row if it exists
+        if (first_line) {
+            first_line = false;
+            const std::string line(row, line_end);
+            if (line.find("update_id") != std::string::npos) {
+                continue;
+            }
+        }
+
+        // Skip empty lines
+        if (row == line_end) {
+            continue;
+        }
+
+        uint64_t timestamp, first_id, last_id;
+        bool is_snapshot;
+        Side side;
+        int64_t price, qty;
+        const char* f = row;
+        const bool ok =
+            parse_uint(f, line_end, timestamp) && expect_comma(f, line_end) &&
+            parse_uint(f, line_end, first_id) && expect_comma(f, line_end) &&
+            parse_uint(f, line_end, last_id) && expect_comma(f, line_end) &&
+            parse_flag(f, line_end, is_snapshot) && expect_comma(f, line_end) &&
+            parse_side(f, line_end, side) && expect_comma(f, line_end) &&
+            parse_fixed(f, line_end, kPriceDecimals, price) && expect_comma(f, line_end) &&
+            parse_fixed(f, line_end, kQtyDecimals, qty) && f == line_end &&
+            first_id <= last_id && price > 0 && qty >= 0;
+        if (!ok) {
+            skipped_rows_++;
+            continue;
+        }
+
+        const bool same_event = !log.events.empty() &&
+            log.events.back().is_snapshot == is_snapshot &&
+            log.events.back().first_update_id == first_id &&
+            log.events.back().last_update_id == last_id;
+        if (!same_event) {
+            const size_t at = log.deltas.size();
+            log.events.push_back({timestamp, first_id, last_id, is_snapshot, at, at});
+        }
+
+        log.deltas.push_back({side, price, qty});
+        log.events.back().end = log.deltas.size();
+    }
+
+    return log;
+}
+
+}  // namespace signalforge
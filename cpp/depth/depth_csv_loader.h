@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "cpp/orderbook/order_book.h"
+
+namespace signalforge {
+
+// One depth message: either a full REST snapshot or one diff-depth update
+// from the <symbol>@depth stream. Its levels are deltas[begin, end) of the
+// owning DepthLog.
+struct DepthEvent {
+    uint64_t timestamp;        // Event time, Unix milliseconds
+    uint64_t first_update_id;  // U (snapshot: lastUpdateId)
+    uint64_t last_update_id;   // u (snapshot: lastUpdateId)
+    bool is_snapshot;
+    size_t begin;
+    size_t end;
+};
+
+// A whole recorded depth file. Levels of all events share one flat vector
+// so replay walks contiguous memory.
+struct DepthLog {
+    std::vector<DepthEvent> events;
+    std::vector<Delta> deltas;
+};
+
+class DepthCsvLoader {
+public:
+    // Load a recorded Binance depth file, one price level per row:
+    //   event_time,first_update_id,last_update_id,is_snapshot,side,price,qty
+    // side is b/bid or a/ask, is_snapshot is true/false or 1/0. Consecutive
+    // rows with the same is_snapshot and update ids form one event. Prices
+    // are kept in ticks (price * 100), quantities with 8 decimals.
+    // Throws std::runtime_error if file cannot be opened
+    // Silently skips malformed rows
+    DepthLog load(const std::string& filepath);
+
+    // Get the number of rows that were skipped during the last load
+    size_t skipped_rows() const { return skipped_rows_; }
+
+private:
+    size_t skipped_rows_ = 0;
+};
+
+}  // namespace signalforge
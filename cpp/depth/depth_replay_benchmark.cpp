@@ -0,0 +1,99 @@
+// Load and replay throughput for recorded depth files.
+//
+// Run: bazel run -c opt //cpp/depth:depth_replay_benchmark
+
+#include "depth_csv_loader.h"
+#include "depth_replayer.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace signalforge {
+namespace {
+
+constexpr int kDepth = 1000;
+constexpr size_t kEvents = 100000;
+constexpr int kLevelsPerEvent = 10;
+constexpr int kMid = 4250000;
+
+// A snapshot of kDepth levels per side followed by in-sequence updates that
+// mostly land near the top of the book, like the live diff-depth stream.
+const std::string& depth_file() {
+    static const std::string path = [] {
+        const std::string p = (std::filesystem::temp_directory_path() / "depth_replay_benchmark.csv").string();
+        std::ofstream out(p);
+        out << "event_time,first_update_id,last_update_id,is_snapshot,side,price,qty\n";
+
+        uint64_t id = 1000;
+        uint64_t ts = 1700000000000;
+        char row[128];
+        for (int i = 1; i <= kDepth; ++i) {
+            std::snprintf(row, sizeof(row), "%llu,%llu,%llu,true,b,%d.%02d,1.5\n",
+                          static_cast<unsigned long long>(ts), static_cast<unsigned long long>(id),
+                          static_cast<unsigned long long>(id), (kMid - i) / 100, (kMid - i) % 100);
+            out << row;
+            std::snprintf(row, sizeof(row), "%llu,%llu,%llu,true,a,%d.%02d,1.5\n",
+                          static_cast<unsigned long long>(ts), static_cast<unsigned long long>(id),
+                          static_cast<unsigned long long>(id), (kMid + i) / 100, (kMid + i) % 100);
+            out << row;
+        }
+
+        std::mt19937_64 rng(7);
+        std::geometric_distribution<int> distance(4.0 / kDepth);
+        std::uniform_int_distribution<int> qty(0, 500000000);
+        for (size_t e = 0; e < kEvents; ++e) {
+            ts += 100;
+            const uint64_t first = id + 1;
+            id += 1 + rng() % 4;
+            for (int l = 0; l < kLevelsPerEvent; ++l) {
+                const bool bid = (l & 1) == 0;
+                const int d = 1 + distance(rng) % kDepth;
+                const int price = bid ? kMid - d : kMid + d;
+                const int q = qty(rng) < 100000000 ? 0 : qty(rng);
+                std::snprintf(row, sizeof(row), "%llu,%llu,%llu,false,%s,%d.%02d,%d.%08d\n",
+                              static_cast<unsigned long long>(ts), static_cast<unsigned long long>(first),
+                              static_cast<unsigned long long>(id), bid ? "b" : "a",
+                              price / 100, price % 100, q / 100000000, q % 100000000);
+                out << row;
+            }
+        }
+        return p;
+    }();
+    return path;
+}
+
+void BM_LoadDepthCsv(benchmark::State& state) {
+    const std::string& path = depth_file();
+    DepthCsvLoader loader;
+    size_t levels = 0;
+    for (auto _ : state) {
+        DepthLog log = loader.load(path);
+        levels = log.deltas.size();
+        benchmark::DoNotOptimize(log.events.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * levels));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(path)));
+}
+BENCHMARK(BM_LoadDepthCsv)->Unit(benchmark::kMillisecond);
+
+template <typename Book>
+void BM_ReplayDepth(benchmark::State& state) {
+    DepthCsvLoader loader;
+    const DepthLog log = loader.load(depth_file());
+    for (auto _ : state) {
+        Book book;
+        DepthReplayer<Book> replayer(book);
+        replayer.replay(log);
+        benchmark::DoNotOptimize(book.best_bid());
+    }
+    // Level updates per second
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * log.deltas.size()));
+}
+BENCHMARK_TEMPLATE(BM_ReplayDepth, OrderBook)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ReplayDepth, FlatOrderBook)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace signalforge
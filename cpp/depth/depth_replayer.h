@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "depth_csv_loader.h"
+#include "cpp/orderbook/flat_order_book.h"
+#include "cpp/orderbook/order_book.h"
+
+namespace signalforge {
+
+// Drives a book from recorded depth events, following Binance's rules for
+// keeping a local book in sync with the diff-depth stream:
+//   - a snapshot (lastUpdateId L) replaces the book
+//   - updates with u <= L are stale and dropped
+//   - the first update applied after a snapshot must have U <= L+1 <= u
+//   - every later update must have U == previous u + 1
+// A missing update id is a gap: the book is cleared and updates are dropped
+// until the next snapshot resyncs it.
+//
+// Book is OrderBook or FlatOrderBook. Each event goes through the book's
+// batch entry points, so derived state is updated once per event.
+template <typename Book>
+class DepthReplayer {
+public:
+    enum class State {
+        AWAITING_SNAPSHOT,  // no snapshot yet, or lost sync after a gap
+        SYNCING,            // snapshot applied, waiting for the bridging update
+        LIVE                // in sequence
+    };
+
+    struct Stats {
+        size_t snapshots = 0;       // snapshot events applied
+        size_t updates = 0;         // update events applied
+        size_t dropped = 0;         // update events skipped (stale, out of sync)
+        size_t gaps = 0;            // sequence breaks that forced a resync
+        size_t levels_applied = 0;  // level changes written to the book
+    };
+
+    explicit DepthReplayer(Book& book) : book_(book) {}
+
+    // Apply one event whose levels are deltas[event.begin, event.end).
+    // Returns true if the book changed.
+    bool apply(const DepthEvent& event, const Delta* deltas) {
+        const Delta* first = deltas + event.begin;
+        const size_t count = event.end - event.begin;
+
+        if (event.is_snapshot) {
+            apply_snapshot(first, count);
+            last_update_id_ = event.last_update_id;
+            state_ = State::SYNCING;
+            ++stats_.snapshots;
+            return true;
+        }
+
+        switch (state_) {
+            case State::AWAITING_SNAPSHOT:
+                ++stats_.dropped;
+                return false;
+            case State::SYNCING:
+                if (event.last_update_id <= last_update_id_) {
+                    ++stats_.dropped;
+                    return false;
+                }
+                if (event.first_update_id > last_update_id_ + 1) {
+                    on_gap();
+                    return false;
+                }
+                state_ = State::LIVE;
+                break;
+            case State::LIVE:
+                if (event.first_update_id != last_update_id_ + 1) {
+                    if (event.last_update_id <= last_update_id_) {
+                        ++stats_.dropped;  // duplicate delivery
+                    } else {
+                        on_gap();
+                    }
+                    return false;
+                }
+                break;
+        }
+
+        book_.apply_deltas(first, count);
+        last_update_id_ = event.last_update_id;
+        ++stats_.updates;
+        stats_.levels_applied += count;
+        return true;
+    }
+
+    // Apply every event of a loaded log in order
+    void replay(const DepthLog& log) {
+        const Delta* deltas = log.deltas.data();
+        for (const DepthEvent& event : log.events) {
+            apply(event, deltas);
+        }
+    }
+
+    State state() const { return state_; }
+    bool in_sync() const { return state_ == State::LIVE; }
+    // u of the last applied event, or L of the last snapshot
+    uint64_t last_update_id() const { return last_update_id_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    void apply_snapshot(const Delta* first, size_t count) {
+        // Reused across snapshots so a warm replayer does not allocate
+        bids_.clear();
+        asks_.clear();
+        for (const Delta* d = first; d != first + count; ++d) {
+            (d->side == Side::BID ? bids_ : asks_).push_back({d->price, d->qty});
+        }
+        book_.apply_snapshot(bids_, asks_);
+        stats_.levels_applied += count;
+    }
+
+    void on_gap() {
+        book_.clear();
+        state_ = State::AWAITING_SNAPSHOT;
+        ++stats_.gaps;
+        ++stats_.dropped;
+    }
+
+    Book& book_;
+    State state_ = State::AWAITING_SNAPSHOT;
+    uint64_t last_update_id_ = 0;
+    Stats stats_;
+
+    std::vector<Level> bids_;
+    std::vector<Level> asks_;
+};
+
+using OrderBookDepthReplayer = DepthReplayer<OrderBook>;
+using FlatOrderBookDepthReplayer = DepthReplayer<FlatOrderBook>;
+
+}  // namespace signalforge
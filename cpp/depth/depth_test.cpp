@@ -0,0 +1,219 @@
+#include "depth_csv_loader.h"
+#include "depth_replayer.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+namespace signalforge {
+
+class DepthTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "depth_test";
+        std::filesystem::create_directories(test_dir_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    std::string create_test_file(const std::string& filename, const std::string& content) {
+        std::filesystem::path filepath = test_dir_ / filename;
+        std::ofstream file(filepath);
+        file << content;
+        file.close();
+        return filepath.string();
+    }
+
+    DepthLog load(const std::string& content) {
+        return loader.load(create_test_file("depth.csv", content));
+    }
+
+    std::filesystem::path test_dir_;
+    DepthCsvLoader loader;
+};
+
+const char* kHeader = "event_time,first_update_id,last_update_id,is_snapshot,side,price,qty\n";
+
+// Snapshot at 100, then updates 98-101 (bridging), 102-102, 103-104
+const char* kInSequence =
+    "1700000000000,100,100,true,b,42500.00,1.5\n"
+    "1700000000000,100,100,true,b,42499.00,2.0\n"
+    "1700000000000,100,100,true,a,42501.00,0.75\n"
+    "1700000000000,100,100,true,a,42502.50,3.0\n"
+    "1700000000100,98,101,false,b,42500.00,1.25\n"
+    "1700000000100,98,101,false,a,42501.00,0\n"
+    "1700000000200,102,102,false,b,42500.50,0.1\n"
+    "1700000000300,103,104,false,a,42501.50,0.00000001\n";
+
+TEST_F(DepthTest, LoadGroupsRowsIntoEvents) {
+    DepthLog log = load(std::string(kHeader) + kInSequence);
+
+    EXPECT_EQ(loader.skipped_rows(), 0);
+    ASSERT_EQ(log.events.size(), 4);
+    ASSERT_EQ(log.deltas.size(), 8);
+
+    EXPECT_TRUE(log.events[0].is_snapshot);
+    EXPECT_EQ(log.events[0].begin, 0);
+    EXPECT_EQ(log.events[0].end, 4);
+
+    EXPECT_FALSE(log.events[1].is_snapshot);
+    EXPECT_EQ(log.events[1].timestamp, 1700000000100);
+    EXPECT_EQ(log.events[1].first_update_id, 98);
+    EXPECT_EQ(log.events[1].last_update_id, 101);
+    EXPECT_EQ(log.events[1].begin, 4);
+    EXPECT_EQ(log.events[1].end, 6);
+
+    EXPECT_EQ(log.events[3].begin, 7);
+    EXPECT_EQ(log.events[3].end, 8);
+}
+
+TEST_F(DepthTest, LoadConvertsToFixedPoint) {
+    DepthLog log = load(std::string(kHeader) + kInSequence);
+
+    EXPECT_EQ(log.deltas[0].side, Side::BID);
+    EXPECT_EQ(log.deltas[0].price, 4250000);
+    EXPECT_EQ(log.deltas[0].qty, 150000000);
+    EXPECT_EQ(log.deltas[3].side, Side::ASK);
+    EXPECT_EQ(log.deltas[3].price, 4250250);
+    EXPECT_EQ(log.deltas[5].qty, 0);
+    EXPECT_EQ(log.deltas[7].qty, 1);
+}
+
+TEST_F(DepthTest, LoadWithoutHeaderAndCrlf) {
+    DepthLog log = load(
+        "1700000000000,7,7,1,bid,100.00,1\r\n"
+        "\r\n"
+        "1700000000001,8,8,0,ask,101.00,2\r\n");
+
+    EXPECT_EQ(loader.skipped_rows(), 0);
+    ASSERT_EQ(log.events.size(), 2);
+    EXPECT_TRUE(log.events[0].is_snapshot);
+    EXPECT_EQ(log.deltas[1].side, Side::ASK);
+    EXPECT_EQ(log.deltas[1].qty, 200000000);
+}
+
+TEST_F(DepthTest, LoadSkipsMalformedRows) {
+    DepthLog log = load(std::string(kHeader) +
+        "1700000000000,100,100,true,b,42500.00,1.5\n"
+        "1700000000000,100,100,true,x,42499.00,2.0\n"      // bad side
+        "1700000000000,100,100,maybe,a,42501.00,1\n"       // bad flag
+        "1700000000100,101,101,false,b,abc,1\n"            // bad price
+        "1700000000100,101,101,false,b,42500.00\n"         // missing qty
+        "1700000000100,102,101,false,b,42500.00,1\n"       // U > u
+        "1700000000100,101,101,false,b,42500.00,-1\n"      // negative qty
+        "1700000000100,101,101,false,b,42500.00,1,extra\n"
+        "1700000000200,101,101,false,a,42501.00,1\n");
+
+    EXPECT_EQ(loader.skipped_rows(), 7);
+    ASSERT_EQ(log.events.size(), 2);
+    EXPECT_EQ(log.deltas.size(), 2);
+}
+
+TEST_F(DepthTest, LoadEmptyFile) {
+    DepthLog log = load("");
+    EXPECT_TRUE(log.events.empty());
+    EXPECT_EQ(loader.skipped_rows(), 0);
+}
+
+TEST_F(DepthTest, LoadMissingFileThrows) {
+    EXPECT_THROW(loader.load((test_dir_ / "missing.csv").string()), std::runtime_error);
+}
+
+template <typename Book>
+class DepthReplayTest : public DepthTest {
+protected:
+    Book book;
+    DepthReplayer<Book> replayer{book};
+};
+
+using BookTypes = ::testing::Types<OrderBook, FlatOrderBook>;
+TYPED_TEST_SUITE(DepthReplayTest, BookTypes);
+
+TYPED_TEST(DepthReplayTest, ReplaysInSequence) {
+    this->replayer.replay(this->load(kInSequence));
+
+    EXPECT_TRUE(this->replayer.in_sync());
+    EXPECT_EQ(this->replayer.last_update_id(), 104);
+    EXPECT_EQ(this->replayer.stats().snapshots, 1);
+    EXPECT_EQ(this->replayer.stats().updates, 3);
+    EXPECT_EQ(this->replayer.stats().dropped, 0);
+    EXPECT_EQ(this->replayer.stats().gaps, 0);
+    EXPECT_EQ(this->replayer.stats().levels_applied, 8);
+
+    EXPECT_EQ(this->book.best_bid(), 4250050);
+    EXPECT_EQ(this->book.best_ask(), 4250150);
+    EXPECT_EQ(this->book.level_qty(Side::BID, 4250000), 125000000);
+    EXPECT_EQ(this->book.level_qty(Side::ASK, 4250100), 0);
+}
+
+TYPED_TEST(DepthReplayTest, DropsUpdatesBeforeSnapshotAndStale) {
+    this->replayer.replay(this->load(
+        "1,90,95,false,b,10.00,1\n"     // before any snapshot
+        "2,100,100,true,b,10.00,1\n"
+        "2,100,100,true,a,11.00,1\n"
+        "3,96,99,false,b,10.00,5\n"     // already in the snapshot
+        "4,99,100,false,b,10.00,6\n"    // u == L, still stale
+        "5,100,102,false,b,10.00,7\n"));
+
+    EXPECT_TRUE(this->replayer.in_sync());
+    EXPECT_EQ(this->replayer.stats().dropped, 3);
+    EXPECT_EQ(this->replayer.stats().updates, 1);
+    EXPECT_EQ(this->book.level_qty(Side::BID, 1000), 700000000);
+}
+
+TYPED_TEST(DepthReplayTest, GapClearsBookUntilNextSnapshot) {
+    this->replayer.replay(this->load(
+        "1,100,100,true,b,10.00,1\n"
+        "1,100,100,true,a,11.00,1\n"
+        "2,101,101,false,b,10.50,1\n"
+        "3,103,103,false,b,10.60,1\n"   // 102 is missing
+        "4,104,104,false,b,10.70,1\n"));
+
+    EXPECT_EQ(this->replayer.state(), DepthReplayer<TypeParam>::State::AWAITING_SNAPSHOT);
+    EXPECT_EQ(this->replayer.stats().gaps, 1);
+    EXPECT_EQ(this->replayer.stats().dropped, 2);
+    EXPECT_EQ(this->book.best_bid(), 0);
+    EXPECT_EQ(this->book.best_ask(), 0);
+
+    // Resync from a fresh snapshot
+    this->replayer.replay(this->load(
+        "5,200,200,true,b,20.00,1\n"
+        "5,200,200,true,a,21.00,1\n"
+        "6,199,201,false,a,20.90,2\n"));
+
+    EXPECT_TRUE(this->replayer.in_sync());
+    EXPECT_EQ(this->replayer.last_update_id(), 201);
+    EXPECT_EQ(this->book.best_bid(), 2000);
+    EXPECT_EQ(this->book.best_ask(), 2090);
+}
+
+TYPED_TEST(DepthReplayTest, FirstUpdateMustBridgeSnapshot) {
+    this->replayer.replay(this->load(
+        "1,100,100,true,b,10.00,1\n"
+        "1,100,100,true,a,11.00,1\n"
+        "2,102,105,false,b,10.50,1\n"));   // skips 101
+
+    EXPECT_EQ(this->replayer.stats().gaps, 1);
+    EXPECT_FALSE(this->replayer.in_sync());
+    EXPECT_EQ(this->book.best_bid(), 0);
+}
+
+TYPED_TEST(DepthReplayTest, DuplicateUpdateIsDroppedWithoutGap) {
+    this->replayer.replay(this->load(
+        "1,100,100,true,b,10.00,1\n"
+        "1,100,100,true,a,11.00,1\n"
+        "2,101,101,false,b,10.50,1\n"
+        "3,102,102,false,b,10.60,1\n"
+        "4,103,103,false,b,10.70,1\n"
+        "5,102,102,false,b,10.60,9\n"   // redelivered
+        "6,104,104,false,b,10.80,1\n"));
+
+    EXPECT_TRUE(this->replayer.in_sync());
+    EXPECT_EQ(this->replayer.stats().gaps, 0);
+    EXPECT_EQ(this->replayer.stats().dropped, 1);
+    EXPECT_EQ(this->book.level_qty(Side::BID, 1060), 100000000);
+    EXPECT_EQ(this->book.best_bid(), 1080);
+}
+
+}  // namespace signalforge
@@ -0,0 +1,117 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cpp/orderbook/order_book.h"
+
+namespace signalforge {
+
+// Temporary depletion of liquidity our own orders have taken. The recorded
+// book does not see our trades, so without it a strategy could take the
+// same level again on the next tick. Depleted quantity recovers linearly,
+// back to the full recorded level after `recovery`: a duration in
+// timestamp units (ms, as ExecutionModel::advance_time), or a number of
+// on_tick calls when the model is never given the time.
+struct DepletionConfig {
+    bool enabled = false;
+    uint64_t recovery = 0;
+};
+
+// Fills taker orders against one side of a live book, best level first,
+// each level at its own price.
+//
+// Levels are copied out of the book (top_levels) into a buffer that
+// doubles when a sweep goes deeper than it, and depletion is kept in a
+// small vector of recently taken levels, so a warm sweeper does not
+// allocate.
+class DepthSweeper {
+public:
+    explicit DepthSweeper(DepletionConfig depletion = {}) : depletion_(depletion) {}
+
+    // Moves the clock to `now` (timestamp or tick count) and drops fully
+    // recovered levels
+    void advance(uint64_t now) {
+        now_ = now;
+        size_t kept = 0;
+        for (size_t i = 0; i < depleted_.size(); ++i) {
+            if (remaining(depleted_[i]) > 0) depleted_[kept++] = depleted_[i];
+        }
+        depleted_.resize(kept);
+    }
+
+    // Takes up to qty for a taker on taker_side from the opposite side of
+    // book, no deeper than limit when has_limit. Calls on_fill(price, qty)
+    // per level taken from and returns the quantity left unfilled.
+    template <typename Book, typename OnFill>
+    Quantity sweep(const Book& book, Side taker_side, Quantity qty, bool has_limit, Price limit, OnFill on_fill) {
+        const Side book_side = taker_side == Side::BID ? Side::ASK : Side::BID;
+        size_t want = kFirstLevels;
+        size_t done = 0;
+        for (;;) {
+            levels_.resize(want);
+            const size_t count = book.top_levels(book_side, levels_.data(), want);
+            for (; done < count && qty > 0; ++done) {
+                const Level& level = levels_[done];
+                if (has_limit && !reachable(taker_side, limit, level.price)) return qty;
+
+                const Quantity available = level.qty - depleted(book_side, level.price);
+                if (available <= 0) continue;
+                const Quantity take = std::min(available, qty);
+                on_fill(level.price, take);
+                qty -= take;
+                if (depletion_.enabled) deplete(book_side, level.price, take);
+            }
+            if (qty == 0 || count < want) return qty;  // filled, or the side ran dry
+            want *= 2;
+        }
+    }
+
+private:
+    static constexpr size_t kFirstLevels = 16;
+
+    struct Depleted {
+        Side side;
+        Price price;
+        Quantity qty;    // taken at `since`
+        uint64_t since;  // clock at the last take
+    };
+
+    static bool reachable(Side taker_side, Price limit, Price price) {
+        return taker_side == Side::BID ? SideTraits<Side::BID>::crossed_by(limit, price)
+                                       : SideTraits<Side::ASK>::crossed_by(limit, price);
+    }
+
+    // Depleted quantity still missing from a level now
+    Quantity remaining(const Depleted& d) const {
+        const uint64_t elapsed = now_ - d.since;
+        if (elapsed >= depletion_.recovery) return 0;
+        const double left = static_cast<double>(depletion_.recovery - elapsed) /
+                            static_cast<double>(depletion_.recovery);
+        return static_cast<Quantity>(static_cast<double>(d.qty) * left);
+    }
+
+    Quantity depleted(Side side, Price price) const {
+        for (const Depleted& d : depleted_) {
+            if (d.side == side && d.price == price) return remaining(d);
+        }
+        return 0;
+    }
+
+    void deplete(Side side, Price price, Quantity qty) {
+        for (Depleted& d : depleted_) {
+            if (d.side == side && d.price == price) {
+                d = {side, price, remaining(d) + qty, now_};
+                return;
+            }
+        }
+        depleted_.push_back({side, price, qty, now_});
+    }
+
+    DepletionConfig depletion_;
+    uint64_t now_ = 0;
+    std::vector<Level> levels_;
+    std::vector<Depleted> depleted_;
+};
+
+}  // namespace signalforge
@@ -0,0 +1,296 @@
+// Execution model throughput: market orders through the virtual and
+// devirtualized market views, market orders sweeping book depth, and ticks against 10 to 100k resting limits
+// (a grid strategy) and re-quoting among them with replace and cancel, vs
+// the original scan over every open order; and the queue-position model
+// over a depth plus trades replay, against the book replay alone.
+//
+// Run: bazel run -c opt //cpp/execution:execution_benchmark
+
+#include "trade_through_execution.h"
+#include "queue_execution.h"
+#include "reference_trade_through_execution.h"
+#include "cpp/market/order_book_market_view.h"
+#include "cpp/market/trade_only_market_view.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace signalforge {
+namespace {
+
+std::vector<Price> make_prices(size_t count) {
+    std::mt19937_64 rng(11);
+    std::uniform_int_distribution<int> step(-3, 3);
+
+    std::vector<Price> prices;
+    prices.reserve(count);
+    Price p = 4250000;
+    for (size_t i = 0; i < count; ++i) {
+        p += step(rng);
+        prices.push_back(p);
+    }
+    return prices;
+}
+
+// Trade-by-trade replay with a market order every eighth tick, through the
+// virtual MarketView interface vs the concrete final view
+template <typename Exec, typename View>
+void run_replay(benchmark::State& state, View& view, Exec& exec) {
+    const auto prices = make_prices(1 << 16);
+
+    size_t i = 0;
+    Fill fill;
+    for (auto _ : state) {
+        view.on_trade(prices[i]);
+        if ((i & 7) == 0) exec.submit({Side::BID, OrderType::MARKET, 0, 1});
+        exec.on_tick();
+        while (exec.poll_fill(fill)) benchmark::DoNotOptimize(fill);
+        i = (i + 1) & (prices.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_TradeOnlyView(benchmark::State& state) {
+    TradeOnlyMarketView view;
+    TradeThroughExecution exec(view);
+    run_replay(state, view, exec);
+}
+
+void BM_BookViewVirtual(benchmark::State& state) {
+    FlatOrderBook book;
+    book.set_level(Side::BID, 4249999, 10);
+    book.set_level(Side::ASK, 4250001, 10);
+    FlatOrderBookMarketView view(book);
+    TradeThroughExecution exec(view);
+    run_replay(state, view, exec);
+}
+
+void BM_BookViewDevirtualized(benchmark::State& state) {
+    FlatOrderBook book;
+    book.set_level(Side::BID, 4249999, 10);
+    book.set_level(Side::ASK, 4250001, 10);
+    FlatOrderBookMarketView view(book);
+    BasicTradeThroughExecution<FlatOrderBookMarketView> exec(view);
+    run_replay(state, view, exec);
+}
+
+// A market order every tick sweeping range(0) levels of a 64-level ask
+// side, one fill per level; range(1) turns on depletion, so later sweeps
+// skip what is still recovering and reach further down.
+void BM_MarketSweep(benchmark::State& state) {
+    const Quantity levels = state.range(0);
+    FlatOrderBook book;
+    book.set_level(Side::BID, 4249999, 10);
+    for (Price p = 0; p < 64; ++p) book.set_level(Side::ASK, 4250001 + p, 5);
+    FlatOrderBookMarketView view(book);
+    view.on_trade(4250000);
+    BasicTradeThroughExecution<FlatOrderBookMarketView> exec(view, {state.range(1) != 0, 2});
+
+    size_t fills = 0;
+    Fill fill;
+    for (auto _ : state) {
+        exec.submit({Side::BID, OrderType::MARKET, 0, levels * 5});
+        exec.on_tick();
+        while (exec.poll_fill(fill)) {
+            benchmark::DoNotOptimize(fill);
+            ++fills;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["fills/order"] = static_cast<double>(fills) / static_cast<double>(state.iterations());
+}
+
+// A grid of one-unit limits, one per tick on both sides of the price.
+// Each fill is replaced one tick through it on the other side, so the grid
+// keeps range(0) orders open while the price walks through it.
+template <typename Exec>
+void BM_RestingOrders(benchmark::State& state) {
+    const auto prices = make_prices(1 << 16);
+    const Price levels = static_cast<Price>(state.range(0) / 2);
+
+    TradeOnlyMarketView view;
+    Exec exec(view);
+    for (Price k = 1; k <= levels; ++k) {
+        exec.submit({Side::BID, OrderType::LIMIT, prices[0] - k, 1});
+        exec.submit({Side::ASK, OrderType::LIMIT, prices[0] + k, 1});
+    }
+
+    size_t i = 0;
+    size_t fills = 0;
+    Fill fill;
+    for (auto _ : state) {
+        view.on_trade(prices[i]);
+        exec.on_tick();
+        while (exec.poll_fill(fill)) {
+            const bool bought = fill.side == Side::BID;
+            exec.submit({bought ? Side::ASK : Side::BID, OrderType::LIMIT, fill.price + (bought ? 1 : -1), 1});
+            ++fills;
+        }
+        i = (i + 1) & (prices.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["fills/tick"] = static_cast<double>(fills) / static_cast<double>(state.iterations());
+    state.counters["open"] = static_cast<double>(exec.open_orders());
+}
+
+// range(0) quotes on both sides around a still price; each iteration moves
+// one quote to a new price, and cancels and resubmits another
+template <typename Exec>
+void BM_Requote(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::mt19937_64 rng(7);
+    const Price mid = 4250000;
+
+    TradeOnlyMarketView view;
+    view.on_trade(mid);
+    Exec exec(view);
+    std::vector<OrderId> ids;
+    for (size_t k = 0; k < count; ++k) {
+        const Price away = 1 + static_cast<Price>(k / 2);
+        ids.push_back(exec.submit({k % 2 ? Side::ASK : Side::BID, OrderType::LIMIT,
+                                   k % 2 ? mid + away : mid - away, 1}));
+    }
+
+    OrderEvent event;
+    for (auto _ : state) {
+        const size_t k = rng() % count;
+        const Price away = 1 + static_cast<Price>(rng() % (count / 2 + 1));
+        exec.replace(ids[k], k % 2 ? mid + away : mid - away, 1);
+
+        const size_t j = rng() % count;
+        exec.cancel(ids[j]);
+        const Price away2 = 1 + static_cast<Price>(rng() % (count / 2 + 1));
+        ids[j] = exec.submit({j % 2 ? Side::ASK : Side::BID, OrderType::LIMIT, j % 2 ? mid + away2 : mid - away2, 1});
+
+        exec.on_tick();
+        while (exec.poll_event(event)) benchmark::DoNotOptimize(event);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Recorded-style L2 stream: level updates near the top of a 1000-level
+// book, with one trade in five. A trade takes volume from one side's best
+// level and is followed by the depth update that removes it.
+struct L2Event {
+    bool is_trade;
+    bool buyer_maker;
+    Side side;
+    Price price;
+    Quantity qty;
+};
+
+const std::vector<L2Event>& l2_stream() {
+    static const std::vector<L2Event> events = [] {
+        std::mt19937_64 rng(29);
+        const Price mid = 4250000;
+        FlatOrderBook book;
+        for (Price k = 1; k <= 1000; ++k) {
+            book.set_level(Side::BID, mid - k, 100);
+            book.set_level(Side::ASK, mid + k, 100);
+        }
+
+        std::vector<L2Event> out;
+        while (out.size() < (1 << 20)) {
+            const Side side = rng() & 1 ? Side::BID : Side::ASK;
+            const Price best = side == Side::BID ? book.best_bid() : book.best_ask();
+            if (rng() % 5 == 0) {
+                const Quantity level = book.level_qty(side, best);
+                const Quantity qty = std::min<Quantity>(level, 1 + rng() % 40);
+                out.push_back({true, side == Side::BID, side, best, qty});
+                out.push_back({false, false, side, best, level - qty});
+                book.set_level(side, best, level - qty);
+            } else {
+                // Within a few ticks of the touch, never crossing it
+                const Price away = static_cast<Price>(rng() % 6);
+                const Price other = side == Side::BID ? book.best_ask() : book.best_bid();
+                Price price = side == Side::BID ? best + 1 - away : best - 1 + away;
+                if (side == Side::BID ? price >= other : price <= other) price = best;
+                const Quantity qty = static_cast<Quantity>(rng() % 150);
+                out.push_back({false, false, side, price, qty});
+                book.set_level(side, price, qty);
+            }
+            if (book.best_bid() == 0 || book.best_ask() == 0) {
+                book.set_level(Side::BID, mid - 1, 100);
+                book.set_level(Side::ASK, mid + 1, 100);
+                out.push_back({false, false, Side::BID, mid - 1, 100});
+                out.push_back({false, false, Side::ASK, mid + 1, 100});
+            }
+        }
+        return out;
+    }();
+    return events;
+}
+
+// A market maker keeping one unit at each side's touch: requoted when
+// filled, and repriced when the touch has moved away from it
+void BM_QueueReplay(benchmark::State& state) {
+    const auto& events = l2_stream();
+    size_t fills = 0;
+    for (auto _ : state) {
+        FlatOrderBook book;
+        FlatQueueExecution exec(book);
+        OrderId quote[2] = {0, 0};
+        Price quoted[2] = {0, 0};
+        Fill fill;
+        OrderEvent event;
+        fills = 0;
+
+        for (const L2Event& e : events) {
+            if (e.is_trade) {
+                exec.on_trade(e.price, e.qty, e.buyer_maker);
+            } else {
+                book.set_level(e.side, e.price, e.qty);
+                exec.on_tick();
+            }
+            while (exec.poll_fill(fill)) {
+                Quantity left;
+                if (!exec.queue_ahead(fill.order_id, left)) quote[fill.side == Side::BID ? 0 : 1] = 0;
+                ++fills;
+            }
+            while (exec.poll_event(event)) {}
+
+            for (int s = 0; s < 2; ++s) {
+                const Side side = s == 0 ? Side::BID : Side::ASK;
+                const Price touch = s == 0 ? book.best_bid() : book.best_ask();
+                if (touch == 0) continue;
+                if (quote[s] == 0) {
+                    quote[s] = exec.submit({side, OrderType::LIMIT, touch, 1});
+                    quoted[s] = touch;
+                } else if (touch != quoted[s]) {
+                    exec.replace(quote[s], touch, 1);
+                    quoted[s] = touch;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(fills);
+    }
+    state.SetItemsProcessed(state.iterations() * events.size());
+    state.counters["fills"] = static_cast<double>(fills);
+}
+
+// The same stream applied to the book with no execution model
+void BM_BookOnlyReplay(benchmark::State& state) {
+    const auto& events = l2_stream();
+    for (auto _ : state) {
+        FlatOrderBook book;
+        for (const L2Event& e : events) {
+            if (!e.is_trade) book.set_level(e.side, e.price, e.qty);
+        }
+        benchmark::DoNotOptimize(book.best_bid());
+    }
+    state.SetItemsProcessed(state.iterations() * events.size());
+}
+
+BENCHMARK(BM_TradeOnlyView);
+BENCHMARK(BM_BookViewVirtual);
+BENCHMARK(BM_BookViewDevirtualized);
+BENCHMARK(BM_MarketSweep)->Args({1, 0})->Args({8, 0})->Args({40, 0})->Args({8, 1});
+BENCHMARK_TEMPLATE(BM_RestingOrders, TradeThroughExecution)->Arg(10)->Arg(1000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_RestingOrders, ReferenceTradeThroughExecution<>)->Arg(10)->Arg(1000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_Requote, TradeThroughExecution)->Arg(10)->Arg(1000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_Requote, ReferenceTradeThroughExecution<>)->Arg(10)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_QueueReplay)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BookOnlyReplay)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace signalforge
@@ -1,7 +1,12 @@
 #include "trade_through_execution.h"
+#include "reference_trade_through_execution.h"
+#include "cpp/market/order_book_market_view.h"
 #include "cpp/market/trade_only_market_view.h"
 #include <gtest/gtest.h>
 #include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
 
 namespace signalforge {
 
@@ -300,4 +305,398 @@ TEST_F(TradeThroughExecutionTest, RealisticScenario) {
     EXPECT_FALSE(exec.poll_fill(fill));
 }
 
+// Resting limits at the same price fill in submission order, across sides
+TEST_F(TradeThroughExecutionTest, CrossedLimitsFillInSubmissionOrder) {
+    OrderId deep = exec.submit({Side::BID, OrderType::LIMIT, 105, 1});
+    OrderId ask = exec.submit({Side::ASK, OrderType::LIMIT, 95, 2});
+    OrderId near = exec.submit({Side::BID, OrderType::LIMIT, 101, 3});
+    OrderId same = exec.submit({Side::BID, OrderType::LIMIT, 105, 4});
+    OrderId market = exec.submit({Side::ASK, OrderType::MARKET, 0, 5});
+    exec.submit({Side::BID, OrderType::LIMIT, 99, 6});
+    EXPECT_EQ(exec.open_orders(), 6u);
+
+    view.on_trade(100);
+    exec.on_tick();
+    EXPECT_EQ(exec.open_orders(), 1u);
+
+    Fill fill;
+    for (OrderId id : {deep, ask, near, same, market}) {
+        ASSERT_TRUE(exec.poll_fill(fill));
+        EXPECT_EQ(fill.order_id, id);
+        EXPECT_EQ(fill.price, 100);
+    }
+    EXPECT_FALSE(exec.poll_fill(fill));
+}
+
+// Cancelled orders never fill; unknown, filled and cancelled ids are rejected
+TEST_F(TradeThroughExecutionTest, CancelOrders) {
+    OrderId bid = exec.submit({Side::BID, OrderType::LIMIT, 100, 1});
+    OrderId market = exec.submit({Side::ASK, OrderType::MARKET, 0, 1});
+    OrderId ask = exec.submit({Side::ASK, OrderType::LIMIT, 101, 1});
+
+    exec.cancel(bid);
+    exec.cancel(market);
+    exec.cancel(bid);
+    exec.cancel(999);
+    EXPECT_EQ(exec.open_orders(), 1u);
+
+    view.on_trade(100);
+    exec.on_tick();
+    Fill fill;
+    EXPECT_FALSE(exec.poll_fill(fill));
+
+    view.on_trade(101);
+    exec.on_tick();
+    ASSERT_TRUE(exec.poll_fill(fill));
+    EXPECT_EQ(fill.order_id, ask);
+    exec.cancel(ask);
+
+    const std::vector<std::pair<OrderId, OrderEventType>> want = {
+        {bid, OrderEventType::CANCELLED},
+        {market, OrderEventType::CANCELLED},
+        {bid, OrderEventType::CANCEL_REJECTED},
+        {999, OrderEventType::CANCEL_REJECTED},
+        {ask, OrderEventType::CANCEL_REJECTED},
+    };
+    OrderEvent event;
+    for (const auto& [id, type] : want) {
+        ASSERT_TRUE(exec.poll_event(event));
+        EXPECT_EQ(event.order_id, id);
+        EXPECT_EQ(event.type, type);
+    }
+    EXPECT_FALSE(exec.poll_event(event));
+    EXPECT_EQ(exec.open_orders(), 0u);
+}
+
+// A new price moves the order behind the others; a new size alone does not
+TEST_F(TradeThroughExecutionTest, ReplaceOrders) {
+    OrderId a = exec.submit({Side::BID, OrderType::LIMIT, 90, 1});
+    OrderId b = exec.submit({Side::BID, OrderType::LIMIT, 100, 1});
+    OrderId c = exec.submit({Side::BID, OrderType::LIMIT, 100, 1});
+    OrderId market = exec.submit({Side::BID, OrderType::MARKET, 0, 1});
+    exec.cancel(market);
+
+    exec.replace(a, 100, 7);   // repriced: now after b and c
+    exec.replace(b, 100, 3);   // resized in place
+    exec.replace(c, 100, 0);   // rejected
+    exec.replace(market, 100, 1);  // rejected, cancelled
+    exec.replace(42, 100, 1);  // rejected, unknown
+
+    OrderEvent event;
+    for (OrderEventType type : {OrderEventType::CANCELLED, OrderEventType::REPLACED, OrderEventType::REPLACED,
+                                OrderEventType::REPLACE_REJECTED, OrderEventType::REPLACE_REJECTED,
+                                OrderEventType::REPLACE_REJECTED}) {
+        ASSERT_TRUE(exec.poll_event(event));
+        EXPECT_EQ(event.type, type);
+    }
+    EXPECT_FALSE(exec.poll_event(event));
+
+    view.on_trade(95);
+    exec.on_tick();
+    Fill fill;
+    for (auto [id, qty] : {std::pair<OrderId, Quantity>{b, 3}, {c, 1}, {a, 7}}) {
+        ASSERT_TRUE(exec.poll_fill(fill));
+        EXPECT_EQ(fill.order_id, id);
+        EXPECT_EQ(fill.qty, qty);
+        EXPECT_EQ(fill.price, 95);
+    }
+    EXPECT_FALSE(exec.poll_fill(fill));
+
+    // Repricing away from the market keeps an order resting
+    OrderId d = exec.submit({Side::ASK, OrderType::LIMIT, 96, 1});
+    exec.replace(d, 200, 1);
+    view.on_trade(150);
+    exec.on_tick();
+    EXPECT_FALSE(exec.poll_fill(fill));
+    EXPECT_EQ(exec.open_orders(), 1u);
+}
+
+// Same fills, in the same order, as the original scan over every order
+TEST(TradeThroughExecutionParityTest, MatchesReference) {
+    std::mt19937_64 rng(17);
+    std::uniform_int_distribution<int> step(-4, 4);
+    std::uniform_int_distribution<int> offset(-30, 30);
+    std::uniform_int_distribution<int> action(0, 9);
+
+    TradeOnlyMarketView view;
+    TradeThroughExecution exec(view);
+    ReferenceTradeThroughExecution<> reference(view);
+
+    Price price = 10000;
+    size_t fills = 0;
+    OrderId last_id = 0;
+    for (int tick = 0; tick < 20000; ++tick) {
+        // Bursts of orders at random distances, including marketable ones
+        for (int n = action(rng); n > 0; n -= 3) {
+            const Side side = rng() & 1 ? Side::BID : Side::ASK;
+            const OrderType type = action(rng) == 0 ? OrderType::MARKET : OrderType::LIMIT;
+            const OrderIntent intent{side, type, price + offset(rng), static_cast<Quantity>(1 + rng() % 5)};
+            last_id = exec.submit(intent);
+            ASSERT_EQ(last_id, reference.submit(intent));
+        }
+
+        // Cancels and replaces of recent ids, some of them already gone
+        for (int n = action(rng); last_id > 0 && n > 5; --n) {
+            const OrderId id = last_id - rng() % std::min<OrderId>(last_id, 50);
+            if (rng() & 1) {
+                exec.cancel(id);
+                reference.cancel(id);
+            } else {
+                const Price new_price = rng() & 1 ? price + offset(rng) : price;
+                const Quantity new_qty = static_cast<Quantity>(rng() % 4);
+                exec.replace(id, new_price, new_qty);
+                reference.replace(id, new_price, new_qty);
+            }
+        }
+
+        price += step(rng);
+        view.on_trade(price);
+        exec.on_tick();
+        reference.on_tick();
+
+        OrderEvent got_event, want_event;
+        while (reference.poll_event(want_event)) {
+            ASSERT_TRUE(exec.poll_event(got_event)) << "tick " << tick;
+            ASSERT_EQ(got_event.order_id, want_event.order_id);
+            ASSERT_EQ(got_event.type, want_event.type);
+        }
+        ASSERT_FALSE(exec.poll_event(got_event));
+
+        Fill got, want;
+        while (reference.poll_fill(want)) {
+            ASSERT_TRUE(exec.poll_fill(got)) << "tick " << tick;
+            ASSERT_EQ(got.order_id, want.order_id) << "tick " << tick;
+            ASSERT_EQ(got.side, want.side);
+            ASSERT_EQ(got.price, want.price);
+            ASSERT_EQ(got.qty, want.qty);
+            ++fills;
+        }
+        ASSERT_FALSE(exec.poll_fill(got));
+        ASSERT_EQ(exec.open_orders(), reference.open_orders());
+    }
+    EXPECT_GT(fills, 10000u);
+    EXPECT_GT(exec.open_orders(), 10u);
+}
+
+
+class OrderBookMarketViewTest : public ::testing::Test {
+protected:
+    OrderBook book;
+    OrderBookMarketView view{book};
+};
+
+// Test initial state
+TEST_F(OrderBookMarketViewTest, InitialState) {
+    EXPECT_FALSE(view.has_top());
+    EXPECT_FALSE(view.has_last());
+}
+
+// Quotes come from the book, last price from trades
+TEST_F(OrderBookMarketViewTest, QuotesFollowBook) {
+    book.set_level(Side::BID, 99, 10);
+    EXPECT_FALSE(view.has_top());  // one-sided book
+
+    book.set_level(Side::ASK, 101, 5);
+    EXPECT_TRUE(view.has_top());
+    EXPECT_EQ(view.best_bid(), 99);
+    EXPECT_EQ(view.best_ask(), 101);
+    EXPECT_FALSE(view.has_last());
+
+    view.on_trade(100);
+    EXPECT_TRUE(view.has_last());
+    EXPECT_EQ(view.last_price(), 100);
+
+    const uint64_t v = view.top_version();
+    book.set_level(Side::ASK, 105, 5);
+    EXPECT_EQ(view.top_version(), v);
+    book.set_level(Side::ASK, 101, 0);
+    EXPECT_NE(view.top_version(), v);
+    EXPECT_EQ(view.best_ask(), 105);
+}
+
+class BookTradeThroughExecutionTest : public ::testing::Test {
+protected:
+    FlatOrderBook book;
+    FlatOrderBookMarketView view{book};
+    BasicTradeThroughExecution<FlatOrderBookMarketView> exec{view};
+};
+
+// Market orders cross the real spread
+TEST_F(BookTradeThroughExecutionTest, MarketOrdersPayTheSpread) {
+    book.set_level(Side::BID, 99, 10);
+    book.set_level(Side::ASK, 101, 10);
+
+    OrderId buy = exec.submit({Side::BID, OrderType::MARKET, 0, 1});
+    OrderId sell = exec.submit({Side::ASK, OrderType::MARKET, 0, 1});
+
+    view.on_trade(100);
+    exec.on_tick();
+
+    Fill fill;
+    ASSERT_TRUE(exec.poll_fill(fill));
+    EXPECT_EQ(fill.order_id, buy);
+    EXPECT_EQ(fill.price, 101);
+
+    ASSERT_TRUE(exec.poll_fill(fill));
+    EXPECT_EQ(fill.order_id, sell);
+    EXPECT_EQ(fill.price, 99);
+}
+
+// Without both sides of the book, market orders fall back to the last trade
+TEST_F(BookTradeThroughExecutionTest, MarketOrderWithoutQuotes) {
+    book.set_level(Side::BID, 99, 10);
+    exec.submit({Side::BID, OrderType::MARKET, 0, 1});
+
+    view.on_trade(100);
+    exec.on_tick();
+
+    Fill fill;
+    ASSERT_TRUE(exec.poll_fill(fill));
+    EXPECT_EQ(fill.price, 100);
+}
+
+// Limit orders still trade through on the tape
+TEST_F(BookTradeThroughExecutionTest, LimitOrdersUseLastTrade) {
+    book.set_level(Side::BID, 99, 10);
+    book.set_level(Side::ASK, 101, 10);
+
+    OrderId id = exec.submit({Side::BID, OrderType::LIMIT, 100, 1});
+
+    view.on_trade(101);
+    exec.on_tick();
+
+    Fill fill;
+    EXPECT_FALSE(exec.poll_fill(fill));
+
+    view.on_trade(100);
+    exec.on_tick();
+
+    ASSERT_TRUE(exec.poll_fill(fill));
+    EXPECT_EQ(fill.order_id, id);
+    EXPECT_EQ(fill.price, 100);
+}
+
+// Market orders walk the book, one fill per level at its price, and wait
+// for more liquidity once the side runs dry
+TEST_F(BookTradeThroughExecutionTest, MarketOrdersSweepDepth) {
+    book.set_level(Side::BID, 99, 10);
+    book.set_level(Side::ASK, 101, 3);
+    book.set_level(Side::ASK, 102, 4);
+    book.set_level(Side::ASK, 104, 5);
+
+    OrderId id = exec.submit({Side::BID, OrderType::MARKET, 0, 15});
+    view.on_trade(100);
+    exec.on_tick();
+
+    const std::vector<std::pair<Price, Quantity>> want = {{101, 3}, {102, 4}, {104, 5}};
+    Fill fill;
+    for (const auto& [price, qty] : want) {
+        ASSERT_TRUE(exec.poll_fill(fill));
+        EXPECT_EQ(fill.order_id, id);
+        EXPECT_EQ(fill.price, price);
+        EXPECT_EQ(fill.qty, qty);
+    }
+    EXPECT_FALSE(exec.poll_fill(fill));
+    EXPECT_EQ(exec.open_orders(), 1u);
+
+    // The depth stream catches up with what we took, and more arrives
+    book.set_level(Side::ASK, 101, 0);
+    book.set_level(Side::ASK, 102, 0);
+    book.set_level(Side::ASK, 104, 0);
+    book.set_level(Side::ASK, 105, 10);
+    exec.on_tick();
+    ASSERT_TRUE(exec.poll_fill(fill));
+    EXPECT_EQ(fill.price, 105);
+    EXPECT_EQ(fill.qty, 3);
+    EXPECT_EQ(exec.open_orders(), 0u);
+}
+
+// A crossing limit sweeps down to its price and the rest rests, filling
+// only when the tape trades through it on a later tick
+TEST_F(BookTradeThroughExecutionTest, MarketableLimitSweepsToItsPrice) {
+    book.set_level(Side::BID, 100, 2);
+    book.set_level(Side::BID, 99, 2);
+    book.set_level(Side::BID, 98, 2);
+    view.on_trade(99);
+
+    OrderId id = exec.submit({Side::ASK, OrderType::LIMIT, 99, 5});
+    exec.on_tick();
+
+    Fill fill;
+    ASSERT_TRUE(exec.poll_fill(fill));
+    EXPECT_EQ(fill.price, 100);
+    EXPECT_EQ(fill.qty, 2);
+    ASSERT_TRUE(exec.poll_fill(fill));
+    EXPECT_EQ(fill.price, 99);
+    EXPECT_EQ(fill.qty, 2);
+    EXPECT_FALSE(exec.poll_fill(fill));  // not at the last price on the same tick
+    EXPECT_EQ(exec.open_orders(), 1u);
+
+    book.set_level(Side::BID, 100, 0);
+    book.set_level(Side::BID, 99, 0);
+    view.on_trade(99);
+    exec.on_tick();
+    ASSERT_TRUE(exec.poll_fill(fill));
+    EXPECT_EQ(fill.order_id, id);
+    EXPECT_EQ(fill.price, 99);
+    EXPECT_EQ(fill.qty, 1);
+}
+
+// Taken liquidity is held back from the next sweeps and recovers linearly
+TEST(BookTradeThroughExecutionDepletionTest, TakenLevelsRecover) {
+    FlatOrderBook book;
+    FlatOrderBookMarketView view{book};
+    BasicTradeThroughExecution<FlatOrderBookMarketView> exec{view, {true, 4}};
+    book.set_level(Side::BID, 99, 10);
+    book.set_level(Side::ASK, 101, 8);
+    book.set_level(Side::ASK, 102, 100);
+    view.on_trade(100);
+
+    auto buy = [&](Quantity qty) {
+        exec.submit({Side::BID, OrderType::MARKET, 0, qty});
+        exec.on_tick();
+        std::vector<std::pair<Price, Quantity>> out;
+        Fill fill;
+        while (exec.poll_fill(fill)) out.emplace_back(fill.price, fill.qty);
+        return out;
+    };
+    using Fills = std::vector<std::pair<Price, Quantity>>;
+
+    EXPECT_EQ(buy(8), (Fills{{101, 8}}));
+    EXPECT_EQ(buy(8), (Fills{{101, 2}, {102, 6}}));  // 6 of 8 still missing
+    exec.on_tick();
+    exec.on_tick();
+    exec.on_tick();
+    EXPECT_EQ(buy(1), (Fills{{101, 1}}));  // recovered in full
+}
+
+// Given the time, recovery follows timestamps, not the number of ticks
+TEST(BookTradeThroughExecutionDepletionTest, RecoveryFollowsTimestamps) {
+    FlatOrderBook book;
+    FlatOrderBookMarketView view{book};
+    BasicTradeThroughExecution<FlatOrderBookMarketView> exec{view, {true, 1000}};
+    book.set_level(Side::BID, 99, 10);
+    book.set_level(Side::ASK, 101, 8);
+    book.set_level(Side::ASK, 102, 100);
+    view.on_trade(100);
+
+    auto buy_at = [&](uint64_t t, Quantity qty) {
+        exec.submit({Side::BID, OrderType::MARKET, 0, qty});
+        exec.advance_time(t);
+        exec.on_tick();
+        Fill fill;
+        Price worst = 0;
+        while (exec.poll_fill(fill)) worst = fill.price;
+        return worst;
+    };
+
+    EXPECT_EQ(buy_at(5000, 8), 101);
+    for (int i = 0; i < 100; ++i) {
+        exec.advance_time(5500);
+        exec.on_tick();
+    }
+    EXPECT_EQ(buy_at(5500, 5), 102);  // half of 8 back after 500 ms: 4
+    EXPECT_EQ(buy_at(6600, 8), 101);  // all of it, 1100 ms after the last take
+}
+
 }  // namespace signalforge
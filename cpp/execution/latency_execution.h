@@ -0,0 +1,127 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include "latency_model.h"
+#include "cpp/interfaces/execution_model.h"
+
+namespace signalforge {
+
+// Puts order-entry and market-data delays between a strategy and an
+// execution model. Submits, cancels and replaces are held until they
+// "arrive" and only then reach the inner model, so they match against the
+// market as it is by then rather than as the strategy saw it.
+//
+// A request made while handling the tick at time t arrives at
+//   t + feed delay of that tick + order-entry delay of the request
+// and is handed to the inner model on the first tick at or after that
+// time, before the tick is matched. Requests travel over one session, so
+// they arrive in the order they were made: a request never overtakes an
+// earlier one, and a cancel cannot reach the exchange before its order.
+// With zero delays the inner model sees exactly what it would without
+// this wrapper.
+//
+// Time only moves in advance_time, so the driver must call it with the
+// tick's timestamp before every on_tick, as BacktestEngine does. Driven by
+// on_tick alone the clock stays at 0 and delayed requests never arrive;
+// on_tick throws std::runtime_error rather than let them hang.
+//
+// Order ids are assigned here at submit time. The inner model must number
+// orders 1, 2, 3... in submission order, as the models in this package
+// do, and must not take orders from anyone else; otherwise the ids of its
+// fills would not match. Fills and events pass through undelayed.
+//
+// Inner is the wrapped model type; neither it nor the latency models are
+// owned.
+template <typename Inner = ExecutionModel>
+class LatencyExecution final : public ExecutionModel {
+public:
+    // feed may be null for no market-data delay
+    LatencyExecution(Inner& inner, LatencyModel& entry, LatencyModel* feed = nullptr)
+        : inner_(inner), entry_(entry), feed_(feed) {}
+
+    OrderId submit(const OrderIntent& intent) override {
+        const OrderId id = ++next_id_;
+        send({Request::SUBMIT, id, intent, 0});
+        return id;
+    }
+
+    void cancel(OrderId id) override { send({Request::CANCEL, id, {}, 0}); }
+
+    void replace(OrderId id, Price new_price, Quantity new_qty) override {
+        send({Request::REPLACE, id, {Side::BID, OrderType::LIMIT, new_price, new_qty}, 0});
+    }
+
+    // The strategy reacts to this tick's data feed_delay after it happened
+    void advance_time(uint64_t timestamp) override {
+        now_ = timestamp;
+        clocked_ = true;
+        feed_delay_ = feed_ ? feed_->sample() : 0;
+        inner_.advance_time(timestamp);
+    }
+
+    // Hands over what has arrived by now, then matches. Throws
+    // std::runtime_error if requests are still in flight and advance_time
+    // was never called.
+    void on_tick() override {
+        while (!in_flight_.empty() && in_flight_.front().arrival <= now_) {
+            const Request r = in_flight_.front();
+            in_flight_.pop_front();
+            deliver(r);
+        }
+        if (!clocked_ && !in_flight_.empty()) {
+            throw std::runtime_error("LatencyExecution: requests in flight but advance_time was never called");
+        }
+        inner_.on_tick();
+    }
+
+    bool poll_fill(Fill& out) override { return inner_.poll_fill(out); }
+    bool poll_event(OrderEvent& out) override { return inner_.poll_event(out); }
+
+    // Requests sent but not yet arrived
+    size_t in_flight() const { return in_flight_.size(); }
+
+private:
+    struct Request {
+        enum Kind { SUBMIT, CANCEL, REPLACE } kind;
+        OrderId id;
+        OrderIntent intent;  // submit; replace uses limit_price and qty
+        uint64_t arrival;
+    };
+
+    void send(Request r) {
+        r.arrival = std::max(now_ + feed_delay_ + entry_.sample(), last_arrival_);
+        last_arrival_ = r.arrival;
+        in_flight_.push_back(r);
+    }
+
+    void deliver(const Request& r) {
+        switch (r.kind) {
+            case Request::SUBMIT:
+                if (inner_.submit(r.intent) != r.id) {
+                    throw std::runtime_error("LatencyExecution: inner model ids do not follow submission order");
+                }
+                break;
+            case Request::CANCEL:
+                inner_.cancel(r.id);
+                break;
+            case Request::REPLACE:
+                inner_.replace(r.id, r.intent.limit_price, r.intent.qty);
+                break;
+        }
+    }
+
+    Inner& inner_;
+    LatencyModel& entry_;
+    LatencyModel* feed_;
+    uint64_t now_ = 0;
+    bool clocked_ = false;  // advance_time has been called
+    uint64_t feed_delay_ = 0;
+    uint64_t last_arrival_ = 0;
+    OrderId next_id_ = 0;
+    std::deque<Request> in_flight_;  // in arrival order
+};
+
+}  // namespace signalforge
@@ -0,0 +1,184 @@
+#include "latency_execution.h"
+#include "trade_through_execution.h"
+#include "cpp/market/trade_only_market_view.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace signalforge {
+
+class LatencyExecutionTest : public ::testing::Test {
+protected:
+    // One trade at price and time t
+    std::vector<Fill> tick(uint64_t t, Price price) {
+        view.on_trade(price);
+        exec.advance_time(t);
+        exec.on_tick();
+        std::vector<Fill> out;
+        Fill f;
+        while (exec.poll_fill(f)) out.push_back(f);
+        return out;
+    }
+
+    TradeOnlyMarketView view;
+    BasicTradeThroughExecution<TradeOnlyMarketView> inner{view};
+    FixedLatency entry{5};
+    FixedLatency feed{2};
+    LatencyExecution<BasicTradeThroughExecution<TradeOnlyMarketView>> exec{inner, entry, &feed};
+};
+
+// An order sent at t arrives after feed and entry delays and fills
+// against the market of the arrival tick
+TEST_F(LatencyExecutionTest, OrdersArriveAfterDelay) {
+    tick(100, 50);
+    const OrderId id = exec.submit({Side::BID, OrderType::MARKET, 0, 1});
+    EXPECT_EQ(exec.in_flight(), 1u);
+
+    EXPECT_TRUE(tick(103, 51).empty());
+    EXPECT_TRUE(tick(106, 52).empty());
+    const auto f = tick(107, 53);
+    ASSERT_EQ(f.size(), 1u);
+    EXPECT_EQ(f[0].order_id, id);
+    EXPECT_EQ(f[0].price, 53);
+    EXPECT_EQ(exec.in_flight(), 0u);
+}
+
+// A cancel that has not arrived yet cannot stop a fill
+TEST_F(LatencyExecutionTest, CancelsRaceFills) {
+    tick(0, 50);
+    const OrderId id = exec.submit({Side::BID, OrderType::LIMIT, 49, 1});
+    tick(10, 50);  // arrived, resting
+    exec.cancel(id);
+    const auto f = tick(12, 48);
+    ASSERT_EQ(f.size(), 1u);
+    EXPECT_EQ(f[0].order_id, id);
+
+    tick(20, 48);
+    OrderEvent e;
+    ASSERT_TRUE(exec.poll_event(e));
+    EXPECT_EQ(e.order_id, id);
+    EXPECT_EQ(e.type, OrderEventType::CANCEL_REJECTED);
+}
+
+// Without advance_time the clock never moves, so delayed requests could
+// never arrive; on_tick refuses to run instead of hanging them
+TEST(LatencyExecutionClockTest, RequiresAdvanceTime) {
+    TradeOnlyMarketView view;
+    BasicTradeThroughExecution<TradeOnlyMarketView> inner{view};
+    FixedLatency entry{5};
+    LatencyExecution<BasicTradeThroughExecution<TradeOnlyMarketView>> exec{inner, entry};
+
+    view.on_trade(50);
+    exec.on_tick();  // nothing in flight yet
+    exec.submit({Side::BID, OrderType::MARKET, 0, 1});
+    EXPECT_THROW(exec.on_tick(), std::runtime_error);
+
+    exec.advance_time(5);
+    exec.on_tick();
+    EXPECT_EQ(exec.in_flight(), 0u);
+    Fill f;
+    EXPECT_TRUE(exec.poll_fill(f));
+}
+
+// Random delays never reorder requests, so every cancel finds its order
+TEST(LatencyExecutionOrderTest, RequestsArriveInOrder) {
+    TradeOnlyMarketView view;
+    BasicTradeThroughExecution<TradeOnlyMarketView> inner{view};
+    RandomLatency<std::uniform_int_distribution<int>> entry(std::uniform_int_distribution<int>(0, 50), 3);
+    LatencyExecution<BasicTradeThroughExecution<TradeOnlyMarketView>> exec{inner, entry};
+
+    size_t cancelled = 0;
+    for (uint64_t t = 1; t <= 2000; ++t) {
+        view.on_trade(1000);
+        exec.advance_time(t);
+        exec.on_tick();
+        OrderEvent e;
+        while (exec.poll_event(e)) {
+            EXPECT_EQ(e.type, OrderEventType::CANCELLED);
+            ++cancelled;
+        }
+        exec.cancel(exec.submit({Side::BID, OrderType::LIMIT, 900, 1}));
+    }
+    EXPECT_GT(cancelled, 1900u);
+}
+
+// With no delay the wrapper is invisible: same fills as the bare model
+TEST(LatencyExecutionParityTest, ZeroDelayMatchesInner) {
+    TradeOnlyMarketView view;
+    BasicTradeThroughExecution<TradeOnlyMarketView> bare{view};
+    BasicTradeThroughExecution<TradeOnlyMarketView> inner{view};
+    FixedLatency none{0};
+    LatencyExecution<BasicTradeThroughExecution<TradeOnlyMarketView>> exec{inner, none, &none};
+
+    std::mt19937_64 rng(25);
+    Price price = 1000;
+    size_t fills = 0;
+    for (uint64_t t = 0; t < 5000; ++t) {
+        price += static_cast<Price>(rng() % 5) - 2;
+        view.on_trade(price);
+        exec.advance_time(t);
+        exec.on_tick();
+        bare.on_tick();
+
+        Fill a, b;
+        while (bare.poll_fill(a)) {
+            ASSERT_TRUE(exec.poll_fill(b));
+            EXPECT_EQ(a.order_id, b.order_id);
+            EXPECT_EQ(a.price, b.price);
+            EXPECT_EQ(a.qty, b.qty);
+            ++fills;
+        }
+        ASSERT_FALSE(exec.poll_fill(b));
+
+        const OrderIntent in{rng() & 1 ? Side::BID : Side::ASK,
+                             rng() % 4 == 0 ? OrderType::MARKET : OrderType::LIMIT,
+                             price + static_cast<Price>(rng() % 7) - 3, 1};
+        EXPECT_EQ(exec.submit(in), bare.submit(in));
+    }
+    EXPECT_GT(fills, 1000u);
+}
+
+TEST(LatencyModelTest, ProfileReplaysInOrder) {
+    ProfileLatency profile({3, 1, 4});
+    const std::vector<uint64_t> want = {3, 1, 4, 3, 1};
+    for (uint64_t d : want) EXPECT_EQ(profile.sample(), d);
+    EXPECT_THROW(ProfileLatency(std::vector<uint64_t>{}), std::runtime_error);
+}
+
+TEST(LatencyModelTest, ProfileLoadsFromFile) {
+    const std::string path = ::testing::TempDir() + "latency_profile.txt";
+    {
+        std::ofstream out(path);
+        out << "# one-way ms\n12\n\n7\r\n30\n";
+    }
+    ProfileLatency profile = ProfileLatency::load(path);
+    EXPECT_EQ(profile.size(), 3u);
+    EXPECT_EQ(profile.sample(), 12u);
+    EXPECT_EQ(profile.sample(), 7u);
+    EXPECT_EQ(profile.sample(), 30u);
+
+    {
+        std::ofstream out(path);
+        out << "12\n-3\n";
+    }
+    EXPECT_THROW(ProfileLatency::load(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(ProfileLatency::load(path), std::runtime_error);
+}
+
+TEST(LatencyModelTest, RandomIsSeededAndNonNegative) {
+    RandomLatency<std::normal_distribution<double>> a(std::normal_distribution<double>(1.0, 5.0), 7);
+    RandomLatency<std::normal_distribution<double>> b(std::normal_distribution<double>(1.0, 5.0), 7);
+    bool clamped = false;
+    for (int i = 0; i < 1000; ++i) {
+        const uint64_t d = a.sample();
+        EXPECT_EQ(d, b.sample());
+        clamped |= d == 0;
+    }
+    EXPECT_TRUE(clamped);
+}
+
+}  // namespace signalforge
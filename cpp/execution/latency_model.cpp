@@ -0,0 +1,37 @@
+#include "latency_model.h"
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace signalforge {
+
+ProfileLatency::ProfileLatency(std::vector<uint64_t> samples) : samples_(std::move(samples)) {
+    if (samples_.empty()) throw std::runtime_error("Latency profile has no samples");
+}
+
+ProfileLatency ProfileLatency::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open latency profile: " + path);
+
+    std::vector<uint64_t> samples;
+    std::string line;
+    size_t line_no = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        uint64_t delay = 0;
+        for (char c : line) {
+            if (c < '0' || c > '9') {
+                throw std::runtime_error("Bad latency at " + path + ":" + std::to_string(line_no) + ": " + line);
+            }
+            delay = delay * 10 + static_cast<uint64_t>(c - '0');
+        }
+        samples.push_back(delay);
+    }
+    if (samples.empty()) throw std::runtime_error("Latency profile has no samples: " + path);
+    return ProfileLatency(std::move(samples));
+}
+
+}  // namespace signalforge
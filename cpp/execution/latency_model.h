@@ -0,0 +1,70 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace signalforge {
+
+// Source of one-way delays, in the units of the tick timestamps (ms for
+// Trade::timestamp). Each call draws the delay of one message.
+class LatencyModel {
+public:
+    virtual ~LatencyModel() = default;
+    virtual uint64_t sample() = 0;
+};
+
+class FixedLatency final : public LatencyModel {
+public:
+    explicit FixedLatency(uint64_t delay) : delay_(delay) {}
+    uint64_t sample() override { return delay_; }
+
+private:
+    uint64_t delay_;
+};
+
+// Delays drawn from a <random> distribution, e.g.
+// std::lognormal_distribution<double>, rounded to the nearest unit and
+// clamped at 0. Seeded, so replays stay deterministic.
+template <typename Distribution>
+class RandomLatency final : public LatencyModel {
+public:
+    RandomLatency(Distribution distribution, uint64_t seed) : distribution_(distribution), rng_(seed) {}
+
+    uint64_t sample() override {
+        const double delay = std::round(static_cast<double>(distribution_(rng_)));
+        return delay > 0 ? static_cast<uint64_t>(delay) : 0;
+    }
+
+private:
+    Distribution distribution_;
+    std::mt19937_64 rng_;
+};
+
+// Replays measured delays in order, starting over at the end.
+class ProfileLatency final : public LatencyModel {
+public:
+    // Throws std::runtime_error if samples is empty
+    explicit ProfileLatency(std::vector<uint64_t> samples);
+
+    // One delay per line; blank lines and lines starting with '#' are
+    // skipped. Throws std::runtime_error if the file cannot be read, a line
+    // is not a non-negative integer, or there are no delays.
+    static ProfileLatency load(const std::string& path);
+
+    uint64_t sample() override {
+        const uint64_t delay = samples_[next_];
+        if (++next_ == samples_.size()) next_ = 0;
+        return delay;
+    }
+
+    size_t size() const { return samples_.size(); }
+
+private:
+    std::vector<uint64_t> samples_;
+    size_t next_ = 0;
+};
+
+}  // namespace signalforge
@@ -0,0 +1,431 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include "depth_sweep.h"
+#include "cpp/interfaces/execution_model.h"
+#include "cpp/orderbook/flat_order_book.h"
+#include "cpp/orderbook/order_book.h"
+
+namespace signalforge {
+
+// L2 execution model that tracks where each resting limit order sits in
+// its price level's queue, for passive strategies that the trade-through
+// model flatters.
+//
+// A limit order that does not cross the book joins the back of its level:
+// its queue ahead is the book quantity at that price when it is submitted.
+// From then on
+//   - trades at the order's price on its side (sellers hitting bids, buyers
+//     lifting asks) first drain the queue ahead, and only the volume left
+//     over fills the order, possibly in part
+//   - a trade through the order's price fills it in full at its limit
+//   - level reductions the trades do not explain are cancellations, taken
+//     to be spread evenly over the queue, so the queue ahead shrinks in
+//     proportion; quantity added to a level joins behind
+// Our own orders are not in the recorded book. Several at one level queue
+// in submission order, and trade volume reaches them in that order.
+//
+// Market orders, and limit orders that cross the book when submitted, sweep
+// the opposite side on the next on_tick, one fill per level (DepthSweeper);
+// a limit goes no deeper than its price and rests with what is left, a
+// market order waits for more liquidity. When that side is empty, market
+// orders fill in full at the last trade. A crossing limit that no longer
+// crosses by then rests instead.
+//
+// The replay loop feeds both streams in event time order: on_tick() after
+// each depth event has been applied to the book, on_trade() for each
+// print. A trade should come before the depth event that removes its
+// volume, or that volume is counted once as cancelled and once as traded.
+// Per event the cost is proportional to the number of price levels holding
+// our orders, not to the depth of the book; at steady state nothing
+// allocates.
+//
+// Book is OrderBook or FlatOrderBook; the book is not owned.
+template <typename Book>
+class BasicQueueExecution final : public ExecutionModel {
+public:
+    explicit BasicQueueExecution(const Book& book, DepletionConfig depletion = {})
+        : book_(book), sweeper_(depletion) {}
+
+    OrderId submit(const OrderIntent& intent) override {
+        const OrderId id = ++next_id_;
+        const uint32_t slot = allocate(id, intent);
+        place(slot);
+        return id;
+    }
+
+    // Depletion recovers by this clock once given; by ticks otherwise
+    void advance_time(uint64_t timestamp) override {
+        timed_ = true;
+        now_ = timestamp;
+    }
+
+    // The book has changed: fill pending takers and bring queues in line
+    // with the new level quantities
+    void on_tick() override {
+        sweeper_.advance(timed_ ? now_ : ++ticks_);
+        if (!takers_.empty()) fill_takers();
+        sync<Side::BID>();
+        sync<Side::ASK>();
+    }
+
+    // One print of qty at price; buyer_maker when the seller was the
+    // aggressor, so resting bids were hit
+    void on_trade(Price price, Quantity qty, bool buyer_maker) {
+        last_trade_ = price;
+        due_.clear();
+        take_through<Side::BID>(price);
+        take_through<Side::ASK>(price);
+        if (buyer_maker) {
+            take_at<Side::BID>(price, qty);
+        } else {
+            take_at<Side::ASK>(price, qty);
+        }
+        queue_due();
+    }
+
+    bool poll_fill(Fill& out) override {
+        if (fills_.empty()) return false;
+        out = fills_.front();
+        fills_.pop_front();
+        return true;
+    }
+
+    void cancel(OrderId id) override {
+        const auto it = ids_.find(id);
+        if (it == ids_.end()) {
+            events_.push_back({id, OrderEventType::CANCEL_REJECTED});
+            return;
+        }
+        unplace(it->second);
+        release(it);
+        events_.push_back({id, OrderEventType::CANCELLED});
+    }
+
+    // new_qty is what is left to fill. A new price or a larger size goes to
+    // the back of the level's queue; only a smaller size keeps the order's
+    // place.
+    void replace(OrderId id, Price new_price, Quantity new_qty) override {
+        const auto it = ids_.find(id);
+        if (it == ids_.end() || new_qty <= 0 || slots_[it->second].type == OrderType::MARKET) {
+            events_.push_back({id, OrderEventType::REPLACE_REJECTED});
+            return;
+        }
+        const uint32_t slot = it->second;
+        OrderSlot& o = slots_[slot];
+        const bool requeue = new_price != o.limit || new_qty > o.qty;
+        o.qty = new_qty;
+        if (requeue) {
+            unplace(slot);
+            o.limit = new_price;
+            o.seq = ++next_seq_;
+            place(slot);
+        }
+        events_.push_back({id, OrderEventType::REPLACED});
+    }
+
+    bool poll_event(OrderEvent& out) override {
+        if (events_.empty()) return false;
+        out = events_.front();
+        events_.pop_front();
+        return true;
+    }
+
+    size_t open_orders() const { return ids_.size(); }
+
+    // Book quantity ahead of a resting order; false if it is not resting
+    bool queue_ahead(OrderId id, Quantity& out) const {
+        const auto it = ids_.find(id);
+        if (it == ids_.end() || !slots_[it->second].resting) return false;
+        out = slots_[it->second].ahead;
+        return true;
+    }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    // An open order; qty is what is left to fill. seq orders fills and is
+    // 0 while the slot is free. Resting orders at one level form a list
+    // through next, front of the queue first.
+    struct OrderSlot {
+        OrderId id;
+        uint64_t seq;
+        Side side;
+        OrderType type;
+        Price limit;
+        Quantity qty;
+        Quantity ahead;
+        uint32_t next;
+        bool resting;
+    };
+
+    // A price level holding our resting orders. seen is the book quantity
+    // the queues have been brought in line with.
+    struct OwnLevel {
+        Price price;
+        Quantity seen;
+        uint32_t head;
+        uint32_t tail;
+    };
+
+    struct Taker { uint64_t seq; uint32_t slot; };
+    struct Due { uint64_t seq; Fill fill; };
+
+    // Own levels of one side, sorted worst -> best like BookSide, so the
+    // levels a trade goes through are at the back
+    template <Side S>
+    struct OwnSide {
+        using Traits = SideTraits<S>;
+        std::vector<OwnLevel> levels;
+
+        static bool worse(Price a, Price b) { return Traits::better(b, a); }
+
+        typename std::vector<OwnLevel>::iterator lower(Price price) {
+            return std::lower_bound(levels.begin(), levels.end(), price,
+                [](const OwnLevel& l, Price p) { return worse(l.price, p); });
+        }
+    };
+
+    template <Side S>
+    OwnSide<S>& own() {
+        if constexpr (S == Side::BID) {
+            return bids_;
+        } else {
+            return asks_;
+        }
+    }
+
+    uint32_t allocate(OrderId id, const OrderIntent& intent) {
+        uint32_t slot;
+        if (!free_.empty()) {
+            slot = free_.back();
+            free_.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+        slots_[slot] = {id, ++next_seq_, intent.side, intent.type, intent.limit_price, intent.qty, 0, kNone, false};
+        ids_.emplace(id, slot);
+        return slot;
+    }
+
+    void release(typename std::unordered_map<OrderId, uint32_t>::iterator it) {
+        slots_[it->second].seq = 0;
+        free_.push_back(it->second);
+        ids_.erase(it);
+    }
+
+    bool crosses(Side side, Price limit) const {
+        if (side == Side::BID) {
+            const Price ask = book_.best_ask();
+            return ask != 0 && SideTraits<Side::ASK>::crossed_by(ask, limit);
+        }
+        const Price bid = book_.best_bid();
+        return bid != 0 && SideTraits<Side::BID>::crossed_by(bid, limit);
+    }
+
+    // New or repriced order: a taker on the next tick, or the back of its
+    // level's queue
+    void place(uint32_t slot) {
+        const OrderSlot& o = slots_[slot];
+        if (o.type == OrderType::MARKET || crosses(o.side, o.limit)) {
+            takers_.push_back({o.seq, slot});
+        } else {
+            rest_any(slot);
+        }
+    }
+
+    void rest_any(uint32_t slot) {
+        if (slots_[slot].side == Side::BID) {
+            rest<Side::BID>(slot);
+        } else {
+            rest<Side::ASK>(slot);
+        }
+    }
+
+    template <Side S>
+    void rest(uint32_t slot) {
+        OrderSlot& o = slots_[slot];
+        auto& side = own<S>();
+        auto it = side.lower(o.limit);
+        if (it == side.levels.end() || it->price != o.limit) {
+            it = side.levels.insert(it, {o.limit, book_.level_qty(S, o.limit), kNone, kNone});
+        }
+        o.ahead = it->seen;
+        o.next = kNone;
+        o.resting = true;
+        if (it->tail == kNone) {
+            it->head = slot;
+        } else {
+            slots_[it->tail].next = slot;
+        }
+        it->tail = slot;
+    }
+
+    // Takes a resting order out of its level; pending takers are simply
+    // left behind, their seq no longer matching
+    void unplace(uint32_t slot) {
+        if (!slots_[slot].resting) return;
+        if (slots_[slot].side == Side::BID) {
+            unlink<Side::BID>(slot);
+        } else {
+            unlink<Side::ASK>(slot);
+        }
+    }
+
+    template <Side S>
+    void unlink(uint32_t slot) {
+        OrderSlot& o = slots_[slot];
+        auto& side = own<S>();
+        auto it = side.lower(o.limit);
+        uint32_t prev = kNone;
+        for (uint32_t s = it->head; s != slot; s = slots_[s].next) prev = s;
+        (prev == kNone ? it->head : slots_[prev].next) = o.next;
+        if (it->tail == slot) it->tail = prev;
+        if (it->head == kNone) side.levels.erase(it);
+        o.resting = false;
+    }
+
+    void fill_takers() {
+        due_.clear();
+        std::size_t kept = 0;
+        for (const Taker& t : takers_) {
+            OrderSlot& o = slots_[t.slot];
+            if (o.seq != t.seq) continue;  // cancelled or repriced
+
+            const bool is_limit = o.type == OrderType::LIMIT;
+            const Price top = o.side == Side::BID ? book_.best_ask() : book_.best_bid();
+            if (top == 0) {
+                if (is_limit) {
+                    rest_any(t.slot);
+                } else if (last_trade_ == 0) {
+                    takers_[kept++] = t;  // nothing to trade against yet
+                } else {
+                    due_.push_back({o.seq, {o.id, o.side, last_trade_, o.qty}});
+                    release(ids_.find(o.id));
+                }
+                continue;
+            }
+            o.qty = sweeper_.sweep(book_, o.side, o.qty, is_limit, o.limit, [&](Price price, Quantity qty) {
+                due_.push_back({o.seq, {o.id, o.side, price, qty}});
+            });
+            if (o.qty == 0) {
+                release(ids_.find(o.id));
+            } else if (is_limit) {
+                rest_any(t.slot);
+            } else {
+                takers_[kept++] = t;  // waits for more liquidity
+            }
+        }
+        takers_.resize(kept);
+        queue_due();
+    }
+
+    template <Side S>
+    void sync() {
+        for (OwnLevel& level : own<S>().levels) {
+            const Quantity now = book_.level_qty(S, level.price);
+            if (now < level.seen) {
+                // Cancellations, spread evenly over the queue
+                const double keep = level.seen > 0 ? static_cast<double>(now) / static_cast<double>(level.seen) : 0.0;
+                for (uint32_t s = level.head; s != kNone; s = slots_[s].next) {
+                    OrderSlot& o = slots_[s];
+                    o.ahead = std::min(now, static_cast<Quantity>(static_cast<double>(o.ahead) * keep));
+                }
+            }
+            level.seen = now;
+        }
+    }
+
+    // Fills every order on side S that a print at price has gone through
+    template <Side S>
+    void take_through(Price price) {
+        auto& levels = own<S>().levels;
+        while (!levels.empty() && levels.back().price != price &&
+               SideTraits<S>::crossed_by(levels.back().price, price)) {
+            for (uint32_t s = levels.back().head; s != kNone;) {
+                OrderSlot& o = slots_[s];
+                s = o.next;
+                due_.push_back({o.seq, {o.id, S, o.limit, o.qty}});
+                release(ids_.find(o.id));
+            }
+            levels.pop_back();
+        }
+    }
+
+    // Walks qty traded at price down the queue of our level there, if any
+    template <Side S>
+    void take_at(Price price, Quantity qty) {
+        auto& side = own<S>();
+        auto it = side.lower(price);
+        if (it == side.levels.end() || it->price != price) return;
+
+        Quantity left = qty;       // volume not yet placed in the queue
+        Quantity book_taken = 0;   // book volume traded from the front
+        uint32_t prev = kNone;
+        for (uint32_t s = it->head; s != kNone;) {
+            OrderSlot& o = slots_[s];
+            const uint32_t next = o.next;
+
+            const Quantity gap = std::min(o.ahead - std::min(o.ahead, book_taken), left);
+            book_taken += gap;
+            left -= gap;
+            o.ahead = o.ahead - std::min(o.ahead, book_taken);
+
+            const Quantity filled = std::min(o.qty, left);
+            if (filled > 0) {
+                left -= filled;
+                o.qty -= filled;
+                due_.push_back({o.seq, {o.id, S, price, filled}});
+            }
+            if (o.qty == 0) {
+                (prev == kNone ? it->head : slots_[prev].next) = next;
+                if (it->tail == s) it->tail = prev;
+                o.resting = false;
+                release(ids_.find(o.id));
+            } else {
+                prev = s;
+            }
+            s = next;
+        }
+
+        // Whatever our orders did not take came out of the book
+        book_taken += left;
+        it->seen -= std::min(it->seen, book_taken);
+        if (it->head == kNone) side.levels.erase(it);
+    }
+
+    void queue_due() {
+        if (due_.size() > 1) {
+            // Stable, so one order's sweep fills stay best level first
+            std::stable_sort(due_.begin(), due_.end(), [](const Due& a, const Due& b) { return a.seq < b.seq; });
+        }
+        for (const Due& d : due_) fills_.push_back(d.fill);
+    }
+
+    const Book& book_;
+    DepthSweeper sweeper_;
+    uint64_t ticks_ = 0;
+    uint64_t now_ = 0;
+    bool timed_ = false;
+    OrderId next_id_ = 0;
+    uint64_t next_seq_ = 0;
+    Price last_trade_ = 0;
+    std::vector<OrderSlot> slots_;
+    std::vector<uint32_t> free_;
+    std::unordered_map<OrderId, uint32_t> ids_;
+    std::vector<Taker> takers_;
+    OwnSide<Side::BID> bids_;
+    OwnSide<Side::ASK> asks_;
+    std::vector<Due> due_;  // one event's fills, kept warm
+    std::deque<Fill> fills_;
+    std::deque<OrderEvent> events_;
+};
+
+using QueueExecution = BasicQueueExecution<OrderBook>;
+using FlatQueueExecution = BasicQueueExecution<FlatOrderBook>;
+
+}  // namespace signalforge
@@ -0,0 +1,355 @@
+#include "queue_execution.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace signalforge {
+
+template <typename Book>
+class QueueExecutionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        book.set_level(Side::BID, 100, 10);
+        book.set_level(Side::BID, 99, 20);
+        book.set_level(Side::ASK, 101, 10);
+        book.set_level(Side::ASK, 102, 20);
+    }
+
+    Quantity ahead(OrderId id) {
+        Quantity q = -1;
+        EXPECT_TRUE(exec.queue_ahead(id, q));
+        return q;
+    }
+
+    std::vector<Fill> fills() {
+        std::vector<Fill> out;
+        Fill f;
+        while (exec.poll_fill(f)) out.push_back(f);
+        return out;
+    }
+
+    Book book;
+    BasicQueueExecution<Book> exec{book};
+};
+
+using Books = ::testing::Types<OrderBook, FlatOrderBook>;
+TYPED_TEST_SUITE(QueueExecutionTest, Books);
+
+// Trades at the price drain the queue ahead first, then fill in part
+TYPED_TEST(QueueExecutionTest, TradesDrainQueueThenFillPartially) {
+    const OrderId id = this->exec.submit({Side::BID, OrderType::LIMIT, 100, 3});
+    EXPECT_EQ(this->ahead(id), 10);
+
+    this->exec.on_trade(100, 4, true);
+    EXPECT_EQ(this->ahead(id), 6);
+    EXPECT_TRUE(this->fills().empty());
+
+    // The depth stream catches up with the trade: not a cancellation
+    this->book.set_level(Side::BID, 100, 6);
+    this->exec.on_tick();
+    EXPECT_EQ(this->ahead(id), 6);
+
+    this->exec.on_trade(100, 8, true);
+    auto f = this->fills();
+    ASSERT_EQ(f.size(), 1u);
+    EXPECT_EQ(f[0].order_id, id);
+    EXPECT_EQ(f[0].side, Side::BID);
+    EXPECT_EQ(f[0].price, 100);
+    EXPECT_EQ(f[0].qty, 2);
+    EXPECT_EQ(this->ahead(id), 0);
+
+    this->exec.on_trade(100, 5, true);
+    f = this->fills();
+    ASSERT_EQ(f.size(), 1u);
+    EXPECT_EQ(f[0].qty, 1);
+    EXPECT_EQ(this->exec.open_orders(), 0u);
+}
+
+// Buyers lifting asks at our bid's price do not reach it
+TYPED_TEST(QueueExecutionTest, OnlyThePassiveSideTrades) {
+    const OrderId id = this->exec.submit({Side::BID, OrderType::LIMIT, 100, 3});
+    this->exec.on_trade(100, 50, false);
+    EXPECT_EQ(this->ahead(id), 10);
+    EXPECT_TRUE(this->fills().empty());
+}
+
+// Unexplained level reductions shrink the queue ahead in proportion;
+// additions join behind
+TYPED_TEST(QueueExecutionTest, CancellationsShrinkQueueInProportion) {
+    const OrderId id = this->exec.submit({Side::ASK, OrderType::LIMIT, 101, 1});
+    EXPECT_EQ(this->ahead(id), 10);
+
+    this->book.set_level(Side::ASK, 101, 5);
+    this->exec.on_tick();
+    EXPECT_EQ(this->ahead(id), 5);
+
+    this->book.set_level(Side::ASK, 101, 20);
+    this->exec.on_tick();
+    EXPECT_EQ(this->ahead(id), 5);
+
+    this->book.set_level(Side::ASK, 101, 10);
+    this->exec.on_tick();
+    EXPECT_EQ(this->ahead(id), 2);
+
+    this->book.set_level(Side::ASK, 101, 0);
+    this->exec.on_tick();
+    EXPECT_EQ(this->ahead(id), 0);
+    EXPECT_TRUE(this->fills().empty());
+}
+
+// A print beyond the limit means the whole level traded
+TYPED_TEST(QueueExecutionTest, TradeThroughFillsInFullAtLimit) {
+    const OrderId bid = this->exec.submit({Side::BID, OrderType::LIMIT, 100, 3});
+    const OrderId ask = this->exec.submit({Side::ASK, OrderType::LIMIT, 102, 4});
+
+    this->exec.on_trade(99, 1, true);
+    this->exec.on_trade(103, 1, false);
+    const auto f = this->fills();
+    ASSERT_EQ(f.size(), 2u);
+    EXPECT_EQ(f[0].order_id, bid);
+    EXPECT_EQ(f[0].price, 100);
+    EXPECT_EQ(f[0].qty, 3);
+    EXPECT_EQ(f[1].order_id, ask);
+    EXPECT_EQ(f[1].price, 102);
+    EXPECT_EQ(f[1].qty, 4);
+}
+
+// Our own orders at one level queue in submission order
+TYPED_TEST(QueueExecutionTest, OwnOrdersQueueInSubmissionOrder) {
+    const OrderId first = this->exec.submit({Side::BID, OrderType::LIMIT, 98, 2});
+    const OrderId second = this->exec.submit({Side::BID, OrderType::LIMIT, 98, 2});
+    EXPECT_EQ(this->ahead(first), 0);
+    EXPECT_EQ(this->ahead(second), 0);
+
+    this->exec.on_trade(98, 3, true);
+    const auto f = this->fills();
+    ASSERT_EQ(f.size(), 2u);
+    EXPECT_EQ(f[0].order_id, first);
+    EXPECT_EQ(f[0].qty, 2);
+    EXPECT_EQ(f[1].order_id, second);
+    EXPECT_EQ(f[1].qty, 1);
+
+    // Book volume that joins later queues behind what is left of second,
+    // and a later order of ours behind that
+    this->book.set_level(Side::BID, 98, 7);
+    this->exec.on_tick();
+    EXPECT_EQ(this->ahead(second), 0);
+    const OrderId third = this->exec.submit({Side::BID, OrderType::LIMIT, 98, 1});
+    EXPECT_EQ(this->ahead(third), 7);
+
+    this->exec.on_trade(98, 3, true);
+    const auto g = this->fills();
+    ASSERT_EQ(g.size(), 1u);
+    EXPECT_EQ(g[0].order_id, second);
+    EXPECT_EQ(g[0].qty, 1);
+    EXPECT_EQ(this->ahead(third), 5);
+}
+
+// Market and crossing limit orders take the touch on the next tick
+TYPED_TEST(QueueExecutionTest, TakersFillAtTheTouch) {
+    const OrderId market = this->exec.submit({Side::BID, OrderType::MARKET, 0, 5});
+    const OrderId crossing = this->exec.submit({Side::ASK, OrderType::LIMIT, 99, 2});
+    const OrderId stale = this->exec.submit({Side::BID, OrderType::LIMIT, 101, 1});
+    Quantity q;
+    EXPECT_FALSE(this->exec.queue_ahead(market, q));
+
+    // The ask moves away before the tick: the crossing bid rests instead
+    this->book.set_level(Side::ASK, 101, 0);
+    this->exec.on_tick();
+    const auto f = this->fills();
+    ASSERT_EQ(f.size(), 2u);
+    EXPECT_EQ(f[0].order_id, market);
+    EXPECT_EQ(f[0].price, 102);
+    EXPECT_EQ(f[0].qty, 5);
+    EXPECT_EQ(f[1].order_id, crossing);
+    EXPECT_EQ(f[1].price, 100);
+    EXPECT_EQ(this->ahead(stale), 0);
+    EXPECT_EQ(this->exec.open_orders(), 1u);
+}
+
+// Takers larger than the touch walk the book; a limit stops at its price
+// and rests with the rest
+TYPED_TEST(QueueExecutionTest, TakersSweepDepth) {
+    const OrderId market = this->exec.submit({Side::BID, OrderType::MARKET, 0, 15});
+    const OrderId limit = this->exec.submit({Side::ASK, OrderType::LIMIT, 100, 15});
+    this->exec.on_tick();
+
+    const auto f = this->fills();
+    ASSERT_EQ(f.size(), 3u);
+    EXPECT_EQ(f[0].order_id, market);
+    EXPECT_EQ(f[0].price, 101);
+    EXPECT_EQ(f[0].qty, 10);
+    EXPECT_EQ(f[1].order_id, market);
+    EXPECT_EQ(f[1].price, 102);
+    EXPECT_EQ(f[1].qty, 5);
+    EXPECT_EQ(f[2].order_id, limit);
+    EXPECT_EQ(f[2].price, 100);
+    EXPECT_EQ(f[2].qty, 10);
+    EXPECT_EQ(this->ahead(limit), 0);
+    EXPECT_EQ(this->exec.open_orders(), 1u);
+}
+
+// Liquidity taken by sweeps recovers by the timestamps given
+TYPED_TEST(QueueExecutionTest, DepletionRecoversOverTime) {
+    BasicQueueExecution<TypeParam> exec{this->book, {true, 1000}};
+    auto buy_at = [&](uint64_t t, Quantity qty) {
+        exec.submit({Side::BID, OrderType::MARKET, 0, qty});
+        exec.advance_time(t);
+        exec.on_tick();
+        std::vector<Fill> out;
+        Fill f;
+        while (exec.poll_fill(f)) out.push_back(f);
+        return out;
+    };
+
+    ASSERT_EQ(buy_at(0, 10).size(), 1u);
+    const auto f = buy_at(500, 6);  // half of the 10 taken at 101 is back
+    ASSERT_EQ(f.size(), 2u);
+    EXPECT_EQ(f[0].price, 101);
+    EXPECT_EQ(f[0].qty, 5);
+    EXPECT_EQ(f[1].price, 102);
+    EXPECT_EQ(f[1].qty, 1);
+}
+
+TYPED_TEST(QueueExecutionTest, CancelAndReplace) {
+    const OrderId id = this->exec.submit({Side::BID, OrderType::LIMIT, 100, 3});
+    this->exec.on_trade(100, 4, true);
+    EXPECT_EQ(this->ahead(id), 6);
+
+    this->exec.replace(id, 100, 2);  // shrinking keeps the place
+    EXPECT_EQ(this->ahead(id), 6);
+    this->exec.replace(id, 99, 5);   // reprice goes to the back
+    EXPECT_EQ(this->ahead(id), 20);
+    this->exec.replace(id, 99, 0);
+    this->exec.cancel(id);
+    this->exec.cancel(id);
+    this->exec.on_trade(98, 100, true);
+    EXPECT_TRUE(this->fills().empty());
+
+    const std::vector<OrderEventType> want = {OrderEventType::REPLACED, OrderEventType::REPLACED,
+                                              OrderEventType::REPLACE_REJECTED, OrderEventType::CANCELLED,
+                                              OrderEventType::CANCEL_REJECTED};
+    OrderEvent event;
+    for (OrderEventType type : want) {
+        ASSERT_TRUE(this->exec.poll_event(event));
+        EXPECT_EQ(event.order_id, id);
+        EXPECT_EQ(event.type, type);
+    }
+    EXPECT_FALSE(this->exec.poll_event(event));
+
+    // A cancelled taker never fills
+    const OrderId market = this->exec.submit({Side::ASK, OrderType::MARKET, 0, 1});
+    this->exec.cancel(market);
+    this->exec.on_tick();
+    EXPECT_TRUE(this->fills().empty());
+    EXPECT_EQ(this->exec.open_orders(), 0u);
+}
+
+// Growing an order costs its place: it rejoins behind the level's current
+// volume and behind our own orders already there
+TYPED_TEST(QueueExecutionTest, SizeIncreaseLosesPlace) {
+    const OrderId id = this->exec.submit({Side::BID, OrderType::LIMIT, 100, 1});
+    this->exec.on_trade(100, 4, true);
+    this->book.set_level(Side::BID, 100, 6);
+    this->exec.on_tick();
+    EXPECT_EQ(this->ahead(id), 6);
+
+    const OrderId other = this->exec.submit({Side::BID, OrderType::LIMIT, 100, 1});
+    this->book.set_level(Side::BID, 100, 9);
+    this->exec.on_tick();
+    this->exec.replace(id, 100, 3);
+    EXPECT_EQ(this->ahead(id), 9);
+
+    // Volume at the level now reaches other first
+    this->exec.on_trade(100, 13, true);
+    const auto f = this->fills();
+    ASSERT_EQ(f.size(), 2u);
+    EXPECT_EQ(f[0].order_id, other);
+    EXPECT_EQ(f[0].qty, 1);
+    EXPECT_EQ(f[1].order_id, id);
+    EXPECT_EQ(f[1].qty, 3);
+}
+
+// Random depth, trades and order flow against a shadow of every open
+// order: fills never exceed what is left, respect the limit and stop once
+// an order is cancelled; queues never go negative
+TYPED_TEST(QueueExecutionTest, RandomFlowInvariants) {
+    std::mt19937_64 rng(23);
+    std::uniform_int_distribution<int> level(90, 110);
+    std::map<OrderId, OrderIntent> open;  // qty: left to fill
+    OrderId last_id = 0;
+    size_t fills = 0;
+
+    auto answer = [&](OrderId id) {
+        OrderEvent e;
+        EXPECT_TRUE(this->exec.poll_event(e));
+        EXPECT_EQ(e.order_id, id);
+        return e.type;
+    };
+
+    for (int step = 0; step < 20000; ++step) {
+        const Price p = level(rng);
+        const Side side = p <= 100 ? Side::BID : Side::ASK;
+        const OrderId target = last_id == 0 ? 0 : last_id - rng() % std::min<OrderId>(last_id, 20);
+        switch (rng() % 6) {
+            case 0:
+            case 1:
+                this->book.set_level(side, p, static_cast<Quantity>(rng() % 50));
+                this->exec.on_tick();
+                break;
+            case 2:
+                this->exec.on_trade(p, static_cast<Quantity>(1 + rng() % 20), rng() & 1);
+                break;
+            case 3: {
+                const OrderIntent in{rng() & 1 ? Side::BID : Side::ASK,
+                                     rng() % 8 == 0 ? OrderType::MARKET : OrderType::LIMIT, p,
+                                     static_cast<Quantity>(1 + rng() % 10)};
+                last_id = this->exec.submit(in);
+                open[last_id] = in;
+                break;
+            }
+            case 4:
+                this->exec.cancel(target);
+                if (answer(target) == OrderEventType::CANCELLED) {
+                    ASSERT_EQ(open.erase(target), 1u);
+                } else {
+                    ASSERT_EQ(open.count(target), 0u);
+                }
+                break;
+            default: {
+                const Quantity qty = static_cast<Quantity>(1 + rng() % 10);
+                this->exec.replace(target, p, qty);
+                if (answer(target) == OrderEventType::REPLACED) {
+                    open.at(target).limit_price = p;
+                    open.at(target).qty = qty;
+                }
+            }
+        }
+
+        Fill f;
+        while (this->exec.poll_fill(f)) {
+            ASSERT_EQ(open.count(f.order_id), 1u);
+            OrderIntent& in = open[f.order_id];
+            ASSERT_GT(f.qty, 0);
+            ASSERT_LE(f.qty, in.qty);
+            ASSERT_EQ(f.side, in.side);
+            if (in.type == OrderType::LIMIT) {
+                ASSERT_TRUE(in.side == Side::BID ? f.price <= in.limit_price : f.price >= in.limit_price);
+            }
+            in.qty -= f.qty;
+            if (in.qty == 0) open.erase(f.order_id);
+            ++fills;
+        }
+        ASSERT_EQ(this->exec.open_orders(), open.size());
+        for (const auto& entry : open) {
+            Quantity q;
+            if (this->exec.queue_ahead(entry.first, q)) {
+                ASSERT_GE(q, 0);
+            }
+        }
+    }
+    EXPECT_GT(fills, 500u);
+}
+
+}  // namespace signalforge
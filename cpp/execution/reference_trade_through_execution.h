@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <deque>
+#include "cpp/interfaces/execution_model.h"
+#include "cpp/interfaces/market_view.h"
+
+namespace signalforge {
+
+// The original TradeThroughExecution, which checks every open order on
+// every tick (and searches them on cancel and replace), kept as the behavioural reference: parity tests compare the
+// fills of the two and the execution benchmark measures against it. Not
+// for production use, a tick costs O(open orders) even when nothing fills.
+template <typename View = MarketView>
+class ReferenceTradeThroughExecution final : public ExecutionModel {
+public:
+    explicit ReferenceTradeThroughExecution(const View& mv) : mv_(mv) {}
+
+    OrderId submit(const OrderIntent& intent) override {
+        const OrderId id = ++next_id_;
+        open_.push_back({id, intent});
+        return id;
+    }
+
+    void on_tick() override {
+        if (!mv_.has_last()) return;
+        const Price last_price = mv_.last_price();
+        const bool has_top = mv_.has_top();
+
+        size_t kept = 0;
+        for (size_t i = 0; i < open_.size(); ++i) {
+            const auto& o = open_[i];
+            const auto& in = o.intent;
+
+            if (in.type == OrderType::MARKET) {
+                Price price = last_price;
+                if (has_top) price = in.side == Side::BID ? mv_.best_ask() : mv_.best_bid();
+                fills_.push_back({o.id, in.side, price, in.qty});
+                continue;
+            }
+
+            const bool crossed = in.side == Side::BID
+                ? SideTraits<Side::BID>::crossed_by(in.limit_price, last_price)
+                : SideTraits<Side::ASK>::crossed_by(in.limit_price, last_price);
+            if (crossed) {
+                fills_.push_back({o.id, in.side, last_price, in.qty});
+                continue;
+            }
+
+            if (kept != i) open_[kept] = o;
+            ++kept;
+        }
+        open_.resize(kept);
+    }
+
+    bool poll_fill(Fill& out) override {
+        if (fills_.empty()) return false;
+        out = fills_.front();
+        fills_.pop_front();
+        return true;
+    }
+
+    void cancel(OrderId id) override {
+        const auto it = find(id);
+        if (it == open_.end()) {
+            events_.push_back({id, OrderEventType::CANCEL_REJECTED});
+            return;
+        }
+        open_.erase(it);
+        events_.push_back({id, OrderEventType::CANCELLED});
+    }
+
+    // A new price moves the order to the back, as if just submitted
+    void replace(OrderId id, Price new_price, Quantity new_qty) override {
+        const auto it = find(id);
+        if (it == open_.end() || new_qty <= 0 || it->intent.type == OrderType::MARKET) {
+            events_.push_back({id, OrderEventType::REPLACE_REJECTED});
+            return;
+        }
+        it->intent.qty = new_qty;
+        if (new_price != it->intent.limit_price) {
+            OpenOrder o = *it;
+            o.intent.limit_price = new_price;
+            open_.erase(it);
+            open_.push_back(o);
+        }
+        events_.push_back({id, OrderEventType::REPLACED});
+    }
+
+    bool poll_event(OrderEvent& out) override {
+        if (events_.empty()) return false;
+        out = events_.front();
+        events_.pop_front();
+        return true;
+    }
+
+    size_t open_orders() const { return open_.size(); }
+
+private:
+    struct OpenOrder { OrderId id; OrderIntent intent; };
+
+    typename std::deque<OpenOrder>::iterator find(OrderId id) {
+        return std::find_if(open_.begin(), open_.end(), [id](const OpenOrder& o) { return o.id == id; });
+    }
+
+    const View& mv_;
+    OrderId next_id_ = 0;
+    std::deque<OpenOrder> open_;
+    std::deque<Fill> fills_;
+    std::deque<OrderEvent> events_;
+};
+
+}  // namespace signalforge
@@ -0,0 +1,84 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cpp/orderbook/order_book.h"
+
+namespace signalforge {
+
+// Price index over the resting limit orders of one side of a simulated
+// exchange. Comparator and crossing logic come from SideTraits<S>.
+//
+// Like BookSide, entries are kept in a vector sorted from the worst limit
+// to the best, so the entries a trade reaches are always at the back:
+// checking a tick that fills nothing is one comparison, and a tick that
+// fills k orders pops k entries, whatever the number resting. Most quotes
+// sit near the touch, so inserts land near the back and shift little.
+//
+// An entry names its order by store slot and sequence number; the owner
+// decides whether it is still current. Cancelled or repriced orders are
+// only counted here (retire) and their entries skipped when reached, so
+// cancel and replace never search the index. Once stale entries outnumber
+// live ones they are dropped in one pass.
+template <Side S>
+class RestingLimits {
+public:
+    using Traits = SideTraits<S>;
+
+    struct Entry {
+        Price limit;
+        uint64_t seq;
+        uint32_t slot;
+    };
+
+    // Live orders on this side
+    size_t size() const { return entries_.size() - stale_; }
+
+    void add(Price limit, uint64_t seq, uint32_t slot) {
+        const Entry entry{limit, seq, slot};
+        if (entries_.empty() || !worse(limit, entries_.back().limit)) {
+            entries_.push_back(entry);
+            return;
+        }
+        // After any entries at the same limit
+        auto it = std::upper_bound(entries_.begin(), entries_.end(), limit,
+            [](Price p, const Entry& e) { return worse(p, e.limit); });
+        entries_.insert(it, entry);
+    }
+
+    // One entry no longer names a live order. is_current tells current
+    // entries from stale ones when compacting.
+    template <typename IsCurrent>
+    void retire(IsCurrent is_current) {
+        ++stale_;
+        if (stale_ >= kMinCompact && stale_ * 2 > entries_.size()) {
+            entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                          [&](const Entry& e) { return !is_current(e); }),
+                           entries_.end());
+            stale_ = 0;
+        }
+    }
+
+    // Removes every entry a print at trade_price reaches, best limit first,
+    // calling take(entry) on each. take returns false for a stale entry.
+    template <typename Take>
+    void take_crossed(Price trade_price, Take take) {
+        while (!entries_.empty() && Traits::crossed_by(entries_.back().limit, trade_price)) {
+            const Entry e = entries_.back();
+            entries_.pop_back();
+            if (!take(e)) --stale_;
+        }
+    }
+
+private:
+    // Compacting fewer entries than this is not worth a pass
+    static constexpr size_t kMinCompact = 64;
+
+    static constexpr bool worse(Price a, Price b) { return Traits::better(b, a); }
+
+    std::vector<Entry> entries_;
+    size_t stale_ = 0;  // entries naming cancelled or repriced orders
+};
+
+}  // namespace signalforge
@@ -1,54 +1,94 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
 #include <deque>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
+#include "depth_sweep.h"
+#include "resting_limits.h"
 #include "cpp/interfaces/execution_model.h"
 #include "cpp/interfaces/market_view.h"
 #include <iostream>
 
 namespace signalforge
 {
-    class TradeThroughExecution final : public ExecutionModel
+    // Whether View exposes the live book it quotes from (BookMarketView)
+    template <typename View, typename = void>
+    struct ViewHasBook : std::false_type {};
+    template <typename View>
+    struct ViewHasBook<View, std::void_t<decltype(std::declval<const View&>().book())>> : std::true_type {};
+
+    // Fills resting limits in full when the last trade reaches them, and
+    // market orders on the next tick.
+    //
+    // When the view exposes its book (View is a BookMarketView), market
+    // orders sweep the opposite side level by level, one fill per level at
+    // that level's price; if the side runs dry the rest waits for the next
+    // tick. Limit orders that cross the book when submitted or repriced
+    // sweep it the same way, no deeper than their limit, and the rest rests.
+    // Liquidity taken this way can be held back from later sweeps until it
+    // recovers (DepletionConfig). Otherwise, and when the side to take from
+    // is empty, market orders fill in full at the touch (last price when the
+    // view has no quotes).
+    //
+    // Open orders live in a pooled store, found by id through a hash map,
+    // so cancel and replace are O(1) apart from indexing a new price.
+    // Resting limits are indexed per side by price (RestingLimits), so a
+    // tick only visits the orders it fills. Fills of one tick are queued in
+    // submission order, as if every open order had been checked in turn; a
+    // repriced order counts as submitted when it was repriced.
+    //
+    // View is the market view type. The default goes through the virtual
+    // MarketView interface; instantiating with a final view such as
+    // OrderBookMarketView lets the compiler devirtualize and inline the
+    // per-tick reads.
+    template <typename View = MarketView>
+    class BasicTradeThroughExecution final : public ExecutionModel
     {
     public:
-        explicit TradeThroughExecution(const MarketView& mv) : mv_(mv) {}
+        explicit BasicTradeThroughExecution(const View& mv, DepletionConfig depletion = {})
+            : mv_(mv), sweeper_(depletion) {}
 
         OrderId submit(const OrderIntent& intent) override {
             const OrderId id = ++next_id_;
-            open_.push_back({id, intent});
+            place(allocate(id, intent));
             return id;
         }
 
+        // Depletion recovers by this clock once given; by ticks otherwise
+        void advance_time(uint64_t timestamp) override {
+            timed_ = true;
+            now_ = timestamp;
+        }
+
         void on_tick() override {
             if (!mv_.has_last()) return;
             const Price last_price = mv_.last_price();
+            if constexpr (kSweeps) sweeper_.advance(timed_ ? now_ : ++ticks_);
 
-            std::vector<size_t> to_erase;
-            to_erase.reserve(open_.size());
-
-            for (size_t i =0; i < open_.size(); ++i) {
-                const auto& o = open_[i];
-                const auto& in = o.intent;
-
-                if (in.type == OrderType::MARKET) {
-                    fills_.push_back({o.id, in.side, last_price, in.qty});
-                    to_erase.push_back(i);
-                    continue;
-                }
+            due_.clear();
+            if (!takers_.empty()) fill_takers(last_price);
 
-                //LIMIT order w/ trade through
-                if (in.side == Side::BID && last_price <= in.limit_price) {
-                    fills_.push_back({o.id, in.side, last_price, in.qty});
-                    to_erase.push_back(i);
-                } else if (in.side == Side::ASK && last_price >= in.limit_price) {
-                    fills_.push_back({o.id, in.side, last_price, in.qty});
-                    to_erase.push_back(i);
-                }
+            //LIMIT orders w/ trade through
+            auto take_limit = [&](const auto& e) {
+                if (slots_[e.slot].seq != e.seq) return false;
+                take(e.slot, last_price);
+                return true;
+            };
+            bids_.take_crossed(last_price, take_limit);
+            asks_.take_crossed(last_price, take_limit);
 
-            }
+            // Limits left over from a sweep rest from the next tick on
+            for (uint32_t slot : rests_) rest(slot);
+            rests_.clear();
 
-            for (size_t k = to_erase.size(); k-- > 0;) {
-                open_.erase(open_.begin() + static_cast<long>(to_erase[k]));
+            // Stable, so one order's sweep fills stay best level first
+            if (due_.size() > 1) {
+                std::stable_sort(due_.begin(), due_.end(), [](const Due& a, const Due& b) { return a.seq < b.seq; });
             }
+            for (const Due& d : due_) fills_.push_back(d.fill);
         }
 
         bool poll_fill(Fill& out) override {
@@ -58,12 +98,196 @@ namespace signalforge
             return true;
         }
 
+        void cancel(OrderId id) override {
+            const auto it = ids_.find(id);
+            if (it == ids_.end()) {
+                events_.push_back({id, OrderEventType::CANCEL_REJECTED});
+                return;
+            }
+            const uint32_t slot = it->second;
+            const OrderSlot o = slots_[slot];
+            release(it);
+            if (o.resting) retire(o.side);
+            events_.push_back({id, OrderEventType::CANCELLED});
+        }
+
+        void replace(OrderId id, Price new_price, Quantity new_qty) override {
+            const auto it = ids_.find(id);
+            if (it == ids_.end() || new_qty <= 0 || slots_[it->second].type == OrderType::MARKET) {
+                events_.push_back({id, OrderEventType::REPLACE_REJECTED});
+                return;
+            }
+            const uint32_t slot = it->second;
+            OrderSlot& o = slots_[slot];
+            o.qty = new_qty;
+            if (new_price != o.limit) {
+                // Behind every open order, under a new sequence number that
+                // also marks the old index or taker entry stale
+                o.limit = new_price;
+                o.seq = ++next_seq_;
+                if (o.resting) retire(o.side);
+                o.resting = false;
+                place(slot);
+            }
+            events_.push_back({id, OrderEventType::REPLACED});
+        }
+
+        bool poll_event(OrderEvent& out) override {
+            if (events_.empty()) return false;
+            out = events_.front();
+            events_.pop_front();
+            return true;
+        }
+
+        size_t open_orders() const { return ids_.size(); }
+
     private:
-        struct OpenOrder { OrderId id; OrderIntent intent; };
-        const MarketView& mv_;
+        static constexpr bool kSweeps = ViewHasBook<View>::value;
+
+        // An open order; qty is what is left to fill. seq orders fills
+        // within a tick and is 0 while the slot is free, which invalidates
+        // any index or taker entry left pointing at it. resting: indexed in
+        // bids_ or asks_.
+        struct OrderSlot {
+            OrderId id;
+            uint64_t seq;
+            Side side;
+            OrderType type;
+            Price limit;
+            Quantity qty;
+            bool resting;
+        };
+        struct Taker { uint64_t seq; uint32_t slot; };
+        struct Due { uint64_t seq; Fill fill; };
+
+        uint32_t allocate(OrderId id, const OrderIntent& intent) {
+            uint32_t slot;
+            if (!free_.empty()) {
+                slot = free_.back();
+                free_.pop_back();
+            } else {
+                slot = static_cast<uint32_t>(slots_.size());
+                slots_.emplace_back();
+            }
+            slots_[slot] = {id, ++next_seq_, intent.side, intent.type, intent.limit_price, intent.qty, false};
+            ids_.emplace(id, slot);
+            return slot;
+        }
+
+        void release(typename std::unordered_map<OrderId, uint32_t>::iterator it) {
+            slots_[it->second].seq = 0;
+            free_.push_back(it->second);
+            ids_.erase(it);
+        }
+
+        // New or repriced order: a taker on the next tick, or resting
+        void place(uint32_t slot) {
+            const OrderSlot& o = slots_[slot];
+            if (o.type == OrderType::MARKET || crosses_book(o.side, o.limit)) {
+                takers_.push_back({o.seq, slot});
+            } else {
+                rest(slot);
+            }
+        }
+
+        void rest(uint32_t slot) {
+            OrderSlot& o = slots_[slot];
+            o.resting = true;
+            if (o.side == Side::BID) {
+                bids_.add(o.limit, o.seq, slot);
+            } else {
+                asks_.add(o.limit, o.seq, slot);
+            }
+        }
+
+        bool crosses_book(Side side, Price limit) const {
+            if constexpr (kSweeps) {
+                if (side == Side::BID) {
+                    const Price ask = mv_.book().best_ask();
+                    return ask != 0 && SideTraits<Side::BID>::crossed_by(limit, ask);
+                }
+                const Price bid = mv_.book().best_bid();
+                return bid != 0 && SideTraits<Side::ASK>::crossed_by(limit, bid);
+            } else {
+                (void)side;
+                (void)limit;
+                return false;
+            }
+        }
+
+        void fill_takers(Price last_price) {
+            size_t kept = 0;
+            for (const Taker& t : takers_) {
+                OrderSlot& o = slots_[t.slot];
+                if (o.seq != t.seq) continue;  // cancelled or repriced
+
+                if constexpr (kSweeps) {
+                    const auto& book = mv_.book();
+                    const Price top = o.side == Side::BID ? book.best_ask() : book.best_bid();
+                    if (top != 0) {
+                        const bool is_limit = o.type == OrderType::LIMIT;
+                        o.qty = sweeper_.sweep(book, o.side, o.qty, is_limit, o.limit, [&](Price price, Quantity qty) {
+                            due_.push_back({o.seq, {o.id, o.side, price, qty}});
+                        });
+                        if (o.qty == 0) {
+                            release(ids_.find(o.id));
+                        } else if (is_limit) {
+                            rests_.push_back(t.slot);
+                        } else {
+                            takers_[kept++] = t;  // waits for more liquidity
+                        }
+                        continue;
+                    }
+                    if (o.type == OrderType::LIMIT) {
+                        rests_.push_back(t.slot);
+                        continue;
+                    }
+                }
+
+                // Cross the spread when there are real quotes
+                Price price = last_price;
+                if (mv_.has_top()) price = o.side == Side::BID ? mv_.best_ask() : mv_.best_bid();
+                take(t.slot, price);
+            }
+            takers_.resize(kept);
+        }
+
+        // Fills what is left of the order in slot at price and frees the slot
+        void take(uint32_t slot, Price price) {
+            const OrderSlot& o = slots_[slot];
+            due_.push_back({o.seq, {o.id, o.side, price, o.qty}});
+            release(ids_.find(o.id));
+        }
+
+        // Counts one stale index entry on side, after its slot has moved on
+        void retire(Side side) {
+            auto current = [this](const auto& e) { return slots_[e.slot].seq == e.seq; };
+            if (side == Side::BID) {
+                bids_.retire(current);
+            } else {
+                asks_.retire(current);
+            }
+        }
+
+        const View& mv_;
+        DepthSweeper sweeper_;
+        uint64_t ticks_ = 0;
+        uint64_t now_ = 0;
+        bool timed_ = false;
         OrderId next_id_ = 0;
-        std::deque<OpenOrder> open_;
+        uint64_t next_seq_ = 0;
+        std::vector<OrderSlot> slots_;
+        std::vector<uint32_t> free_;
+        std::unordered_map<OrderId, uint32_t> ids_;
+        std::vector<Taker> takers_;  // market and crossing limit orders
+        std::vector<uint32_t> rests_;  // sweep leftovers to rest after this tick
+        RestingLimits<Side::BID> bids_;
+        RestingLimits<Side::ASK> asks_;
+        std::vector<Due> due_;  // this tick's fills, kept warm
         std::deque<Fill> fills_;
+        std::deque<OrderEvent> events_;
     };
 
+    using TradeThroughExecution = BasicTradeThroughExecution<>;
+
 }  // namespace signalforge
\ No newline at end of file
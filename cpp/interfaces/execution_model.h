@@ -22,17 +22,43 @@ struct Fill {
     Quantity qty;
 };
 
+// Outcome of a cancel or replace request. Rejected requests change
+// nothing; the order is unknown, already filled or cancelled, or the
+// request is invalid (non-positive quantity, replacing a market order).
+enum class OrderEventType { CANCELLED, CANCEL_REJECTED, REPLACED, REPLACE_REJECTED };
+
+struct OrderEvent {
+    OrderId order_id;
+    OrderEventType type;
+};
+
 class ExecutionModel {
 public:
     virtual ~ExecutionModel() = default;
 
     virtual OrderId submit(const OrderIntent& intent) = 0;
 
+    // Moves the model's clock to timestamp (ms, as Trade::timestamp) ahead
+    // of the next on_tick. Models without a notion of time ignore it.
+    virtual void advance_time(uint64_t timestamp) { (void)timestamp; }
+
     // Called on each market update / trade tick depending on mode
     virtual void on_tick() = 0;
 
     // Pull fills deterministically (queue)
     virtual bool poll_fill(Fill& out) = 0;
+
+    // Withdraws an open order. Answered with a CANCELLED or
+    // CANCEL_REJECTED event.
+    virtual void cancel(OrderId id) = 0;
+
+    // Amends an open limit order, keeping its id. Answered with a REPLACED
+    // or REPLACE_REJECTED event. A new price puts the order behind every
+    // order already open, as a fresh submission would be.
+    virtual void replace(OrderId id, Price new_price, Quantity new_qty) = 0;
+
+    // Pull cancel/replace outcomes, in request order (queue)
+    virtual bool poll_event(OrderEvent& out) = 0;
 };
 
 }
@@ -0,0 +1,124 @@
+#include "csv_scanner.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIGNALFORGE_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace signalforge {
+
+namespace {
+
+size_t scan_scalar(const char* data, size_t size, uint32_t* out, size_t from, size_t n) {
+    for (size_t i = from; i < size; ++i) {
+        const char c = data[i];
+        if (c == ',' || c == '\n') out[n++] = static_cast<uint32_t>(i);
+    }
+    return n;
+}
+
+#ifdef SIGNALFORGE_SCAN_X86
+
+// Emit the positions of the set bits of mask, offset by base
+template <typename Mask>
+inline size_t emit(Mask mask, size_t base, uint32_t* out, size_t n) {
+    while (mask != 0) {
+        out[n++] = static_cast<uint32_t>(base + static_cast<size_t>(__builtin_ctzll(mask)));
+        mask &= mask - 1;
+    }
+    return n;
+}
+
+__attribute__((target("sse2")))
+size_t scan_sse2(const char* data, size_t size, uint32_t* out) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, newline));
+        n = emit(static_cast<uint32_t>(_mm_movemask_epi8(hits)), i, out, n);
+    }
+    return scan_scalar(data, size, out, i, n);
+}
+
+__attribute__((target("avx2")))
+size_t scan_avx2(const char* data, size_t size, uint32_t* out) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    size_t n = 0;
+    size_t i = 0;
+    // Two 32-byte compares per 64-byte block, combined into one mask so the
+    // separator loop runs once per block
+    for (; i + 64 <= size; i += 64) {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        const __m256i lo_hits = _mm256_or_si256(_mm256_cmpeq_epi8(lo, comma), _mm256_cmpeq_epi8(lo, newline));
+        const __m256i hi_hits = _mm256_or_si256(_mm256_cmpeq_epi8(hi, comma), _mm256_cmpeq_epi8(hi, newline));
+        const uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(lo_hits)) |
+                              static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi_hits))) << 32;
+        n = emit(mask, i, out, n);
+    }
+    for (; i + 32 <= size; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(block, comma), _mm256_cmpeq_epi8(block, newline));
+        n = emit(static_cast<uint32_t>(_mm256_movemask_epi8(hits)), i, out, n);
+    }
+    return scan_scalar(data, size, out, i, n);
+}
+
+#endif  // SIGNALFORGE_SCAN_X86
+
+}  // namespace
+
+bool scan_isa_supported(ScanIsa isa) {
+    switch (isa) {
+        case ScanIsa::SCALAR:
+            return true;
+#ifdef SIGNALFORGE_SCAN_X86
+        case ScanIsa::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case ScanIsa::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+ScanIsa detect_scan_isa() {
+    static const ScanIsa best = [] {
+        if (scan_isa_supported(ScanIsa::AVX2)) return ScanIsa::AVX2;
+        if (scan_isa_supported(ScanIsa::SSE2)) return ScanIsa::SSE2;
+        return ScanIsa::SCALAR;
+    }();
+    return best;
+}
+
+const char* scan_isa_name(ScanIsa isa) {
+    switch (isa) {
+        case ScanIsa::SSE2: return "sse2";
+        case ScanIsa::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+size_t scan_separators(const char* data, size_t size, uint32_t* out, ScanIsa isa) {
+    // An unsupported isa would fault on its first vector instruction
+    if (!scan_isa_supported(isa)) isa = ScanIsa::SCALAR;
+    switch (isa) {
+#ifdef SIGNALFORGE_SCAN_X86
+        case ScanIsa::SSE2:
+            return scan_sse2(data, size, out);
+        case ScanIsa::AVX2:
+            return scan_avx2(data, size, out);
+#endif
+        default:
+            return scan_scalar(data, size, out, 0, 0);
+    }
+}
+
+}  // namespace signalforge
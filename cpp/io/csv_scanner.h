@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace signalforge {
+
+// Instruction sets the separator scanner can use. SCALAR is always
+// available; the others depend on the CPU the binary runs on.
+enum class ScanIsa : uint8_t {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Best instruction set supported by this CPU, detected once
+ScanIsa detect_scan_isa();
+bool scan_isa_supported(ScanIsa isa);
+const char* scan_isa_name(ScanIsa isa);
+
+// Structural pass for CSV parsing: writes the offset of every ',' and '\n'
+// in [data, data + size) to out, in order, and returns how many it wrote.
+// out must have room for size entries and size must fit in 32 bits. The
+// vector versions compare whole 32/64-byte blocks at once and only branch
+// per separator found, not per byte. An isa this CPU does not support falls
+// back to the scalar scan.
+size_t scan_separators(const char* data, size_t size, uint32_t* out, ScanIsa isa);
+
+}  // namespace signalforge
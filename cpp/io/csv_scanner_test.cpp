@@ -0,0 +1,77 @@
+#include "csv_scanner.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace signalforge {
+
+namespace {
+
+std::vector<uint32_t> scan(const std::string& s, ScanIsa isa) {
+    std::vector<uint32_t> out(s.size());
+    out.resize(scan_separators(s.data(), s.size(), out.data(), isa));
+    return out;
+}
+
+const ScanIsa kAllIsas[] = {ScanIsa::SCALAR, ScanIsa::SSE2, ScanIsa::AVX2};
+
+}  // namespace
+
+TEST(CsvScannerTest, FindsCommasAndNewlines) {
+    const std::string s = "1,42500.50,0.1\n2,x\r\n,,\n";
+    const std::vector<uint32_t> want = {1, 10, 14, 16, 19, 20, 21, 22};
+    for (ScanIsa isa : kAllIsas) {
+        if (!scan_isa_supported(isa)) continue;
+        EXPECT_EQ(scan(s, isa), want) << scan_isa_name(isa);
+    }
+}
+
+TEST(CsvScannerTest, ScalarAlwaysSupported) {
+    EXPECT_TRUE(scan_isa_supported(ScanIsa::SCALAR));
+    EXPECT_TRUE(scan_isa_supported(detect_scan_isa()));
+}
+
+TEST(CsvScannerTest, UnsupportedIsaFallsBackToScalar) {
+    const std::string s = "1,2\n3,4\n";
+    for (ScanIsa isa : kAllIsas) {
+        if (scan_isa_supported(isa)) continue;
+        EXPECT_EQ(scan(s, isa), scan(s, ScanIsa::SCALAR)) << scan_isa_name(isa);
+    }
+    EXPECT_EQ(scan(s, static_cast<ScanIsa>(99)), scan(s, ScanIsa::SCALAR));
+}
+
+TEST(CsvScannerTest, EmptyInput) {
+    for (ScanIsa isa : kAllIsas) {
+        if (!scan_isa_supported(isa)) continue;
+        EXPECT_TRUE(scan("", isa).empty());
+    }
+}
+
+// Every length around the 16/32/64-byte block sizes, random bytes biased
+// towards separators, compared against the scalar scan
+TEST(CsvScannerTest, VectorMatchesScalarOnRandomInput) {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> pick(0, 9);
+
+    for (size_t len = 0; len < 300; ++len) {
+        std::string s(len, '\0');
+        for (char& c : s) {
+            const int k = pick(rng);
+            c = k == 0 ? ',' : k == 1 ? '\n' : static_cast<char>(byte(rng));
+        }
+        // Scan from an unaligned start as well
+        const std::string shifted = "x" + s;
+
+        const auto want = scan(s, ScanIsa::SCALAR);
+        const auto want_shifted = scan(shifted, ScanIsa::SCALAR);
+        for (ScanIsa isa : kAllIsas) {
+            if (!scan_isa_supported(isa)) continue;
+            EXPECT_EQ(scan(s, isa), want) << scan_isa_name(isa) << " len " << len;
+            EXPECT_EQ(scan(shifted, isa), want_shifted) << scan_isa_name(isa) << " len " << len;
+        }
+    }
+}
+
+}  // namespace signalforge
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+namespace signalforge {
+
+// Decimal places kept when exchange prices and quantities are converted to
+// fixed point. Prices match the existing Trade.price ticks (price * 100);
+// quantities keep Binance's full 8 decimals.
+constexpr int kPriceDecimals = 2;
+constexpr int kQtyDecimals = 8;
+
+// Hand-written number parsers for the CSV loaders. They parse a numeric
+// prefix starting at p, advance p past what they consumed and leave the
+// rest of the field to the caller. Leading spaces are skipped. They return
+// false when there are no digits or the value does not fit.
+
+inline bool parse_uint(const char*& p, const char* end, uint64_t& out) {
+    while (p != end && *p == ' ') ++p;
+
+    const char* start = p;
+    uint64_t value = 0;
+    for (; p != end; ++p) {
+        const unsigned digit = static_cast<unsigned char>(*p) - '0';
+        if (digit > 9) break;
+        if (value > (std::numeric_limits<uint64_t>::max() - digit) / 10) return false;
+        value = value * 10 + digit;
+    }
+    if (p == start) return false;
+
+    out = value;
+    return true;
+}
+
+// Converts [-]digits[.digits] straight to value * 10^decimals without going
+// through double. Extra fractional digits round half away from zero; exact
+// is set to false when any of them was non-zero.
+inline bool parse_fixed(const char*& p, const char* end, int decimals, int64_t& out, bool& exact) {
+    while (p != end && *p == ' ') ++p;
+
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    constexpr uint64_t kLimit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    uint64_t value = 0;
+    bool any_digits = false;
+
+    for (; p != end; ++p) {
+        const unsigned digit = static_cast<unsigned char>(*p) - '0';
+        if (digit > 9) break;
+        if (value > (kLimit - digit) / 10) return false;
+        value = value * 10 + digit;
+        any_digits = true;
+    }
+
+    int scale = 0;
+    bool round_up = false;
+    bool dropped = false;
+    if (p != end && *p == '.') {
+        ++p;
+        for (; p != end; ++p) {
+            const unsigned digit = static_cast<unsigned char>(*p) - '0';
+            if (digit > 9) break;
+            any_digits = true;
+            if (scale < decimals) {
+                if (value > (kLimit - digit) / 10) return false;
+                value = value * 10 + digit;
+                ++scale;
+            } else {
+                if (scale == decimals) {
+                    round_up = digit >= 5;
+                    ++scale;  // later digits cannot change half-up rounding
+                }
+                dropped = dropped || digit != 0;
+            }
+        }
+    }
+    if (!any_digits) return false;
+
+    for (; scale < decimals; ++scale) {
+        if (value > kLimit / 10) return false;
+        value *= 10;
+    }
+    if (round_up) {
+        if (value == kLimit) return false;
+        ++value;
+    }
+
+    out = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    exact = !dropped;
+    return true;
+}
+
+inline bool parse_fixed(const char*& p, const char* end, int decimals, int64_t& out) {
+    bool exact;
+    return parse_fixed(p, end, decimals, out, exact);
+}
+
+}  // namespace signalforge
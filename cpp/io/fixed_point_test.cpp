@@ -0,0 +1,106 @@
+#include "fixed_point.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace signalforge {
+
+namespace {
+
+bool fixed(const std::string& s, int decimals, int64_t& out, size_t* consumed = nullptr) {
+    const char* p = s.data();
+    const bool ok = parse_fixed(p, s.data() + s.size(), decimals, out);
+    if (consumed) *consumed = static_cast<size_t>(p - s.data());
+    return ok;
+}
+
+bool uint(const std::string& s, uint64_t& out) {
+    const char* p = s.data();
+    return parse_uint(p, s.data() + s.size(), out);
+}
+
+}  // namespace
+
+TEST(FixedPointTest, PricesToTicks) {
+    int64_t v = 0;
+    ASSERT_TRUE(fixed("42500.50", kPriceDecimals, v));
+    EXPECT_EQ(v, 4250050);
+    ASSERT_TRUE(fixed("0.01", kPriceDecimals, v));
+    EXPECT_EQ(v, 1);
+    ASSERT_TRUE(fixed("100", kPriceDecimals, v));
+    EXPECT_EQ(v, 10000);
+    ASSERT_TRUE(fixed("99999.99", kPriceDecimals, v));
+    EXPECT_EQ(v, 9999999);
+
+    // Binance pads prices to 8 decimals
+    ASSERT_TRUE(fixed("42500.12000000", kPriceDecimals, v));
+    EXPECT_EQ(v, 4250012);
+}
+
+TEST(FixedPointTest, RoundsExtraDigitsHalfUp) {
+    int64_t v = 0;
+    ASSERT_TRUE(fixed("1.234", 2, v));
+    EXPECT_EQ(v, 123);
+    ASSERT_TRUE(fixed("1.235", 2, v));
+    EXPECT_EQ(v, 124);
+    ASSERT_TRUE(fixed("1.2349999", 2, v));
+    EXPECT_EQ(v, 123);
+    ASSERT_TRUE(fixed("-1.235", 2, v));
+    EXPECT_EQ(v, -124);
+}
+
+TEST(FixedPointTest, ReportsDroppedDigits) {
+    const std::string cases[] = {"42500.50000000", "42500.50000001", "1.235", "7"};
+    const bool expected[] = {true, false, false, true};
+    for (size_t i = 0; i < 4; ++i) {
+        const char* p = cases[i].data();
+        int64_t v = 0;
+        bool exact = !expected[i];
+        ASSERT_TRUE(parse_fixed(p, p + cases[i].size(), kPriceDecimals, v, exact));
+        EXPECT_EQ(exact, expected[i]) << cases[i];
+    }
+}
+
+TEST(FixedPointTest, Quantities) {
+    int64_t v = 0;
+    ASSERT_TRUE(fixed("0.00100000", kQtyDecimals, v));
+    EXPECT_EQ(v, 100000);
+    ASSERT_TRUE(fixed("12.5", kQtyDecimals, v));
+    EXPECT_EQ(v, 1250000000);
+}
+
+TEST(FixedPointTest, PrefixSemantics) {
+    int64_t v = 0;
+    size_t consumed = 0;
+    ASSERT_TRUE(fixed(" 12.5,rest", 2, v, &consumed));
+    EXPECT_EQ(v, 1250);
+    EXPECT_EQ(consumed, 5u);
+
+    ASSERT_TRUE(fixed(".5", 2, v));
+    EXPECT_EQ(v, 50);
+    ASSERT_TRUE(fixed("7.", 2, v));
+    EXPECT_EQ(v, 700);
+}
+
+TEST(FixedPointTest, Rejects) {
+    int64_t v = 0;
+    EXPECT_FALSE(fixed("", 2, v));
+    EXPECT_FALSE(fixed("abc", 2, v));
+    EXPECT_FALSE(fixed("-", 2, v));
+    EXPECT_FALSE(fixed(".", 2, v));
+    EXPECT_FALSE(fixed("99999999999999999999", 2, v));
+
+    uint64_t u = 0;
+    EXPECT_FALSE(uint("", u));
+    EXPECT_FALSE(uint("x1", u));
+    EXPECT_FALSE(uint("99999999999999999999999", u));
+}
+
+TEST(FixedPointTest, Integers) {
+    uint64_t u = 0;
+    ASSERT_TRUE(uint("1640000000000", u));
+    EXPECT_EQ(u, 1640000000000u);
+    ASSERT_TRUE(uint("18446744073709551615", u));
+    EXPECT_EQ(u, 18446744073709551615u);
+}
+
+}  // namespace signalforge
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace signalforge {
+
+// Read-only memory mapping of a whole file. Parsers work directly on the
+// mapped bytes instead of copying lines out of a stream.
+class MappedFile {
+public:
+    // Throws std::runtime_error if the file cannot be opened or mapped
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    const char* begin() const { return data_; }
+    const char* end() const { return data_ + size_; }
+
+    // Tell the kernel the mapping will be read front to back
+    void advise_sequential() const;
+    // Tell the kernel reads will jump around, so faults do not read ahead
+    void advise_random() const;
+    // Drop the resident pages wholly before p. They are re-read from the
+    // file if touched again, so streaming readers stay bounded in memory.
+    void release_before(const char* p) const;
+
+private:
+    void unmap();
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace signalforge
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace signalforge {
+
+// Bounded single-producer single-consumer queue. One thread may push and
+// one other thread may pop, without locks: each side owns one index and
+// publishes it with release/acquire, so a popped value is fully visible.
+// Values are moved in and out, which makes it a cheap way to hand whole
+// buffers between a loader thread and its consumer.
+template <typename T>
+class SpscQueue {
+public:
+    // capacity must be at least 1
+    explicit SpscQueue(size_t capacity) : slots_(capacity > 0 ? capacity : 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return slots_.size(); }
+
+    // Producer only. Returns false, leaving value untouched, when full.
+    bool try_push(T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size()) return false;
+        slots_[tail % slots_.size()] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns false when empty.
+    bool try_pop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_.load(std::memory_order_acquire) == head) return false;
+        out = std::move(slots_[head % slots_.size()]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> slots_;
+    alignas(64) std::atomic<size_t> head_{0};  // next slot to pop
+    alignas(64) std::atomic<size_t> tail_{0};  // next slot to push
+};
+
+// Wait strategy for polling a SpscQueue: spin briefly, then yield, then
+// sleep in short steps so a side that waits for long (a loader ahead of a
+// slow consumer) does not burn a core.
+class Backoff {
+public:
+    void pause() {
+        if (step_ < kSpins) {
+            ++step_;
+        } else if (step_ < kSpins + kYields) {
+            ++step_;
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    void reset() { step_ = 0; }
+
+private:
+    static constexpr int kSpins = 64;
+    static constexpr int kYields = 64;
+    int step_ = 0;
+};
+
+}  // namespace signalforge
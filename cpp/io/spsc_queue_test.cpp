@@ -0,0 +1,73 @@
+#include "spsc_queue.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+namespace signalforge {
+
+TEST(SpscQueueTest, FifoWithinCapacity) {
+    SpscQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 3);
+
+    int v = 0;
+    EXPECT_FALSE(queue.try_pop(v));
+
+    for (int i = 1; i <= 3; ++i) {
+        int x = i;
+        EXPECT_TRUE(queue.try_push(x));
+    }
+    int extra = 4;
+    EXPECT_FALSE(queue.try_push(extra));
+    EXPECT_EQ(extra, 4);  // a failed push leaves the value alone
+
+    for (int i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(queue.try_pop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(queue.try_pop(v));
+}
+
+TEST(SpscQueueTest, WrapsAround) {
+    SpscQueue<int> queue(2);
+    int v = 0;
+    for (int i = 0; i < 10; ++i) {
+        int x = i;
+        ASSERT_TRUE(queue.try_push(x));
+        ASSERT_TRUE(queue.try_pop(v));
+        EXPECT_EQ(v, i);
+    }
+}
+
+TEST(SpscQueueTest, MovesBuffers) {
+    SpscQueue<std::unique_ptr<int>> queue(1);
+    auto p = std::make_unique<int>(7);
+    ASSERT_TRUE(queue.try_push(p));
+    EXPECT_EQ(p, nullptr);
+
+    std::unique_ptr<int> out;
+    ASSERT_TRUE(queue.try_pop(out));
+    EXPECT_EQ(*out, 7);
+}
+
+TEST(SpscQueueTest, CrossThreadOrder) {
+    constexpr int kCount = 200000;
+    SpscQueue<int> queue(16);
+
+    std::thread producer([&] {
+        Backoff backoff;
+        for (int i = 0; i < kCount; ++i) {
+            int x = i;
+            while (!queue.try_push(x)) backoff.pause();
+        }
+    });
+
+    Backoff backoff;
+    for (int i = 0; i < kCount; ++i) {
+        int v = -1;
+        while (!queue.try_pop(v)) backoff.pause();
+        ASSERT_EQ(v, i);
+    }
+    producer.join();
+}
+
+}  // namespace signalforge
@@ -0,0 +1,295 @@
+#include "zip_reader.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace signalforge {
+
+namespace {
+
+constexpr uint32_t kEndOfCentralDirectory = 0x06054b50;
+constexpr uint32_t kZip64EndLocator = 0x07064b50;
+constexpr uint32_t kZip64End = 0x06064b50;
+constexpr uint32_t kCentralHeader = 0x02014b50;
+constexpr uint32_t kLocalHeader = 0x04034b50;
+constexpr uint16_t kZip64Extra = 0x0001;
+
+constexpr uint16_t kStored = 0;
+constexpr uint16_t kDeflated = 8;
+
+// How much consumed input the reader lets accumulate before releasing it
+constexpr size_t kReleaseBytes = 4 * 1024 * 1024;
+
+// Little-endian field readers over the mapping, bounds-checked against it
+class Bytes {
+public:
+    Bytes(const MappedFile& file, const std::string& path) : data_(file.data()), size_(file.size()), path_(path) {}
+
+    void need(uint64_t offset, uint64_t len) const {
+        if (offset > size_ || len > size_ - offset) fail("truncated archive");
+    }
+
+    uint16_t u16(uint64_t offset) const { return static_cast<uint16_t>(get(offset, 2)); }
+    uint32_t u32(uint64_t offset) const { return static_cast<uint32_t>(get(offset, 4)); }
+    uint64_t u64(uint64_t offset) const { return get(offset, 8); }
+    uint64_t size() const { return size_; }
+    const char* at(uint64_t offset) const { return data_ + offset; }
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("Bad zip file " + path_ + ": " + what);
+    }
+
+private:
+    uint64_t get(uint64_t offset, int len) const {
+        need(offset, static_cast<uint64_t>(len));
+        uint64_t v = 0;
+        for (int i = len - 1; i >= 0; --i) v = v << 8 | static_cast<unsigned char>(data_[offset + i]);
+        return v;
+    }
+
+    const char* data_;
+    uint64_t size_;
+    const std::string& path_;
+};
+
+struct Entry {
+    std::string name;
+    uint16_t flags = 0;
+    uint16_t method = 0;
+    uint32_t crc = 0;
+    uint64_t compressed_size = 0;
+    uint64_t size = 0;
+    uint64_t local_offset = 0;
+};
+
+// Offset and entry count of the central directory, from the end record
+// (or its ZIP64 form), which sits behind at most a 64 KiB comment
+void find_central_directory(const Bytes& b, uint64_t& offset, uint64_t& entries) {
+    if (b.size() < 22) b.fail("too short");
+    const uint64_t lowest = b.size() > 22 + 0xFFFF ? b.size() - 22 - 0xFFFF : 0;
+    uint64_t end = b.size() - 22;
+    while (b.u32(end) != kEndOfCentralDirectory) {
+        if (end == lowest) b.fail("no end of central directory");
+        --end;
+    }
+
+    entries = b.u16(end + 10);
+    offset = b.u32(end + 16);
+    if (offset == 0xFFFFFFFF || entries == 0xFFFF) {
+        if (end < 20 || b.u32(end - 20) != kZip64EndLocator) b.fail("missing ZIP64 locator");
+        const uint64_t end64 = b.u64(end - 20 + 8);
+        if (b.u32(end64) != kZip64End) b.fail("bad ZIP64 end record");
+        entries = b.u64(end64 + 32);
+        offset = b.u64(end64 + 48);
+    }
+}
+
+// Reads the central directory header at offset, advancing it past the
+// header. 32-bit fields set to all ones are taken from the ZIP64 extra.
+Entry read_central_header(const Bytes& b, uint64_t& offset) {
+    if (b.u32(offset) != kCentralHeader) b.fail("bad central directory header");
+    Entry e;
+    e.flags = b.u16(offset + 8);
+    e.method = b.u16(offset + 10);
+    e.crc = b.u32(offset + 16);
+    e.compressed_size = b.u32(offset + 20);
+    e.size = b.u32(offset + 24);
+    const uint16_t name_len = b.u16(offset + 28);
+    const uint16_t extra_len = b.u16(offset + 30);
+    const uint16_t comment_len = b.u16(offset + 32);
+    e.local_offset = b.u32(offset + 42);
+
+    b.need(offset + 46, name_len);
+    e.name.assign(b.at(offset + 46), name_len);
+
+    uint64_t extra = offset + 46 + name_len;
+    const uint64_t extra_end = extra + extra_len;
+    b.need(extra, extra_len);
+    while (extra + 4 <= extra_end) {
+        const uint16_t id = b.u16(extra);
+        const uint16_t len = b.u16(extra + 2);
+        uint64_t field = extra + 4;
+        if (id == kZip64Extra) {
+            for (uint64_t* value : {&e.size, &e.compressed_size, &e.local_offset}) {
+                if (*value != 0xFFFFFFFF) continue;
+                if (field + 8 > extra + 4 + len) b.fail("short ZIP64 extra field");
+                *value = b.u64(field);
+                field += 8;
+            }
+        }
+        extra += 4 + static_cast<uint64_t>(len);
+    }
+
+    offset = extra_end + comment_len;
+    return e;
+}
+
+bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}  // namespace
+
+ZipEntryReader::ZipEntryReader(const std::string& path) : file_(path) {
+    const Bytes b(file_, path);
+
+    uint64_t offset = 0, entries = 0;
+    find_central_directory(b, offset, entries);
+    if (entries == 0) b.fail("no entries");
+
+    Entry entry;
+    for (uint64_t i = 0; i < entries; ++i) {
+        Entry e = read_central_header(b, offset);
+        if (i == 0 || ends_with(e.name, ".csv")) {
+            const bool csv = ends_with(e.name, ".csv");
+            entry = std::move(e);
+            if (csv) break;
+        }
+    }
+
+    if (entry.flags & 0x1) b.fail("encrypted entry " + entry.name);
+    if (entry.method != kStored && entry.method != kDeflated) {
+        b.fail("unsupported compression method " + std::to_string(entry.method));
+    }
+
+    // The data follows the local header, whose name and extra lengths may
+    // differ from the central directory's
+    const uint64_t local = entry.local_offset;
+    if (b.u32(local) != kLocalHeader) b.fail("bad local header");
+    const uint64_t data = local + 30 + b.u16(local + 26) + b.u16(local + 28);
+    b.need(data, entry.compressed_size);
+
+    name_ = std::move(entry.name);
+    method_ = entry.method;
+    crc_expected_ = entry.crc;
+    size_ = entry.size;
+    compressed_size_ = entry.compressed_size;
+    data_ = reinterpret_cast<const unsigned char*>(b.at(data));
+    released_ = file_.data();
+    crc_ = static_cast<uint32_t>(crc32(0L, Z_NULL, 0));
+
+    if (method_ == kDeflated) {
+        // Raw deflate: zip entries carry no zlib header
+        if (inflateInit2(&zs_, -MAX_WBITS) != Z_OK) b.fail("inflateInit2 failed");
+        inflating_ = true;
+    }
+    file_.advise_sequential();
+}
+
+ZipEntryReader::~ZipEntryReader() {
+    if (inflating_) inflateEnd(&zs_);
+}
+
+size_t ZipEntryReader::read(char* out, size_t cap) {
+    if (done_ || cap == 0) return 0;
+    cap = std::min<size_t>(cap, UINT_MAX);
+
+    size_t n = 0;
+    if (method_ == kStored) {
+        n = static_cast<size_t>(std::min<uint64_t>(cap, compressed_size_ - consumed_));
+        std::memcpy(out, data_ + consumed_, n);
+        consumed_ += n;
+        if (consumed_ == compressed_size_) done_ = true;
+    } else {
+        zs_.next_out = reinterpret_cast<Bytef*>(out);
+        zs_.avail_out = static_cast<uInt>(cap);
+        while (zs_.avail_out > 0) {
+            if (zs_.avail_in == 0) {
+                const uint64_t left = compressed_size_ - consumed_;
+                zs_.next_in = const_cast<Bytef*>(data_ + consumed_);
+                zs_.avail_in = static_cast<uInt>(std::min<uint64_t>(left, UINT_MAX));
+                consumed_ += zs_.avail_in;
+            }
+            const int rc = inflate(&zs_, Z_NO_FLUSH);
+            if (rc == Z_STREAM_END) {
+                done_ = true;
+                break;
+            }
+            if (rc != Z_OK || (zs_.avail_in == 0 && consumed_ == compressed_size_ && zs_.avail_out > 0)) {
+                throw std::runtime_error("Corrupt zip entry " + name_ + ": " +
+                                         (zs_.msg != nullptr ? zs_.msg : "truncated deflate stream"));
+            }
+        }
+        n = cap - zs_.avail_out;
+    }
+
+    crc_ = static_cast<uint32_t>(crc32(crc_, reinterpret_cast<const Bytef*>(out), static_cast<uInt>(n)));
+    produced_ += n;
+
+    const char* in_pos = reinterpret_cast<const char*>(data_ + consumed_) - (inflating_ ? zs_.avail_in : 0);
+    if (static_cast<size_t>(in_pos - released_) >= kReleaseBytes) {
+        file_.release_before(in_pos);
+        released_ = in_pos;
+    }
+
+    if (done_) finish();
+    return n;
+}
+
+void ZipEntryReader::finish() {
+    if (produced_ != size_ || crc_ != crc_expected_) {
+        throw std::runtime_error("Corrupt zip entry " + name_ + ": size or CRC-32 mismatch");
+    }
+}
+
+ZipBlockStream::ZipBlockStream(const std::string& path, size_t block_bytes, size_t depth)
+    : reader_(path),
+      size_(reader_.size()),
+      full_(depth),
+      free_(depth + 2),
+      worker_(&ZipBlockStream::run, this, block_bytes > 0 ? block_bytes : kDefaultBlockBytes) {}
+
+ZipBlockStream::~ZipBlockStream() {
+    stop_.store(true, std::memory_order_relaxed);
+    worker_.join();
+}
+
+void ZipBlockStream::run(size_t block_bytes) {
+    for (;;) {
+        Slot slot;
+        free_.try_pop(slot.data);  // reuse a consumed block when one is back
+        try {
+            slot.data.resize(block_bytes);
+            slot.data.resize(reader_.read(slot.data.data(), block_bytes));
+            slot.end = slot.data.empty();
+        } catch (...) {
+            slot.error = std::current_exception();
+        }
+        const bool last = slot.end || slot.error;
+
+        Backoff backoff;
+        while (!full_.try_push(slot)) {
+            if (stop_.load(std::memory_order_relaxed)) return;
+            backoff.pause();
+        }
+        if (last) return;
+    }
+}
+
+bool ZipBlockStream::next(std::vector<char>& block) {
+    if (block.capacity() > 0) {
+        // Best effort: a full free list just means the worker allocates
+        free_.try_push(block);
+    }
+    block.clear();
+    if (done_) return false;
+
+    Slot slot;
+    Backoff backoff;
+    while (!full_.try_pop(slot)) backoff.pause();
+
+    if (slot.error) {
+        done_ = true;
+        std::rethrow_exception(slot.error);
+    }
+    if (slot.end) {
+        done_ = true;
+        return false;
+    }
+    block = std::move(slot.data);
+    return true;
+}
+
+}  // namespace signalforge
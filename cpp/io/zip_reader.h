@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+#include "mapped_file.h"
+#include "spsc_queue.h"
+
+namespace signalforge {
+
+// Streaming decompressor for one entry of a memory-mapped .zip archive,
+// e.g. the single CSV of a Binance daily trades zip. Stored and deflated
+// entries are supported, with ZIP64 sizes; the CRC-32 and size recorded
+// in the archive are checked once the entry has been read to its end.
+class ZipEntryReader {
+public:
+    // Opens the first entry whose name ends in ".csv", else the first
+    // entry. Throws std::runtime_error if the file cannot be mapped, is
+    // not a zip, or the entry is encrypted or uses another compression.
+    explicit ZipEntryReader(const std::string& path);
+    ~ZipEntryReader();
+
+    ZipEntryReader(const ZipEntryReader&) = delete;
+    ZipEntryReader& operator=(const ZipEntryReader&) = delete;
+
+    const std::string& entry_name() const { return name_; }
+    uint64_t size() const { return size_; }  // uncompressed bytes
+    uint64_t compressed_size() const { return compressed_size_; }
+
+    // Decompresses up to cap bytes into out; returns how many, 0 at the
+    // end of the entry. Throws std::runtime_error on corrupt data.
+    size_t read(char* out, size_t cap);
+
+private:
+    MappedFile file_;
+    std::string name_;
+    uint16_t method_ = 0;
+    uint32_t crc_expected_ = 0;
+    uint64_t size_ = 0;
+    uint64_t compressed_size_ = 0;
+    const unsigned char* data_ = nullptr;  // compressed bytes of the entry
+    uint64_t consumed_ = 0;                // compressed bytes handed to zlib
+    uint64_t produced_ = 0;
+    uint32_t crc_ = 0;
+    const char* released_ = nullptr;
+    bool done_ = false;
+    z_stream zs_{};
+    bool inflating_ = false;
+
+    void finish();
+};
+
+// ZipEntryReader on a worker thread: the entry is decompressed into
+// blocks ahead of the consumer, handed over through a bounded lock-free
+// queue, so inflating the next block overlaps parsing the current one.
+// Consumed blocks go back to the worker for reuse.
+class ZipBlockStream {
+public:
+    static constexpr size_t kDefaultBlockBytes = 1024 * 1024;
+    static constexpr size_t kDefaultDepth = 4;
+
+    // Opens the archive (throwing as ZipEntryReader does) and starts the
+    // worker
+    explicit ZipBlockStream(const std::string& path,
+                            size_t block_bytes = kDefaultBlockBytes,
+                            size_t depth = kDefaultDepth);
+
+    // Stops the worker, dropping blocks not taken yet
+    ~ZipBlockStream();
+
+    ZipBlockStream(const ZipBlockStream&) = delete;
+    ZipBlockStream& operator=(const ZipBlockStream&) = delete;
+
+    uint64_t size() const { return size_; }  // uncompressed bytes
+
+    // Replaces block with the next decompressed bytes, recycling the
+    // block's previous buffer. Returns false, with block empty, after the
+    // last one. Rethrows an error the worker hit.
+    bool next(std::vector<char>& block);
+
+private:
+    struct Slot {
+        std::vector<char> data;
+        std::exception_ptr error;
+        bool end = false;
+    };
+
+    void run(size_t block_bytes);
+
+    ZipEntryReader reader_;
+    uint64_t size_;
+    SpscQueue<Slot> full_;
+    SpscQueue<std::vector<char>> free_;  // consumer to worker
+    std::atomic<bool> stop_{false};
+    bool done_ = false;
+    std::thread worker_;  // last, so it starts after everything above
+};
+
+}  // namespace signalforge
@@ -0,0 +1,142 @@
+#include "zip_reader.h"
+#include "zip_writer.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace signalforge {
+
+class ZipReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "zip_reader_test";
+        std::filesystem::create_directories(test_dir_);
+        path_ = (test_dir_ / "trades.zip").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    // CSV-like text, compressible but not trivially so
+    static std::string sample_text(size_t bytes) {
+        std::mt19937_64 rng(3);
+        std::string text;
+        for (uint64_t id = 0; text.size() < bytes; ++id) {
+            text += std::to_string(id) + "," + std::to_string(42000 + rng() % 1000) + ".00,0.0" +
+                    std::to_string(rng() % 1000) + ",true\n";
+        }
+        text.resize(bytes);
+        return text;
+    }
+
+    static std::string read_all(ZipEntryReader& reader, size_t step) {
+        std::string out;
+        std::vector<char> buf(step);
+        while (size_t n = reader.read(buf.data(), buf.size())) out.append(buf.data(), n);
+        return out;
+    }
+
+    static std::string read_all(ZipBlockStream& stream) {
+        std::string out;
+        std::vector<char> block;
+        while (stream.next(block)) out.append(block.data(), block.size());
+        return out;
+    }
+
+    std::filesystem::path test_dir_;
+    std::string path_;
+};
+
+TEST_F(ZipReaderTest, ReadsDeflatedAndStoredEntries) {
+    const std::string text = sample_text(300000);
+    for (bool deflate : {true, false}) {
+        write_zip(path_, {{"BTCUSDT-trades-2024-01-15.csv", text, deflate}});
+        for (size_t step : {1, 4096, 1 << 20}) {
+            if (step == 1 && deflate) continue;  // too slow to be useful
+            ZipEntryReader reader(path_);
+            EXPECT_EQ(reader.entry_name(), "BTCUSDT-trades-2024-01-15.csv");
+            EXPECT_EQ(reader.size(), text.size());
+            ASSERT_EQ(read_all(reader, step), text) << deflate << " " << step;
+            EXPECT_EQ(reader.read(nullptr, 0), 0);
+        }
+    }
+}
+
+TEST_F(ZipReaderTest, PicksTheCsvEntry) {
+    write_zip(path_, {{"README.txt", "not trades"}, {"trades.csv", "1,2\n"}, {"other.csv", "3,4\n"}});
+    ZipEntryReader reader(path_);
+    EXPECT_EQ(reader.entry_name(), "trades.csv");
+    EXPECT_EQ(read_all(reader, 64), "1,2\n");
+
+    write_zip(path_, {{"a.txt", "first"}, {"b.txt", "second"}});
+    ZipEntryReader first(path_);
+    EXPECT_EQ(read_all(first, 64), "first");
+}
+
+TEST_F(ZipReaderTest, EmptyEntry) {
+    write_zip(path_, {{"empty.csv", "", true}});
+    ZipEntryReader reader(path_);
+    EXPECT_EQ(read_all(reader, 64), "");
+
+    ZipBlockStream stream(path_);
+    EXPECT_EQ(read_all(stream), "");
+}
+
+TEST_F(ZipReaderTest, RejectsBadArchives) {
+    EXPECT_THROW(ZipEntryReader((test_dir_ / "missing.zip").string()), std::runtime_error);
+
+    std::ofstream(path_) << "trade_id,price\n1,2\n";
+    EXPECT_THROW(ZipEntryReader reader(path_), std::runtime_error);
+    EXPECT_THROW(ZipBlockStream stream(path_), std::runtime_error);
+}
+
+TEST_F(ZipReaderTest, DetectsCorruptData) {
+    const std::string text = sample_text(100000);
+    write_zip(path_, {{"trades.csv", text, true}});
+
+    // Flip bytes in the middle of the deflate stream
+    std::string bytes;
+    {
+        std::ifstream in(path_, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    for (size_t i = 0; i < 16; ++i) bytes[bytes.size() / 2 + i] ^= 0x5A;
+    std::ofstream(path_, std::ios::binary | std::ios::trunc) << bytes;
+
+    ZipEntryReader reader(path_);
+    EXPECT_THROW(read_all(reader, 4096), std::runtime_error);
+
+    ZipBlockStream stream(path_);
+    EXPECT_THROW(read_all(stream), std::runtime_error);
+    std::vector<char> block;
+    EXPECT_FALSE(stream.next(block));
+}
+
+TEST_F(ZipReaderTest, BlockStreamMatchesReader) {
+    const std::string text = sample_text(1500000);
+    write_zip(path_, {{"trades.csv", text, true}});
+
+    for (size_t block : {size_t{1000}, size_t{65536}, ZipBlockStream::kDefaultBlockBytes}) {
+        for (size_t depth : {1, 4}) {
+            ZipBlockStream stream(path_, block, depth);
+            EXPECT_EQ(stream.size(), text.size());
+            ASSERT_EQ(read_all(stream), text) << block << " " << depth;
+        }
+    }
+}
+
+TEST_F(ZipReaderTest, BlockStreamStopsEarlyWithoutHanging) {
+    write_zip(path_, {{"trades.csv", sample_text(2000000), true}});
+    {
+        // Worker blocks on the full queue until destruction
+        ZipBlockStream stream(path_, 4096, 1);
+        std::vector<char> block;
+        ASSERT_TRUE(stream.next(block));
+        EXPECT_EQ(block.size(), 4096);
+    }
+    ZipBlockStream untouched(path_, 4096, 1);
+}
+
+}  // namespace signalforge
@@ -0,0 +1,97 @@
+#include "zip_writer.h"
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace signalforge {
+
+namespace {
+
+void put16(std::string& out, uint32_t v) {
+    out.push_back(static_cast<char>(v & 0xFF));
+    out.push_back(static_cast<char>(v >> 8 & 0xFF));
+}
+
+void put32(std::string& out, uint32_t v) {
+    put16(out, v & 0xFFFF);
+    put16(out, v >> 16);
+}
+
+std::string raw_deflate(const std::string& in) {
+    z_stream zs{};
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("deflateInit2 failed");
+    }
+    std::string out(deflateBound(&zs, static_cast<uLong>(in.size())), '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    const int rc = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    if (rc != Z_STREAM_END) throw std::runtime_error("deflate failed");
+    return out;
+}
+
+}  // namespace
+
+void write_zip(const std::string& path, const std::vector<ZipWriterEntry>& entries) {
+    std::string body;
+    std::string directory;
+    for (const ZipWriterEntry& e : entries) {
+        const std::string data = e.deflate ? raw_deflate(e.content) : e.content;
+        const uint32_t crc = static_cast<uint32_t>(
+            crc32(0L, reinterpret_cast<const Bytef*>(e.content.data()), static_cast<uInt>(e.content.size())));
+        const uint32_t offset = static_cast<uint32_t>(body.size());
+        const uint32_t method = e.deflate ? 8 : 0;
+
+        put32(body, 0x04034b50);
+        put16(body, 20);  // version needed
+        put16(body, 0);   // flags
+        put16(body, method);
+        put32(body, 0);   // mod time and date
+        put32(body, crc);
+        put32(body, static_cast<uint32_t>(data.size()));
+        put32(body, static_cast<uint32_t>(e.content.size()));
+        put16(body, static_cast<uint32_t>(e.name.size()));
+        put16(body, 0);   // extra length
+        body += e.name;
+        body += data;
+
+        put32(directory, 0x02014b50);
+        put16(directory, 20);  // version made by
+        put16(directory, 20);
+        put16(directory, 0);
+        put16(directory, method);
+        put32(directory, 0);
+        put32(directory, crc);
+        put32(directory, static_cast<uint32_t>(data.size()));
+        put32(directory, static_cast<uint32_t>(e.content.size()));
+        put16(directory, static_cast<uint32_t>(e.name.size()));
+        put16(directory, 0);   // extra length
+        put16(directory, 0);   // comment length
+        put16(directory, 0);   // disk
+        put16(directory, 0);   // internal attributes
+        put32(directory, 0);   // external attributes
+        put32(directory, offset);
+        directory += e.name;
+    }
+
+    std::string end;
+    put32(end, 0x06054b50);
+    put16(end, 0);
+    put16(end, 0);
+    put16(end, static_cast<uint32_t>(entries.size()));
+    put16(end, static_cast<uint32_t>(entries.size()));
+    put32(end, static_cast<uint32_t>(directory.size()));
+    put32(end, static_cast<uint32_t>(body.size()));
+    put16(end, 0);  // comment length
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << body << directory << end;
+    if (!file) throw std::runtime_error("Failed to write zip: " + path);
+}
+
+}  // namespace signalforge
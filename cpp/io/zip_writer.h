@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace signalforge {
+
+// Minimal .zip writer for tests and benchmarks, producing archives laid
+// out like Binance's: local headers, data, then the central directory.
+// No ZIP64, so entries must stay under 4 GiB.
+struct ZipWriterEntry {
+    std::string name;
+    std::string content;
+    bool deflate = true;  // false: stored
+};
+
+// Throws std::runtime_error if the file cannot be written
+void write_zip(const std::string& path, const std::vector<ZipWriterEntry>& entries);
+
+}  // namespace signalforge
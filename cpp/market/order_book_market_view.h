@@ -0,0 +1,42 @@
+#pragma once
+#include "cpp/interfaces/market_view.h"
+#include "cpp/orderbook/flat_order_book.h"
+#include "cpp/orderbook/order_book.h"
+
+namespace signalforge {
+
+// L2 market view: quotes come from a live book, last price from the trade
+// tape. The book is not owned; the replay loop keeps mutating it.
+//
+// The class is final and its methods are inline, so execution models that
+// hold the concrete type (see BasicTradeThroughExecution) call them
+// without virtual dispatch.
+template <typename Book>
+class BookMarketView final : public MarketView {
+public:
+    explicit BookMarketView(const Book& book) : book_(book) {}
+
+    void on_trade(Price p) { last_ = p; has_last_ = true; }
+
+    bool has_top() const override { return book_.best_bid() != 0 && book_.best_ask() != 0; }
+    Price best_bid() const override { return book_.best_bid(); }
+    Price best_ask() const override { return book_.best_ask(); }
+
+    bool has_last() const override { return has_last_; }
+    Price last_price() const override { return last_; }
+
+    // Changes whenever the top of the book moves; see OrderBook::top_version()
+    uint64_t top_version() const { return book_.top_version(); }
+
+    const Book& book() const { return book_; }
+
+private:
+    const Book& book_;
+    bool has_last_ = false;
+    Price last_ = 0;
+};
+
+using OrderBookMarketView = BookMarketView<OrderBook>;
+using FlatOrderBookMarketView = BookMarketView<FlatOrderBook>;
+
+}
@@ -0,0 +1,256 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "order_book.h"
+
+namespace signalforge {
+
+// One side of a FlatOrderBook. Comparator and best-price logic come from
+// SideTraits<S>, so each side compiles to straight-line code with no
+// runtime Side checks.
+//
+// Levels are kept in a vector sorted worst -> best, so the best level is the
+// back element and updates near the top only shift a few entries. Running
+// totals of quantity and notional from the top are cached for the depth
+// queries and invalidated from the shallowest level a mutation touches.
+template <Side S>
+class BookSide {
+public:
+    using Traits = SideTraits<S>;
+
+    explicit BookSide(size_t reserve_levels = 1024) {
+        levels_.reserve(reserve_levels);
+        merged_.reserve(reserve_levels);
+        depth_.reserve(reserve_levels);
+    }
+
+    bool empty() const { return levels_.empty(); }
+    size_t size() const { return levels_.size(); }
+    Price best() const { return levels_.empty() ? 0 : levels_.back().price; }
+
+    Quantity qty(Price price) const {
+        const size_t i = lower_index(price);
+        return (i < levels_.size() && levels_[i].price == price) ? levels_[i].qty : 0;
+    }
+
+    // The mutators return true when the best price changed
+
+    bool set(Price price, Quantity qty) {
+        auto it = slot(price);
+        const bool found = it != levels_.end() && it->price == price;
+
+        if (qty <= 0) {
+            if (!found) return false;
+            const size_t depth = depth_of(it);
+            levels_.erase(it);
+            invalidate(depth);
+            return depth == 0;
+        }
+        if (found) {
+            it->qty = qty;
+            invalidate(depth_of(it));
+            return false;
+        }
+        return insert(it, price, qty);
+    }
+
+    bool add(Price price, Quantity delta) {
+        auto it = slot(price);
+        if (it != levels_.end() && it->price == price) {
+            it->qty += delta;
+            invalidate(depth_of(it));
+            return false;
+        }
+        return insert(it, price, delta);
+    }
+
+    bool remove(Price price, Quantity delta) {
+        auto it = slot(price);
+        if (it == levels_.end() || it->price != price) return false;
+
+        const size_t depth = depth_of(it);
+        invalidate(depth);
+        it->qty -= delta;
+        if (it->qty > 0) return false;
+
+        levels_.erase(it);
+        return depth == 0;
+    }
+
+    void clear() {
+        levels_.clear();
+        invalidate(0);
+    }
+
+    // Replaces the side from best-first input. Falls back to per-level
+    // inserts if the input is not strictly best first.
+    void assign(const std::vector<Level>& best_first) {
+        levels_.clear();
+        invalidate(0);
+        for (auto it = best_first.rbegin(); it != best_first.rend(); ++it) {
+            if (it->qty <= 0) continue;
+            if (!levels_.empty() && !worse(levels_.back().price, it->price)) {
+                levels_.clear();
+                for (const Level& l : best_first) set(l.price, l.qty);
+                return;
+            }
+            levels_.push_back(*it);
+        }
+    }
+
+    // Applies absolute updates in order. Large strictly best-first batches
+    // are merged in one linear pass; anything else goes level by level.
+    void apply(const std::vector<Level>& updates, bool best_first) {
+        invalidate(0);
+        if (best_first && updates.size() * kMergeRatio >= levels_.size()) {
+            merge(updates);
+            return;
+        }
+        for (const Level& u : updates) set(u.price, u.qty);
+    }
+
+    // depth queries, see OrderBook
+
+    size_t top_levels(Level* out, size_t n) const {
+        const size_t count = std::min(n, levels_.size());
+        std::copy(levels_.rbegin(), levels_.rbegin() + static_cast<std::ptrdiff_t>(count), out);
+        return count;
+    }
+
+    Quantity depth_within(Price ticks) const {
+        if (ticks < 0 || levels_.empty()) return 0;
+        const size_t count = levels_.size() - lower_index(Traits::behind(best(), ticks));
+        return extend(count)[count - 1].qty;
+    }
+
+    SweepCost sweep_cost(Quantity qty) const {
+        if (qty <= 0 || levels_.empty()) return {};
+
+        // Grow the cache only as deep as this size reaches
+        const DepthSum* sums = extend(1);
+        while (depth_valid_ < levels_.size() && sums[depth_valid_ - 1].qty < qty) {
+            sums = extend(depth_valid_ + 1);
+        }
+
+        // First level whose running total covers qty
+        const DepthSum* end = sums + depth_valid_;
+        const DepthSum* hit = std::lower_bound(sums, end, qty,
+            [](const DepthSum& s, Quantity q) { return s.qty < q; });
+
+        SweepCost cost;
+        if (hit == end) {
+            cost.filled = end[-1].qty;
+            cost.notional = end[-1].notional;
+            cost.worst_price = levels_.front().price;
+            return cost;
+        }
+
+        const size_t k = static_cast<size_t>(hit - sums);
+        const Level& last = levels_[levels_.size() - 1 - k];
+        const DepthSum before = k > 0 ? sums[k - 1] : DepthSum{0, 0.0};
+        cost.filled = qty;
+        cost.notional = before.notional + static_cast<double>(last.price) * static_cast<double>(qty - before.qty);
+        cost.worst_price = last.price;
+        return cost;
+    }
+
+private:
+    // Running totals over the best k+1 levels
+    struct DepthSum {
+        Quantity qty;
+        double notional;
+    };
+
+    // Levels near the top are probed linearly before falling back to a
+    // binary search over the rest of the side.
+    static constexpr size_t kLinearProbe = 8;
+    // Below this ratio of updates to resting levels, individual inserts
+    // move less memory than a full merge.
+    static constexpr size_t kMergeRatio = 16;
+
+    static constexpr bool worse(Price a, Price b) { return Traits::better(b, a); }
+
+    // Index of the first level not worse than price, i.e. where price
+    // lives or would be inserted.
+    size_t lower_index(Price price) const {
+        // Most updates land near the top of the book, which lives at the back.
+        size_t i = levels_.size();
+        const size_t stop = i > kLinearProbe ? i - kLinearProbe : 0;
+        while (i > stop && !worse(levels_[i - 1].price, price)) {
+            --i;
+        }
+        if (i > stop || stop == 0) return i;
+
+        // Branchless lower_bound over [0, stop)
+        const Level* base = levels_.data();
+        size_t len = stop;
+        while (len > 1) {
+            const size_t half = len / 2;
+            base = worse(base[half - 1].price, price) ? base + half : base;
+            len -= half;
+        }
+        return static_cast<size_t>(base - levels_.data()) + (worse(base->price, price) ? 1 : 0);
+    }
+
+    typename std::vector<Level>::iterator slot(Price price) {
+        return levels_.begin() + static_cast<std::ptrdiff_t>(lower_index(price));
+    }
+
+    size_t depth_of(typename std::vector<Level>::const_iterator it) const {
+        return static_cast<size_t>(levels_.end() - it) - 1;
+    }
+
+    bool insert(typename std::vector<Level>::iterator it, Price price, Quantity qty) {
+        const bool new_best = it == levels_.end();
+        it = levels_.insert(it, Level{price, qty});
+        invalidate(depth_of(it));
+        return new_best;
+    }
+
+    void merge(const std::vector<Level>& updates) {
+        merged_.clear();
+        auto l = levels_.begin();
+        auto u = updates.rbegin();  // worst first, like levels_
+
+        while (l != levels_.end() && u != updates.rend()) {
+            if (worse(l->price, u->price)) {
+                merged_.push_back(*l++);
+            } else {
+                if (l->price == u->price) ++l;
+                if (u->qty > 0) merged_.push_back(*u);
+                ++u;
+            }
+        }
+        merged_.insert(merged_.end(), l, levels_.end());
+        for (; u != updates.rend(); ++u) {
+            if (u->qty > 0) merged_.push_back(*u);
+        }
+        levels_.swap(merged_);
+    }
+
+    void invalidate(size_t depth) {
+        if (depth < depth_valid_) depth_valid_ = depth;
+    }
+
+    const DepthSum* extend(size_t count) const {
+        if (depth_.size() < levels_.size()) depth_.resize(levels_.size());
+        for (; depth_valid_ < count; ++depth_valid_) {
+            const Level& l = levels_[levels_.size() - 1 - depth_valid_];
+            const DepthSum prev = depth_valid_ > 0 ? depth_[depth_valid_ - 1] : DepthSum{0, 0.0};
+            depth_[depth_valid_] = {prev.qty + l.qty,
+                                    prev.notional + static_cast<double>(l.price) * static_cast<double>(l.qty)};
+        }
+        return depth_.data();
+    }
+
+    std::vector<Level> levels_;
+    std::vector<Level> merged_;  // scratch for merge(), kept warm
+
+    // Depth cache; mutable so the const queries can extend it. This makes
+    // the queries unsafe to call concurrently on one book.
+    mutable std::vector<DepthSum> depth_;
+    mutable size_t depth_valid_ = 0;  // depth_[0, depth_valid_) is current
+};
+
+} // namespace signalforge
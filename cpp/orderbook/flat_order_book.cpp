@@ -0,0 +1,92 @@
+#include "flat_order_book.h"
+
+namespace signalforge {
+
+FlatOrderBook::FlatOrderBook(size_t reserve_levels)
+    : bids_(reserve_levels),
+      asks_(reserve_levels) {}
+
+void FlatOrderBook::clear() {
+    if (!bids_.empty() || !asks_.empty()) {
+        ++top_version_;
+    }
+    bids_.clear();
+    asks_.clear();
+}
+
+void FlatOrderBook::set_level(Side side, Price price, Quantity qty) {
+    if (side == Side::BID) {
+        set_level<Side::BID>(price, qty);
+    } else {
+        set_level<Side::ASK>(price, qty);
+    }
+}
+
+void FlatOrderBook::add_level(Side side, Price price, Quantity delta) {
+    if (side == Side::BID) {
+        add_level<Side::BID>(price, delta);
+    } else {
+        add_level<Side::ASK>(price, delta);
+    }
+}
+
+void FlatOrderBook::remove_level(Side side, Price price, Quantity delta) {
+    if (side == Side::BID) {
+        remove_level<Side::BID>(price, delta);
+    } else {
+        remove_level<Side::ASK>(price, delta);
+    }
+}
+
+void FlatOrderBook::apply_snapshot(const std::vector<Level>& bids, const std::vector<Level>& asks) {
+    const Price bid = best_bid();
+    const Price ask = best_ask();
+
+    bids_.assign(bids);
+    asks_.assign(asks);
+
+    if (best_bid() != bid || best_ask() != ask) ++top_version_;
+}
+
+void FlatOrderBook::apply_deltas(const Delta* deltas, size_t count) {
+    const Price bid = best_bid();
+    const Price ask = best_ask();
+
+    // Split by side, noting whether each side arrived strictly best first
+    bid_batch_.clear();
+    ask_batch_.clear();
+    bool bids_sorted = true;
+    bool asks_sorted = true;
+    for (const Delta* d = deltas; d != deltas + count; ++d) {
+        if (d->side == Side::BID) {
+            bids_sorted = bids_sorted && (bid_batch_.empty() || d->price < bid_batch_.back().price);
+            bid_batch_.push_back({d->price, d->qty});
+        } else {
+            asks_sorted = asks_sorted && (ask_batch_.empty() || d->price > ask_batch_.back().price);
+            ask_batch_.push_back({d->price, d->qty});
+        }
+    }
+
+    bids_.apply(bid_batch_, bids_sorted);
+    asks_.apply(ask_batch_, asks_sorted);
+
+    if (best_bid() != bid || best_ask() != ask) ++top_version_;
+}
+
+Quantity FlatOrderBook::level_qty(Side side, Price price) const {
+    return side == Side::BID ? bids_.qty(price) : asks_.qty(price);
+}
+
+size_t FlatOrderBook::top_levels(Side side, Level* out, size_t n) const {
+    return side == Side::BID ? bids_.top_levels(out, n) : asks_.top_levels(out, n);
+}
+
+Quantity FlatOrderBook::depth_within(Side side, Price ticks) const {
+    return side == Side::BID ? bids_.depth_within(ticks) : asks_.depth_within(ticks);
+}
+
+SweepCost FlatOrderBook::sweep_cost(Side book_side, Quantity qty) const {
+    return book_side == Side::BID ? bids_.sweep_cost(qty) : asks_.sweep_cost(qty);
+}
+
+} // namespace signalforge
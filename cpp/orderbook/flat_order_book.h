@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "book_side.h"
+#include "order_book.h"
+
+namespace signalforge {
+
+// Contiguous alternative to OrderBook with the same API.
+//
+// Each side is a BookSide: a vector of levels sorted from worst to best
+// price, so best_bid()/best_ask() are O(1) and updates near the top of the
+// book only shift a handful of entries. Capacity is kept across clear(), so
+// a warmed-up book does not allocate.
+class FlatOrderBook {
+public:
+    explicit FlatOrderBook(size_t reserve_levels = 1024);
+
+    // snapshot semantics
+    void clear();
+    void set_level(Side side, Price price, Quantity qty);
+
+    // delta semantics
+    void add_level(Side side, Price price, Quantity qty);
+    void remove_level(Side side, Price price, Quantity qty);
+
+    // Statically dispatched versions of the mutators. Header-only so replay
+    // loops that know the side can inline straight into BookSide.
+    template <Side S>
+    void set_level(Price price, Quantity qty) {
+        if (mutable_side<S>().set(price, qty)) ++top_version_;
+    }
+
+    template <Side S>
+    void add_level(Price price, Quantity qty) {
+        if (qty > 0 && mutable_side<S>().add(price, qty)) ++top_version_;
+    }
+
+    template <Side S>
+    void remove_level(Price price, Quantity qty) {
+        if (qty > 0 && mutable_side<S>().remove(price, qty)) ++top_version_;
+    }
+
+    // batch semantics, see OrderBook. Large best-first delta batches are
+    // merged into each side in one linear pass.
+    void apply_snapshot(const std::vector<Level>& bids, const std::vector<Level>& asks);
+    void apply_deltas(const Delta* deltas, size_t count);
+    void apply_deltas(const std::vector<Delta>& deltas) { apply_deltas(deltas.data(), deltas.size()); }
+
+    // query methods
+    Price best_bid() const { return bids_.best(); }
+    Price best_ask() const { return asks_.best(); }
+
+    Quantity level_qty(Side side, Price price) const;
+
+    // depth queries, see OrderBook. Cumulative depth from the top of each
+    // side is cached and only rebuilt below the shallowest level touched
+    // since the last query, so repeated queries are O(log n). The cache
+    // makes these const methods unsafe to call concurrently.
+    size_t top_levels(Side side, Level* out, size_t n) const;
+    Quantity depth_within(Side side, Price ticks) const;
+    SweepCost sweep_cost(Side book_side, Quantity qty) const;
+
+    // Bumped whenever best_bid() or best_ask() changes
+    uint64_t top_version() const { return top_version_; }
+
+    template <Side S>
+    const BookSide<S>& side() const {
+        if constexpr (S == Side::BID) {
+            return bids_;
+        } else {
+            return asks_;
+        }
+    }
+
+private:
+    template <Side S>
+    BookSide<S>& mutable_side() {
+        if constexpr (S == Side::BID) {
+            return bids_;
+        } else {
+            return asks_;
+        }
+    }
+
+    BookSide<Side::BID> bids_;
+    BookSide<Side::ASK> asks_;
+    uint64_t top_version_ = 0;
+
+    // Reused by apply_deltas() so it does not allocate once warm
+    std::vector<Level> bid_batch_;
+    std::vector<Level> ask_batch_;
+};
+
+} // namespace signalforge
@@ -1,76 +1,184 @@
 #include "order_book.h"
+#include <algorithm>
 
 namespace signalforge {
 
+namespace {
+
+// Both maps iterate best first, so top_levels is shared
+
+template <typename Map>
+size_t copy_top(const Map& levels, Level* out, size_t n) {
+    size_t count = 0;
+    for (auto it = levels.begin(); it != levels.end() && count < n; ++it) {
+        out[count++] = {it->first, it->second};
+    }
+    return count;
+}
+
+} // namespace
+
 OrderBook::OrderBook()
     : best_bid_(0),
-      best_ask_(0) {}
+      best_ask_(0),
+      top_version_(0) {}
 
 
 void OrderBook::clear() {
+    if (!bids_.empty() || !asks_.empty()) {
+        ++top_version_;
+    }
     bids_.clear();
     asks_.clear();
+    bid_depth_.clear();
+    ask_depth_.clear();
     best_bid_ = 0;
     best_ask_ = 0;
 }
 
+template <Side S, typename More>
+const std::vector<OrderBook::DepthSum>& OrderBook::extend_depth(More more) const {
+    const auto& side = levels<S>();
+    auto& sums = depth<S>();
+    auto it = sums.empty() ? side.begin() : side.upper_bound(sums.back().price);
+    for (; it != side.end() && more(sums); ++it) {
+        const DepthSum prev = sums.empty() ? DepthSum{0, 0, 0.0} : sums.back();
+        sums.push_back({it->first, prev.qty + it->second,
+                        prev.notional + static_cast<double>(it->first) * static_cast<double>(it->second)});
+    }
+    return sums;
+}
+
 void OrderBook::set_level(Side side, Price price, Quantity qty) {
     if (side == Side::BID) {
-        if (qty <= 0) {
-            bids_.erase(price);
-        } else {
-            bids_[price] = qty;
-        }
+        set_level<Side::BID>(price, qty);
     } else {
-        if (qty <= 0) {
-            asks_.erase(price);
-        } else {
-            asks_[price] = qty;
-        }
+        set_level<Side::ASK>(price, qty);
     }
-
-    update_best_levels();
 }
 
 void OrderBook::add_level(Side side, Price price, Quantity delta) {
-    if (delta <= 0) return;
+    if (side == Side::BID) {
+        add_level<Side::BID>(price, delta);
+    } else {
+        add_level<Side::ASK>(price, delta);
+    }
+}
 
+void OrderBook::remove_level(Side side, Price price, Quantity delta) {
     if (side == Side::BID) {
-        bids_[price] += delta;
+        remove_level<Side::BID>(price, delta);
     } else {
-        asks_[price] += delta;
+        remove_level<Side::ASK>(price, delta);
+    }
+}
+
+void OrderBook::apply_snapshot(const std::vector<Level>& bids, const std::vector<Level>& asks) {
+    bids_.clear();
+    asks_.clear();
+    bid_depth_.clear();
+    ask_depth_.clear();
+
+    // Best-first input always appends at the end of the map, so the hint
+    // makes every insert amortized O(1).
+    for (const Level& l : bids) {
+        if (l.qty > 0) bids_.insert_or_assign(bids_.end(), l.price, l.qty);
+    }
+    for (const Level& l : asks) {
+        if (l.qty > 0) asks_.insert_or_assign(asks_.end(), l.price, l.qty);
     }
 
     update_best_levels();
 }
 
-void OrderBook::remove_level(Side side, Price price, Quantity delta) {
-    if (delta <= 0) return;
-
-    if (side == Side::BID) {
-        auto it = bids_.find(price);
-        if (it != bids_.end()) {
-            it->second -= delta;
-            if (it->second <= 0) {
-                bids_.erase(it);
-            }
+void OrderBook::apply_deltas(const Delta* deltas, size_t count) {
+    // Count each side's deltas, noting whether they arrived strictly best
+    // first
+    bool bids_sorted = true;
+    bool asks_sorted = true;
+    size_t bid_count = 0;
+    size_t ask_count = 0;
+    Price last_bid = 0;
+    Price last_ask = 0;
+    for (const Delta* d = deltas; d != deltas + count; ++d) {
+        if (d->side == Side::BID) {
+            bids_sorted = bids_sorted && (bid_count == 0 || d->price < last_bid);
+            last_bid = d->price;
+            ++bid_count;
+        } else {
+            asks_sorted = asks_sorted && (ask_count == 0 || d->price > last_ask);
+            last_ask = d->price;
+            ++ask_count;
         }
+    }
+
+    if (bids_sorted && bid_count * kHintRatio >= bids_.size()) {
+        apply_sorted<Side::BID>(deltas, count);
     } else {
-        auto it = asks_.find(price);
-        if (it != asks_.end()) {
-            it->second -= delta;
-            if (it->second <= 0) {
-                asks_.erase(it);
+        apply_each<Side::BID>(deltas, count);
+    }
+    if (asks_sorted && ask_count * kHintRatio >= asks_.size()) {
+        apply_sorted<Side::ASK>(deltas, count);
+    } else {
+        apply_each<Side::ASK>(deltas, count);
+    }
+
+    update_best_levels();
+}
+
+template <Side S>
+void OrderBook::apply_sorted(const Delta* deltas, size_t count) {
+    auto& side = levels<S>();
+    const auto better = side.key_comp();
+    auto it = side.begin();
+    for (const Delta* d = deltas; d != deltas + count; ++d) {
+        if (d->side != S) continue;
+
+        // Each delta lies at or behind the last one: step forward from
+        // there, and only search the tree when it is further away
+        size_t steps = 0;
+        while (it != side.end() && better(it->first, d->price)) {
+            if (++steps > kHintProbe) {
+                it = side.lower_bound(d->price);
+                break;
             }
+            ++it;
+        }
+
+        invalidate<S>(d->price);
+        const bool found = it != side.end() && it->first == d->price;
+        if (d->qty <= 0) {
+            if (found) it = side.erase(it);
+        } else if (found) {
+            it->second = d->qty;
+        } else {
+            it = side.emplace_hint(it, d->price, d->qty);
         }
     }
+}
 
-    update_best_levels();
+template <Side S>
+void OrderBook::apply_each(const Delta* deltas, size_t count) {
+    auto& side = levels<S>();
+    for (const Delta* d = deltas; d != deltas + count; ++d) {
+        if (d->side != S) continue;
+        invalidate<S>(d->price);
+        if (d->qty <= 0) {
+            side.erase(d->price);
+        } else {
+            side.insert_or_assign(d->price, d->qty);
+        }
+    }
 }
 
 void OrderBook::update_best_levels() {
-    best_bid_ = bids_.empty() ? 0 : bids_.begin()->first;
-    best_ask_ = asks_.empty() ? 0 : asks_.begin()->first;
+    const Price bid = bids_.empty() ? 0 : bids_.begin()->first;
+    const Price ask = asks_.empty() ? 0 : asks_.begin()->first;
+    if (bid != best_bid_ || ask != best_ask_) {
+        best_bid_ = bid;
+        best_ask_ = ask;
+        ++top_version_;
+    }
 }
 
 Price OrderBook::best_bid() const {
@@ -81,4 +189,65 @@ Price OrderBook::best_ask() const {
     return best_ask_;
 }
 
-} 
+Quantity OrderBook::level_qty(Side side, Price price) const {
+    if (side == Side::BID) {
+        auto it = bids_.find(price);
+        return it == bids_.end() ? 0 : it->second;
+    }
+    auto it = asks_.find(price);
+    return it == asks_.end() ? 0 : it->second;
+}
+
+size_t OrderBook::top_levels(Side side, Level* out, size_t n) const {
+    return side == Side::BID ? copy_top(bids_, out, n) : copy_top(asks_, out, n);
+}
+
+template <Side S>
+Quantity OrderBook::side_depth_within(Price ticks) const {
+    const auto& side = levels<S>();
+    if (ticks < 0 || side.empty()) return 0;
+
+    // Cache through the first level past the limit, then count up to it
+    const Price limit = SideTraits<S>::behind(side.begin()->first, ticks);
+    auto within = [limit](const DepthSum& e) { return !SideTraits<S>::better(limit, e.price); };
+    const auto& sums = extend_depth<S>([&](const std::vector<DepthSum>& d) { return d.empty() || within(d.back()); });
+    const auto end = std::partition_point(sums.begin(), sums.end(), within);
+    return end == sums.begin() ? 0 : end[-1].qty;
+}
+
+template <Side S>
+SweepCost OrderBook::side_sweep_cost(Quantity qty) const {
+    if (qty <= 0) return {};
+
+    // Grow the cache only as deep as this size reaches
+    const auto& sums = extend_depth<S>([qty](const std::vector<DepthSum>& d) { return d.empty() || d.back().qty < qty; });
+    if (sums.empty()) return {};
+
+    // First level whose running total covers qty
+    const auto hit = std::lower_bound(sums.begin(), sums.end(), qty,
+        [](const DepthSum& e, Quantity q) { return e.qty < q; });
+
+    SweepCost cost;
+    if (hit == sums.end()) {
+        cost.filled = sums.back().qty;
+        cost.notional = sums.back().notional;
+        cost.worst_price = sums.back().price;
+        return cost;
+    }
+
+    const DepthSum before = hit == sums.begin() ? DepthSum{0, 0, 0.0} : hit[-1];
+    cost.filled = qty;
+    cost.notional = before.notional + static_cast<double>(hit->price) * static_cast<double>(qty - before.qty);
+    cost.worst_price = hit->price;
+    return cost;
+}
+
+Quantity OrderBook::depth_within(Side side, Price ticks) const {
+    return side == Side::BID ? side_depth_within<Side::BID>(ticks) : side_depth_within<Side::ASK>(ticks);
+}
+
+SweepCost OrderBook::sweep_cost(Side book_side, Quantity qty) const {
+    return book_side == Side::BID ? side_sweep_cost<Side::BID>(qty) : side_sweep_cost<Side::ASK>(qty);
+}
+
+} // namespace signalforge
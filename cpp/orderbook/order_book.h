@@ -1,6 +1,10 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <map>
+#include <vector>
 
 namespace signalforge {
 
@@ -12,8 +16,61 @@ enum class Side : uint8_t {
 using Price = int64_t;     // fixed-point ticks
 using Quantity = int64_t;  // fixed-point units
 
+// Compile-time price ordering for one side of the book, so per-side code
+// can be written once and instantiated without runtime Side branches.
+template <Side S>
+struct SideTraits;
+
+template <>
+struct SideTraits<Side::BID> {
+    using Compare = std::greater<Price>;  // best first
+    static constexpr Side opposite = Side::ASK;
+
+    static constexpr bool better(Price a, Price b) { return a > b; }
+    // Price ticks away from best, deeper into the side
+    static constexpr Price behind(Price best, Price ticks) { return best - ticks; }
+    // Whether a print at trade_price reaches a resting order at limit
+    static constexpr bool crossed_by(Price limit, Price trade_price) { return trade_price <= limit; }
+};
+
+template <>
+struct SideTraits<Side::ASK> {
+    using Compare = std::less<Price>;  // best first
+    static constexpr Side opposite = Side::BID;
+
+    static constexpr bool better(Price a, Price b) { return a < b; }
+    static constexpr Price behind(Price best, Price ticks) { return best + ticks; }
+    static constexpr bool crossed_by(Price limit, Price trade_price) { return trade_price >= limit; }
+};
+
+// One price level on one side of the book
+struct Level {
+    Price price;
+    Quantity qty;
+};
+
+// Absolute level update as sent by exchange depth streams: qty replaces the
+// level, qty <= 0 removes it (same semantics as set_level)
+struct Delta {
+    Side side;
+    Price price;
+    Quantity qty;
+};
+
+// Cost of taking qty from one side of the book, best level first
+struct SweepCost {
+    Quantity filled = 0;    // less than requested when the side runs dry
+    Price worst_price = 0;  // last level touched, 0 if nothing filled
+    double notional = 0.0;  // sum of price * qty over the touched levels
+
+    double vwap() const { return filled > 0 ? notional / static_cast<double>(filled) : 0.0; }
+};
+
 class OrderBook {
 public:
+    template <Side S>
+    using Levels = std::map<Price, Quantity, typename SideTraits<S>::Compare>;
+
     OrderBook();
 
     // snapshot semantics
@@ -24,20 +81,191 @@ public:
     void add_level(Side side, Price price, Quantity qty);
     void remove_level(Side side, Price price, Quantity qty);
 
+    // Statically dispatched versions of the mutators, for callers that
+    // know the side at compile time. Defined here so they inline.
+    template <Side S>
+    void set_level(Price price, Quantity qty) {
+        auto& side = levels<S>();
+        if (qty <= 0) {
+            if (side.erase(price) > 0) {
+                invalidate<S>(price);
+                on_level_erased<S>(price);
+            }
+        } else {
+            invalidate<S>(price);
+            if (side.insert_or_assign(price, qty).second) on_level_inserted<S>(price);
+        }
+    }
+
+    template <Side S>
+    void add_level(Price price, Quantity qty) {
+        if (qty <= 0) return;
+
+        invalidate<S>(price);
+        auto [it, inserted] = levels<S>().try_emplace(price, 0);
+        it->second += qty;
+        if (inserted) on_level_inserted<S>(price);
+    }
+
+    template <Side S>
+    void remove_level(Price price, Quantity qty) {
+        if (qty <= 0) return;
+
+        auto& side = levels<S>();
+        auto it = side.find(price);
+        if (it != side.end()) {
+            invalidate<S>(price);
+            it->second -= qty;
+            if (it->second <= 0) {
+                side.erase(it);
+                on_level_erased<S>(price);
+            }
+        }
+    }
+
+    // batch semantics: derived state (best levels, top_version) is updated
+    // once per call rather than once per level.
+    //
+    // apply_snapshot replaces the whole book. Each side is expected best
+    // first (bids descending, asks ascending), as exchanges send them;
+    // other orders are accepted but lose the linear-time build.
+    void apply_snapshot(const std::vector<Level>& bids, const std::vector<Level>& asks);
+    // Equivalent to set_level() for each delta in order. A side whose
+    // deltas arrive strictly best first, and densely enough (kHintRatio),
+    // is updated by walking one iterator down its map with hinted inserts
+    // and erases; otherwise each delta searches the map on its own.
+    void apply_deltas(const Delta* deltas, size_t count);
+    void apply_deltas(const std::vector<Delta>& deltas) { apply_deltas(deltas.data(), deltas.size()); }
+
     // query methods
     Price best_bid() const;
     Price best_ask() const;
 
     Quantity level_qty(Side side, Price price) const;
 
+    // depth queries, none of which allocate once the cache is warm. Running
+    // totals from the top are cached per side and cut back at the shallowest
+    // level a mutation touches, so repeated queries only walk the levels
+    // that changed. The cache makes the queries unsafe to call concurrently
+    // on one book.
+    //
+    // Copies up to n levels, best first, into out. Returns the count copied.
+    size_t top_levels(Side side, Level* out, size_t n) const;
+    // Total quantity resting within ticks of the best price on a side
+    Quantity depth_within(Side side, Price ticks) const;
+    // What taking qty from book_side would cost (BID side for a sell)
+    SweepCost sweep_cost(Side book_side, Quantity qty) const;
+
+    // Bumped whenever best_bid() or best_ask() changes. Consumers remember
+    // the last version they saw and skip updates that left the top alone.
+    uint64_t top_version() const { return top_version_; }
+
 private:
+    // Running totals over the levels from the best one through price
+    struct DepthSum {
+        Price price;
+        Quantity qty;
+        double notional;
+    };
+
+    template <Side S>
+    Levels<S>& levels() {
+        if constexpr (S == Side::BID) {
+            return bids_;
+        } else {
+            return asks_;
+        }
+    }
+
+    template <Side S>
+    const Levels<S>& levels() const {
+        if constexpr (S == Side::BID) {
+            return bids_;
+        } else {
+            return asks_;
+        }
+    }
+
+    template <Side S>
+    Price& best() {
+        if constexpr (S == Side::BID) {
+            return best_bid_;
+        } else {
+            return best_ask_;
+        }
+    }
+
+    template <Side S>
+    std::vector<DepthSum>& depth() const {
+        if constexpr (S == Side::BID) {
+            return bid_depth_;
+        } else {
+            return ask_depth_;
+        }
+    }
+
+    // Drops cached totals at or behind price on side S; totals of better
+    // levels are unaffected
+    template <Side S>
+    void invalidate(Price price) {
+        auto& sums = depth<S>();
+        if (sums.empty() || SideTraits<S>::better(sums.back().price, price)) return;
+        sums.erase(std::partition_point(sums.begin(), sums.end(),
+                                        [price](const DepthSum& e) { return SideTraits<S>::better(e.price, price); }),
+                   sums.end());
+    }
+
+    // Caches further levels while more(cached totals) holds
+    template <Side S, typename More> const std::vector<DepthSum>& extend_depth(More more) const;
+    template <Side S> Quantity side_depth_within(Price ticks) const;
+    template <Side S> SweepCost side_sweep_cost(Quantity qty) const;
+
+    // Only touch the cached best price when the mutation can move it
+
+    template <Side S>
+    void on_level_inserted(Price price) {
+        // A new level only matters if it is better than the current best
+        Price& top = best<S>();
+        if (levels<S>().size() == 1 || SideTraits<S>::better(price, top)) {
+            top = price;
+            ++top_version_;
+        }
+    }
+
+    template <Side S>
+    void on_level_erased(Price price) {
+        // Erasing anything but the best level leaves the top untouched
+        Price& top = best<S>();
+        if (price == top) {
+            const auto& side = levels<S>();
+            top = side.empty() ? 0 : side.begin()->first;
+            ++top_version_;
+        }
+    }
+
+    // apply_deltas for one side, best-first input or any order
+    template <Side S> void apply_sorted(const Delta* deltas, size_t count);
+    template <Side S> void apply_each(const Delta* deltas, size_t count);
+    // Full recompute after a batch
     void update_best_levels();
 
-    std::map<Price, Quantity, std::greater<Price>> bids_;
-    std::map<Price, Quantity, std::less<Price>> asks_;
+    // Levels apply_sorted steps over before searching the map instead
+    static constexpr size_t kHintProbe = 16;
+    // Below this ratio of deltas to levels on a side, the deltas are too
+    // far apart for walking the map to beat a search per delta
+    static constexpr size_t kHintRatio = 8;
+
+    Levels<Side::BID> bids_;
+    Levels<Side::ASK> asks_;
 
     Price best_bid_;
     Price best_ask_;
+    uint64_t top_version_;
+
+    // Depth cache, best level first; mutable so the const queries can
+    // extend it
+    mutable std::vector<DepthSum> bid_depth_;
+    mutable std::vector<DepthSum> ask_depth_;
 };
 
 } // namespace signalforge
@@ -0,0 +1,295 @@
+// Replay-style benchmark comparing the map-based OrderBook with FlatOrderBook.
+//
+// Run: bazel run -c opt //cpp/orderbook:order_book_benchmark
+
+#include "order_book.h"
+#include "flat_order_book.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace signalforge {
+namespace {
+
+struct Update {
+    Side side;
+    Price price;
+    Quantity qty;
+};
+
+constexpr Price kMid = 4250000;
+
+// Depth-stream shaped updates: most land a few ticks from the top of the
+// book, a long tail lands deep, and roughly one in five removes the level.
+std::vector<Update> make_updates(int depth, size_t count) {
+    std::mt19937_64 rng(7);
+    std::geometric_distribution<int> distance(4.0 / depth);
+    std::uniform_int_distribution<Quantity> qty(1, 1000);
+    std::uniform_int_distribution<int> remove(0, 4);
+
+    std::vector<Update> updates;
+    updates.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const int d = 1 + distance(rng) % depth;
+        const Side side = (i & 1) ? Side::BID : Side::ASK;
+        const Price price = side == Side::BID ? kMid - d : kMid + d;
+        updates.push_back({side, price, remove(rng) == 0 ? 0 : qty(rng)});
+    }
+    return updates;
+}
+
+template <typename Book>
+void seed_book(Book& book, int depth) {
+    for (int d = 1; d <= depth; ++d) {
+        book.set_level(Side::BID, kMid - d, 100);
+        book.set_level(Side::ASK, kMid + d, 100);
+    }
+}
+
+template <typename Book>
+void BM_SetLevelReplay(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    const auto updates = make_updates(depth, 1 << 16);
+
+    Book book;
+    seed_book(book, depth);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const Update& u = updates[i];
+        book.set_level(u.side, u.price, u.qty);
+        benchmark::DoNotOptimize(book.best_bid());
+        benchmark::DoNotOptimize(book.best_ask());
+        i = (i + 1) & (updates.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Book>
+void BM_AddRemoveReplay(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    const auto updates = make_updates(depth, 1 << 16);
+
+    Book book;
+    seed_book(book, depth);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const Update& u = updates[i];
+        if (u.qty == 0) {
+            book.remove_level(u.side, u.price, 50);
+        } else {
+            book.add_level(u.side, u.price, u.qty);
+        }
+        benchmark::DoNotOptimize(book.best_bid());
+        i = (i + 1) & (updates.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Book>
+void BM_LevelQty(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    const auto updates = make_updates(depth, 1 << 16);
+
+    Book book;
+    seed_book(book, depth);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const Update& u = updates[i];
+        benchmark::DoNotOptimize(book.level_qty(u.side, u.price));
+        i = (i + 1) & (updates.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Loading a best-first snapshot: one set_level per level vs apply_snapshot
+std::vector<Level> make_side(Side side, int depth) {
+    std::vector<Level> levels;
+    levels.reserve(depth);
+    for (int d = 1; d <= depth; ++d) {
+        levels.push_back({side == Side::BID ? kMid - d : kMid + d, 100 + d});
+    }
+    return levels;
+}
+
+template <typename Book>
+void BM_SnapshotPerLevel(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    const auto bids = make_side(Side::BID, depth);
+    const auto asks = make_side(Side::ASK, depth);
+
+    Book book;
+    for (auto _ : state) {
+        book.clear();
+        for (const Level& l : bids) book.set_level(Side::BID, l.price, l.qty);
+        for (const Level& l : asks) book.set_level(Side::ASK, l.price, l.qty);
+        benchmark::DoNotOptimize(book.best_bid());
+    }
+    state.SetItemsProcessed(state.iterations() * depth * 2);
+}
+
+template <typename Book>
+void BM_SnapshotBatch(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    const auto bids = make_side(Side::BID, depth);
+    const auto asks = make_side(Side::ASK, depth);
+
+    Book book;
+    for (auto _ : state) {
+        book.apply_snapshot(bids, asks);
+        benchmark::DoNotOptimize(book.best_bid());
+    }
+    state.SetItemsProcessed(state.iterations() * depth * 2);
+}
+
+// Diff-depth style batches (best first per side) against a 1000-level book
+std::vector<std::vector<Delta>> make_batches(size_t batch_size) {
+    const auto updates = make_updates(1000, 1 << 16);
+    std::vector<std::vector<Delta>> batches;
+    for (size_t i = 0; i + batch_size <= updates.size() && batches.size() < 256; i += batch_size) {
+        std::vector<Update> chunk(updates.begin() + i, updates.begin() + i + batch_size);
+        std::sort(chunk.begin(), chunk.end(), [](const Update& a, const Update& b) {
+            if (a.side != b.side) return a.side < b.side;
+            return a.side == Side::BID ? a.price > b.price : a.price < b.price;
+        });
+        chunk.erase(std::unique(chunk.begin(), chunk.end(), [](const Update& a, const Update& b) {
+            return a.side == b.side && a.price == b.price;
+        }), chunk.end());
+
+        std::vector<Delta> batch;
+        for (const Update& u : chunk) batch.push_back({u.side, u.price, u.qty});
+        batches.push_back(std::move(batch));
+    }
+    return batches;
+}
+
+template <typename Book>
+void BM_DeltasPerLevel(benchmark::State& state) {
+    const auto batches = make_batches(static_cast<size_t>(state.range(0)));
+    Book book;
+    seed_book(book, 1000);
+
+    size_t i = 0;
+    int64_t items = 0;
+    for (auto _ : state) {
+        const auto& batch = batches[i];
+        for (const Delta& d : batch) book.set_level(d.side, d.price, d.qty);
+        benchmark::DoNotOptimize(book.best_bid());
+        items += static_cast<int64_t>(batch.size());
+        i = (i + 1) % batches.size();
+    }
+    state.SetItemsProcessed(items);
+}
+
+template <typename Book>
+void BM_DeltasBatch(benchmark::State& state) {
+    const auto batches = make_batches(static_cast<size_t>(state.range(0)));
+    Book book;
+    seed_book(book, 1000);
+
+    size_t i = 0;
+    int64_t items = 0;
+    for (auto _ : state) {
+        const auto& batch = batches[i];
+        book.apply_deltas(batch);
+        benchmark::DoNotOptimize(book.best_bid());
+        items += static_cast<int64_t>(batch.size());
+        i = (i + 1) % batches.size();
+    }
+    state.SetItemsProcessed(items);
+}
+
+// A strategy that reads depth on every event: one update, then the
+// queries a slippage-aware execution model would make
+template <typename Book>
+void BM_UpdateThenQuery(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    const auto updates = make_updates(depth, 1 << 16);
+
+    Book book;
+    seed_book(book, depth);
+
+    Level top[10];
+    size_t i = 0;
+    for (auto _ : state) {
+        const Update& u = updates[i];
+        book.set_level(u.side, u.price, u.qty);
+        benchmark::DoNotOptimize(book.top_levels(Side::BID, top, 10));
+        benchmark::DoNotOptimize(book.depth_within(Side::BID, 25));
+        benchmark::DoNotOptimize(book.sweep_cost(Side::ASK, 5000));
+        i = (i + 1) & (updates.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Runtime Side argument vs the statically dispatched mutators. The static
+// loop replays each side's updates from its own stream, as a replayer that
+// splits depth messages by side would.
+template <typename Book>
+void BM_RuntimeSide(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    const auto updates = make_updates(depth, 1 << 16);
+
+    Book book;
+    seed_book(book, depth);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const Update& u = updates[i];
+        book.set_level(u.side, u.price, u.qty);
+        i = (i + 1) & (updates.size() - 1);
+    }
+    benchmark::DoNotOptimize(book.best_bid());
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Book>
+void BM_StaticSide(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    const auto updates = make_updates(depth, 1 << 16);
+
+    std::vector<Level> bids, asks;
+    for (const Update& u : updates) {
+        (u.side == Side::BID ? bids : asks).push_back({u.price, u.qty});
+    }
+
+    Book book;
+    seed_book(book, depth);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        book.template set_level<Side::BID>(bids[i].price, bids[i].qty);
+        book.template set_level<Side::ASK>(asks[i].price, asks[i].qty);
+        i = (i + 1) & (bids.size() - 1);
+    }
+    benchmark::DoNotOptimize(book.best_bid());
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK_TEMPLATE(BM_SetLevelReplay, OrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_SetLevelReplay, FlatOrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_AddRemoveReplay, OrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_AddRemoveReplay, FlatOrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_LevelQty, OrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_LevelQty, FlatOrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_UpdateThenQuery, OrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_UpdateThenQuery, FlatOrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_RuntimeSide, OrderBook)->Arg(20)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_RuntimeSide, FlatOrderBook)->Arg(20)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_StaticSide, OrderBook)->Arg(20)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_StaticSide, FlatOrderBook)->Arg(20)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_SnapshotPerLevel, OrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_SnapshotPerLevel, FlatOrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_SnapshotBatch, OrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_SnapshotBatch, FlatOrderBook)->Arg(20)->Arg(1000)->Arg(5000);
+BENCHMARK_TEMPLATE(BM_DeltasPerLevel, OrderBook)->Arg(20)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_DeltasPerLevel, FlatOrderBook)->Arg(20)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_DeltasBatch, OrderBook)->Arg(20)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_DeltasBatch, FlatOrderBook)->Arg(20)->Arg(1000);
+
+}  // namespace
+}  // namespace signalforge
@@ -1,151 +1,591 @@
 #include "order_book.h"
+#include "flat_order_book.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
 #include <limits>
+#include <random>
+#include <vector>
 
 namespace signalforge {
 
+// Every book implementation must pass the same suite.
+template <typename Book>
 class OrderBookTest : public ::testing::Test {
 protected:
-    OrderBook book;
+    Book book;
 };
 
+using BookTypes = ::testing::Types<OrderBook, FlatOrderBook>;
+TYPED_TEST_SUITE(OrderBookTest, BookTypes);
+
 // Test initial state
-TEST_F(OrderBookTest, InitialState) {
-    EXPECT_EQ(book.best_bid(), 0);
-    EXPECT_EQ(book.best_ask(), 0);
+TYPED_TEST(OrderBookTest, InitialState) {
+    EXPECT_EQ(this->book.best_bid(), 0);
+    EXPECT_EQ(this->book.best_ask(), 0);
 }
 
 // Test setting bid levels
-TEST_F(OrderBookTest, SetBidLevel) {
-    book.set_level(Side::BID, 100, 10);
-    EXPECT_EQ(book.best_bid(), 100);
+TYPED_TEST(OrderBookTest, SetBidLevel) {
+    this->book.set_level(Side::BID, 100, 10);
+    EXPECT_EQ(this->book.best_bid(), 100);
 }
 
-TEST_F(OrderBookTest, SetMultipleBidLevels) {
-    book.set_level(Side::BID, 100, 10);
-    book.set_level(Side::BID, 105, 5);
-    book.set_level(Side::BID, 95, 15);
+TYPED_TEST(OrderBookTest, SetMultipleBidLevels) {
+    this->book.set_level(Side::BID, 100, 10);
+    this->book.set_level(Side::BID, 105, 5);
+    this->book.set_level(Side::BID, 95, 15);
 
     // Best bid should be highest price (105)
-    EXPECT_EQ(book.best_bid(), 105);
+    EXPECT_EQ(this->book.best_bid(), 105);
 }
 
 // Test setting ask levels
-TEST_F(OrderBookTest, SetAskLevel) {
-    book.set_level(Side::ASK, 110, 5);
-    EXPECT_EQ(book.best_ask(), 110);
+TYPED_TEST(OrderBookTest, SetAskLevel) {
+    this->book.set_level(Side::ASK, 110, 5);
+    EXPECT_EQ(this->book.best_ask(), 110);
 }
 
-TEST_F(OrderBookTest, SetMultipleAskLevels) {
-    book.set_level(Side::ASK, 110, 5);
-    book.set_level(Side::ASK, 115, 10);
-    book.set_level(Side::ASK, 105, 8);
+TYPED_TEST(OrderBookTest, SetMultipleAskLevels) {
+    this->book.set_level(Side::ASK, 110, 5);
+    this->book.set_level(Side::ASK, 115, 10);
+    this->book.set_level(Side::ASK, 105, 8);
 
     // Best ask should be lowest price (105)
-    EXPECT_EQ(book.best_ask(), 105);
+    EXPECT_EQ(this->book.best_ask(), 105);
 }
 
 // Test removing levels (qty <= 0)
-TEST_F(OrderBookTest, RemoveLevelWithZeroQuantity) {
-    book.set_level(Side::BID, 100, 10);
-    book.set_level(Side::BID, 95, 5);
+TYPED_TEST(OrderBookTest, RemoveLevelWithZeroQuantity) {
+    this->book.set_level(Side::BID, 100, 10);
+    this->book.set_level(Side::BID, 95, 5);
 
-    EXPECT_EQ(book.best_bid(), 100);
+    EXPECT_EQ(this->book.best_bid(), 100);
 
     // Remove the best bid
-    book.set_level(Side::BID, 100, 0);
+    this->book.set_level(Side::BID, 100, 0);
 
     // Best bid should now be 95
-    EXPECT_EQ(book.best_bid(), 95);
+    EXPECT_EQ(this->book.best_bid(), 95);
 }
 
-TEST_F(OrderBookTest, RemoveAllLevels) {
-    book.set_level(Side::BID, 100, 10);
-    book.set_level(Side::ASK, 110, 5);
+TYPED_TEST(OrderBookTest, RemoveAllLevels) {
+    this->book.set_level(Side::BID, 100, 10);
+    this->book.set_level(Side::ASK, 110, 5);
 
-    book.set_level(Side::BID, 100, 0);
-    book.set_level(Side::ASK, 110, 0);
+    this->book.set_level(Side::BID, 100, 0);
+    this->book.set_level(Side::ASK, 110, 0);
 
-    EXPECT_EQ(book.best_bid(), 0);
-    EXPECT_EQ(book.best_ask(), 0);
+    EXPECT_EQ(this->book.best_bid(), 0);
+    EXPECT_EQ(this->book.best_ask(), 0);
 }
 
 // Test clear functionality
-TEST_F(OrderBookTest, Clear) {
-    book.set_level(Side::BID, 100, 10);
-    book.set_level(Side::ASK, 110, 5);
+TYPED_TEST(OrderBookTest, Clear) {
+    this->book.set_level(Side::BID, 100, 10);
+    this->book.set_level(Side::ASK, 110, 5);
 
-    book.clear();
+    this->book.clear();
 
-    EXPECT_EQ(book.best_bid(), 0);
-    EXPECT_EQ(book.best_ask(), 0);
+    EXPECT_EQ(this->book.best_bid(), 0);
+    EXPECT_EQ(this->book.best_ask(), 0);
 }
 
 // Test add_level (delta semantics)
-TEST_F(OrderBookTest, AddLevel) {
-    book.add_level(Side::BID, 100, 10);
-    book.add_level(Side::BID, 100, 5);
+TYPED_TEST(OrderBookTest, AddLevel) {
+    this->book.add_level(Side::BID, 100, 10);
+    this->book.add_level(Side::BID, 100, 5);
 
     // Quantity should accumulate
-    EXPECT_EQ(book.best_bid(), 100);
+    EXPECT_EQ(this->book.best_bid(), 100);
 }
 
-TEST_F(OrderBookTest, AddLevelIgnoresNegative) {
-    book.set_level(Side::BID, 100, 10);
+TYPED_TEST(OrderBookTest, AddLevelIgnoresNegative) {
+    this->book.set_level(Side::BID, 100, 10);
 
-    book.add_level(Side::BID, 100, -5);
+    this->book.add_level(Side::BID, 100, -5);
 
-    EXPECT_EQ(book.best_bid(), 100);
+    EXPECT_EQ(this->book.best_bid(), 100);
 }
 
 // Test remove_level (delta semantics)
-TEST_F(OrderBookTest, RemoveLevel) {
-    book.set_level(Side::BID, 100, 20);
+TYPED_TEST(OrderBookTest, RemoveLevel) {
+    this->book.set_level(Side::BID, 100, 20);
 
-    book.remove_level(Side::BID, 100, 5);
+    this->book.remove_level(Side::BID, 100, 5);
 
     // Should still have the level at 100
-    EXPECT_EQ(book.best_bid(), 100);
+    EXPECT_EQ(this->book.best_bid(), 100);
 }
 
-TEST_F(OrderBookTest, RemoveLevelCompletely) {
-    book.set_level(Side::BID, 100, 10);
-    book.set_level(Side::BID, 95, 5);
+TYPED_TEST(OrderBookTest, RemoveLevelCompletely) {
+    this->book.set_level(Side::BID, 100, 10);
+    this->book.set_level(Side::BID, 95, 5);
 
     // Remove all quantity at 100
-    book.remove_level(Side::BID, 100, 10);
+    this->book.remove_level(Side::BID, 100, 10);
 
     // Best bid should drop to 95
-    EXPECT_EQ(book.best_bid(), 95);
+    EXPECT_EQ(this->book.best_bid(), 95);
 }
 
-TEST_F(OrderBookTest, RemoveLevelOverQuantity) {
-    book.set_level(Side::BID, 100, 10);
-    book.set_level(Side::BID, 95, 5);
+TYPED_TEST(OrderBookTest, RemoveLevelOverQuantity) {
+    this->book.set_level(Side::BID, 100, 10);
+    this->book.set_level(Side::BID, 95, 5);
 
     // Remove more than available
-    book.remove_level(Side::BID, 100, 20);
+    this->book.remove_level(Side::BID, 100, 20);
 
     // Level should be removed, best bid should be 95
-    EXPECT_EQ(book.best_bid(), 95);
+    EXPECT_EQ(this->book.best_bid(), 95);
 }
 
 // Test realistic order book scenario
-TEST_F(OrderBookTest, RealisticScenario) {
+TYPED_TEST(OrderBookTest, RealisticScenario) {
     // Build a book with spread
-    book.set_level(Side::BID, 100, 10);
-    book.set_level(Side::BID, 99, 20);
-    book.set_level(Side::BID, 98, 15);
+    this->book.set_level(Side::BID, 100, 10);
+    this->book.set_level(Side::BID, 99, 20);
+    this->book.set_level(Side::BID, 98, 15);
 
-    book.set_level(Side::ASK, 101, 5);
-    book.set_level(Side::ASK, 102, 10);
-    book.set_level(Side::ASK, 103, 8);
+    this->book.set_level(Side::ASK, 101, 5);
+    this->book.set_level(Side::ASK, 102, 10);
+    this->book.set_level(Side::ASK, 103, 8);
 
-    EXPECT_EQ(book.best_bid(), 100);
-    EXPECT_EQ(book.best_ask(), 101);
+    EXPECT_EQ(this->book.best_bid(), 100);
+    EXPECT_EQ(this->book.best_ask(), 101);
 
     // Spread should be 1 tick
-    EXPECT_EQ(book.best_ask() - book.best_bid(), 1);
+    EXPECT_EQ(this->book.best_ask() - this->book.best_bid(), 1);
+}
+
+// Test level quantities
+TYPED_TEST(OrderBookTest, LevelQty) {
+    this->book.set_level(Side::BID, 100, 10);
+    this->book.add_level(Side::BID, 100, 5);
+    this->book.set_level(Side::ASK, 101, 7);
+    this->book.remove_level(Side::ASK, 101, 2);
+
+    EXPECT_EQ(this->book.level_qty(Side::BID, 100), 15);
+    EXPECT_EQ(this->book.level_qty(Side::ASK, 101), 5);
+
+    // Unknown levels and the wrong side report nothing
+    EXPECT_EQ(this->book.level_qty(Side::BID, 99), 0);
+    EXPECT_EQ(this->book.level_qty(Side::ASK, 100), 0);
+}
+
+TYPED_TEST(OrderBookTest, InsertBelowBestKeepsBest) {
+    this->book.set_level(Side::BID, 100, 10);
+    this->book.set_level(Side::BID, 90, 10);
+    this->book.set_level(Side::BID, 95, 10);
+
+    this->book.set_level(Side::ASK, 110, 10);
+    this->book.set_level(Side::ASK, 120, 10);
+    this->book.set_level(Side::ASK, 115, 10);
+
+    EXPECT_EQ(this->book.best_bid(), 100);
+    EXPECT_EQ(this->book.best_ask(), 110);
+
+    this->book.set_level(Side::BID, 100, 0);
+    this->book.set_level(Side::ASK, 110, 0);
+
+    EXPECT_EQ(this->book.best_bid(), 95);
+    EXPECT_EQ(this->book.best_ask(), 115);
+}
+
+// Test top-of-book change notifications
+TYPED_TEST(OrderBookTest, TopVersionIgnoresDeepUpdates) {
+    this->book.set_level(Side::BID, 100, 10);
+    this->book.set_level(Side::ASK, 110, 10);
+    const uint64_t v = this->book.top_version();
+
+    // Levels behind the best, and size changes at the best, leave the top alone
+    this->book.set_level(Side::BID, 95, 10);
+    this->book.add_level(Side::ASK, 115, 10);
+    this->book.set_level(Side::BID, 100, 20);
+    this->book.remove_level(Side::ASK, 110, 5);
+    this->book.set_level(Side::BID, 95, 0);
+    this->book.remove_level(Side::ASK, 115, 10);
+
+    EXPECT_EQ(this->book.top_version(), v);
+}
+
+TYPED_TEST(OrderBookTest, TopVersionTracksBestChanges) {
+    uint64_t v = this->book.top_version();
+
+    this->book.set_level(Side::BID, 100, 10);
+    EXPECT_GT(this->book.top_version(), v);
+    v = this->book.top_version();
+
+    this->book.add_level(Side::ASK, 110, 10);
+    EXPECT_GT(this->book.top_version(), v);
+    v = this->book.top_version();
+
+    // Improving the best bid
+    this->book.set_level(Side::BID, 101, 10);
+    EXPECT_GT(this->book.top_version(), v);
+    v = this->book.top_version();
+
+    // Removing the best ask exposes nothing, but still moves the top
+    this->book.remove_level(Side::ASK, 110, 10);
+    EXPECT_GT(this->book.top_version(), v);
+    EXPECT_EQ(this->book.best_ask(), 0);
+    v = this->book.top_version();
+
+    this->book.set_level(Side::BID, 101, 0);
+    EXPECT_GT(this->book.top_version(), v);
+    EXPECT_EQ(this->book.best_bid(), 100);
+    v = this->book.top_version();
+
+    this->book.clear();
+    EXPECT_GT(this->book.top_version(), v);
+}
+
+// Test batch application
+TYPED_TEST(OrderBookTest, ApplySnapshot) {
+    this->book.set_level(Side::BID, 50, 1);  // replaced by the snapshot
+
+    this->book.apply_snapshot(
+        {{100, 10}, {99, 20}, {98, 0}, {97, 15}},
+        {{101, 5}, {102, 10}, {103, 8}});
+
+    EXPECT_EQ(this->book.best_bid(), 100);
+    EXPECT_EQ(this->book.best_ask(), 101);
+    EXPECT_EQ(this->book.level_qty(Side::BID, 99), 20);
+    EXPECT_EQ(this->book.level_qty(Side::BID, 98), 0);   // zero qty skipped
+    EXPECT_EQ(this->book.level_qty(Side::BID, 50), 0);   // old level gone
+    EXPECT_EQ(this->book.level_qty(Side::ASK, 103), 8);
+}
+
+TYPED_TEST(OrderBookTest, ApplySnapshotUnsortedInput) {
+    this->book.apply_snapshot({{97, 15}, {100, 10}, {99, 20}}, {{103, 8}, {101, 5}});
+
+    EXPECT_EQ(this->book.best_bid(), 100);
+    EXPECT_EQ(this->book.best_ask(), 101);
+    EXPECT_EQ(this->book.level_qty(Side::BID, 97), 15);
+    EXPECT_EQ(this->book.level_qty(Side::ASK, 103), 8);
+}
+
+TYPED_TEST(OrderBookTest, ApplyDeltas) {
+    this->book.apply_snapshot({{100, 10}, {99, 20}}, {{101, 5}, {102, 10}});
+    const uint64_t v = this->book.top_version();
+
+    this->book.apply_deltas({
+        {Side::BID, 100, 0},   // remove best bid
+        {Side::BID, 98, 7},    // new deep level
+        {Side::ASK, 101, 9},   // resize best ask
+        {Side::ASK, 104, 3},
+        {Side::BID, 98, 8},    // later update to the same level wins
+    });
+
+    EXPECT_EQ(this->book.best_bid(), 99);
+    EXPECT_EQ(this->book.best_ask(), 101);
+    EXPECT_EQ(this->book.level_qty(Side::BID, 98), 8);
+    EXPECT_EQ(this->book.level_qty(Side::ASK, 101), 9);
+    EXPECT_EQ(this->book.level_qty(Side::ASK, 104), 3);
+
+    // Derived state is updated once for the whole batch
+    EXPECT_EQ(this->book.top_version(), v + 1);
+}
+
+// Test depth queries
+TYPED_TEST(OrderBookTest, TopLevels) {
+    this->book.apply_snapshot({{100, 10}, {99, 20}, {98, 15}}, {{101, 5}, {102, 10}});
+
+    Level out[4];
+    ASSERT_EQ(this->book.top_levels(Side::BID, out, 2), 2u);
+    EXPECT_EQ(out[0].price, 100);
+    EXPECT_EQ(out[0].qty, 10);
+    EXPECT_EQ(out[1].price, 99);
+
+    // Asking for more than exists returns what is there
+    ASSERT_EQ(this->book.top_levels(Side::ASK, out, 4), 2u);
+    EXPECT_EQ(out[0].price, 101);
+    EXPECT_EQ(out[1].price, 102);
+    EXPECT_EQ(out[1].qty, 10);
+
+    this->book.clear();
+    EXPECT_EQ(this->book.top_levels(Side::BID, out, 4), 0u);
+}
+
+TYPED_TEST(OrderBookTest, DepthWithin) {
+    this->book.apply_snapshot({{100, 10}, {99, 20}, {97, 15}}, {{101, 5}, {103, 10}});
+
+    EXPECT_EQ(this->book.depth_within(Side::BID, 0), 10);
+    EXPECT_EQ(this->book.depth_within(Side::BID, 1), 30);
+    EXPECT_EQ(this->book.depth_within(Side::BID, 2), 30);
+    EXPECT_EQ(this->book.depth_within(Side::BID, 3), 45);
+    EXPECT_EQ(this->book.depth_within(Side::ASK, 1), 5);
+    EXPECT_EQ(this->book.depth_within(Side::ASK, 100), 15);
+    EXPECT_EQ(this->book.depth_within(Side::ASK, -1), 0);
+
+    // Cached totals follow later updates
+    this->book.set_level(Side::BID, 99, 5);
+    this->book.set_level(Side::BID, 101, 1);
+    EXPECT_EQ(this->book.depth_within(Side::BID, 2), 16);
+}
+
+TYPED_TEST(OrderBookTest, SweepCost) {
+    this->book.apply_snapshot({{100, 10}, {99, 20}}, {{101, 5}, {102, 10}, {105, 10}});
+
+    // Buying 12 takes 5 @ 101 and 7 @ 102
+    SweepCost buy = this->book.sweep_cost(Side::ASK, 12);
+    EXPECT_EQ(buy.filled, 12);
+    EXPECT_EQ(buy.worst_price, 102);
+    EXPECT_DOUBLE_EQ(buy.notional, 5 * 101 + 7 * 102);
+    EXPECT_DOUBLE_EQ(buy.vwap(), (5 * 101 + 7 * 102) / 12.0);
+
+    // Exactly the best level
+    SweepCost sell = this->book.sweep_cost(Side::BID, 10);
+    EXPECT_EQ(sell.filled, 10);
+    EXPECT_EQ(sell.worst_price, 100);
+    EXPECT_DOUBLE_EQ(sell.vwap(), 100.0);
+
+    // More than the side holds
+    SweepCost all = this->book.sweep_cost(Side::BID, 100);
+    EXPECT_EQ(all.filled, 30);
+    EXPECT_EQ(all.worst_price, 99);
+    EXPECT_DOUBLE_EQ(all.notional, 10 * 100 + 20 * 99);
+
+    SweepCost none = this->book.sweep_cost(Side::ASK, 0);
+    EXPECT_EQ(none.filled, 0);
+    EXPECT_DOUBLE_EQ(none.vwap(), 0.0);
+}
+
+// Test statically dispatched mutators
+TYPED_TEST(OrderBookTest, StaticSideMutators) {
+    this->book.template set_level<Side::BID>(100, 10);
+    this->book.template add_level<Side::BID>(100, 5);
+    this->book.template set_level<Side::ASK>(102, 7);
+    this->book.template add_level<Side::ASK>(101, 3);
+    this->book.template remove_level<Side::ASK>(101, 3);
+
+    EXPECT_EQ(this->book.best_bid(), 100);
+    EXPECT_EQ(this->book.best_ask(), 102);
+    EXPECT_EQ(this->book.level_qty(Side::BID, 100), 15);
+
+    // Same guards as the runtime versions
+    this->book.template add_level<Side::BID>(100, -5);
+    this->book.template remove_level<Side::BID>(100, 0);
+    EXPECT_EQ(this->book.level_qty(Side::BID, 100), 15);
+}
+
+TEST(SideTraitsTest, Ordering) {
+    EXPECT_TRUE(SideTraits<Side::BID>::better(101, 100));
+    EXPECT_FALSE(SideTraits<Side::BID>::better(100, 100));
+    EXPECT_TRUE(SideTraits<Side::ASK>::better(100, 101));
+
+    EXPECT_EQ(SideTraits<Side::BID>::behind(100, 3), 97);
+    EXPECT_EQ(SideTraits<Side::ASK>::behind(100, 3), 103);
+
+    // Resting bids trade on prints at or below the limit, asks at or above
+    EXPECT_TRUE(SideTraits<Side::BID>::crossed_by(100, 100));
+    EXPECT_TRUE(SideTraits<Side::BID>::crossed_by(100, 99));
+    EXPECT_FALSE(SideTraits<Side::BID>::crossed_by(100, 101));
+    EXPECT_TRUE(SideTraits<Side::ASK>::crossed_by(100, 101));
+    EXPECT_FALSE(SideTraits<Side::ASK>::crossed_by(100, 99));
+}
+
+// Hinted best-first batches and the unsorted fallback both land where
+// one set_level call per delta would
+TEST(OrderBookBatchTest, DeltasMatchSetLevel) {
+    OrderBook batched;
+    OrderBook single;
+
+    std::mt19937_64 rng(3);
+    std::uniform_int_distribution<Price> gap_dist(1, 40);
+    std::uniform_int_distribution<Quantity> qty_dist(-3, 20);
+    std::uniform_int_distribution<size_t> size_dist(1, 60);
+
+    std::vector<Delta> deltas;
+    for (int batch = 0; batch < 1000; ++batch) {
+        deltas.clear();
+        const size_t n = size_dist(rng);
+        Price bid = 1000 - gap_dist(rng) % 5;
+        Price ask = 1001 + gap_dist(rng) % 5;
+        for (size_t i = 0; i < n; ++i) {
+            // Mostly sorted; small gaps stay on the probe, large ones search
+            const Price gap = gap_dist(rng) > 35 ? 20 + gap_dist(rng) : gap_dist(rng) % 3 + 1;
+            if (rng() & 1) {
+                deltas.push_back({Side::BID, bid, qty_dist(rng)});
+                bid -= gap;
+            } else {
+                deltas.push_back({Side::ASK, ask, qty_dist(rng)});
+                ask += gap;
+            }
+        }
+        if (batch % 3 == 0) std::shuffle(deltas.begin(), deltas.end(), rng);
+
+        batched.apply_deltas(deltas);
+        for (const Delta& d : deltas) single.set_level(d.side, d.price, d.qty);
+
+        ASSERT_EQ(batched.best_bid(), single.best_bid()) << "batch " << batch;
+        ASSERT_EQ(batched.best_ask(), single.best_ask()) << "batch " << batch;
+        for (Side side : {Side::BID, Side::ASK}) {
+            std::vector<Level> a(4096), b(4096);
+            const size_t n_a = batched.top_levels(side, a.data(), a.size());
+            ASSERT_EQ(n_a, single.top_levels(side, b.data(), b.size())) << "batch " << batch;
+            for (size_t i = 0; i < n_a; ++i) {
+                ASSERT_EQ(a[i].price, b[i].price) << "batch " << batch;
+                ASSERT_EQ(a[i].qty, b[i].qty) << "batch " << batch;
+            }
+        }
+    }
+}
+
+// The cached depth totals must match a fresh walk of the levels after
+// every kind of mutation, queried between updates so the cache is cut back
+// and regrown rather than rebuilt
+TEST(OrderBookDepthCacheTest, MatchesFullWalk) {
+    OrderBook book;
+    std::mt19937_64 rng(4);
+    std::uniform_int_distribution<Price> price_dist(900, 1100);
+    std::uniform_int_distribution<Quantity> qty_dist(-2, 20);
+    std::vector<Level> levels(512);
+    std::vector<Delta> deltas;
+
+    for (int i = 0; i < 20000; ++i) {
+        const Side side = (rng() & 1) ? Side::BID : Side::ASK;
+        const Price price = price_dist(rng);
+        const Quantity qty = qty_dist(rng);
+        switch (rng() % 5) {
+            case 0: book.set_level(side, price, qty); break;
+            case 1: book.add_level(side, price, qty); break;
+            case 2: book.remove_level(side, price, qty); break;
+            case 3:
+                deltas.assign({{side, price, qty}, {side, price_dist(rng), qty_dist(rng)}});
+                book.apply_deltas(deltas);
+                break;
+            default:
+                if (i % 500 == 0) book.clear();
+        }
+
+        const size_t n = book.top_levels(side, levels.data(), levels.size());
+        const Price ticks = static_cast<Price>(rng() % 60);
+        Quantity within = 0;
+        for (size_t k = 0; k < n; ++k) {
+            if (std::abs(levels[k].price - levels[0].price) <= ticks) within += levels[k].qty;
+        }
+        ASSERT_EQ(book.depth_within(side, ticks), within) << "step " << i;
+
+        const Quantity want = static_cast<Quantity>(rng() % 400) + 1;
+        SweepCost walk;
+        for (size_t k = 0; k < n && walk.filled < want; ++k) {
+            const Quantity take = std::min(levels[k].qty, want - walk.filled);
+            walk.filled += take;
+            walk.notional += static_cast<double>(levels[k].price) * static_cast<double>(take);
+            walk.worst_price = levels[k].price;
+        }
+        const SweepCost cost = book.sweep_cost(side, want);
+        ASSERT_EQ(cost.filled, walk.filled) << "step " << i;
+        ASSERT_EQ(cost.worst_price, walk.worst_price) << "step " << i;
+        ASSERT_DOUBLE_EQ(cost.notional, walk.notional) << "step " << i;
+    }
+}
+
+// FlatOrderBook must track the map-based book exactly on a random stream
+TEST(FlatOrderBookTest, MatchesMapBookOnRandomUpdates) {
+    OrderBook reference;
+    FlatOrderBook flat(16);  // small reserve to exercise growth
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> op_dist(0, 2);
+    std::uniform_int_distribution<Price> price_dist(900, 1100);
+    std::uniform_int_distribution<Quantity> qty_dist(-2, 20);
+
+    uint64_t reference_top = reference.top_version();
+    uint64_t flat_top = flat.top_version();
+
+    for (int i = 0; i < 20000; ++i) {
+        const Side side = (rng() & 1) ? Side::BID : Side::ASK;
+        const Price price = price_dist(rng);
+        const Quantity qty = qty_dist(rng);
+
+        switch (op_dist(rng)) {
+            case 0:
+                reference.set_level(side, price, qty);
+                flat.set_level(side, price, qty);
+                break;
+            case 1:
+                reference.add_level(side, price, qty);
+                flat.add_level(side, price, qty);
+                break;
+            default:
+                reference.remove_level(side, price, qty);
+                flat.remove_level(side, price, qty);
+                break;
+        }
+
+        ASSERT_EQ(flat.best_bid(), reference.best_bid()) << "step " << i;
+        ASSERT_EQ(flat.best_ask(), reference.best_ask()) << "step " << i;
+        ASSERT_EQ(flat.level_qty(side, price), reference.level_qty(side, price)) << "step " << i;
+
+        // Depth queries go through the flat book's cache
+        if (i % 7 == 0) {
+            const Price ticks = price % 50;
+            ASSERT_EQ(flat.depth_within(side, ticks), reference.depth_within(side, ticks)) << "step " << i;
+            const SweepCost a = flat.sweep_cost(side, qty * 5);
+            const SweepCost b = reference.sweep_cost(side, qty * 5);
+            ASSERT_EQ(a.filled, b.filled) << "step " << i;
+            ASSERT_EQ(a.worst_price, b.worst_price) << "step " << i;
+            ASSERT_DOUBLE_EQ(a.notional, b.notional) << "step " << i;
+        }
+
+        // Both books must agree on which updates moved the top
+        ASSERT_EQ(flat.top_version() - flat_top, reference.top_version() - reference_top) << "step " << i;
+        reference_top = reference.top_version();
+        flat_top = flat.top_version();
+    }
+}
+
+// Batches must land exactly where the equivalent set_level calls would
+TEST(FlatOrderBookTest, BatchesMatchMapBook) {
+    OrderBook reference;
+    FlatOrderBook flat(16);
+
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<Price> offset_dist(1, 200);
+    std::uniform_int_distribution<Quantity> qty_dist(-3, 20);
+    std::uniform_int_distribution<size_t> size_dist(1, 400);
+
+    std::vector<Level> bids, asks;
+    for (Price p = 999; p > 800; --p) bids.push_back({p, 10});
+    for (Price p = 1001; p < 1200; ++p) asks.push_back({p, 10});
+    reference.apply_snapshot(bids, asks);
+    flat.apply_snapshot(bids, asks);
+
+    std::vector<Delta> deltas;
+    for (int batch = 0; batch < 500; ++batch) {
+        deltas.clear();
+        const size_t n = size_dist(rng);
+        const bool sorted = batch % 2 == 0;
+
+        if (sorted) {
+            // Best-first, unique prices: takes the linear merge path
+            Price bid = 1000, ask = 1000;
+            for (size_t i = 0; i < n; ++i) {
+                bid -= offset_dist(rng) % 3 + 1;
+                ask += offset_dist(rng) % 3 + 1;
+                deltas.push_back({Side::BID, bid, qty_dist(rng)});
+                deltas.push_back({Side::ASK, ask, qty_dist(rng)});
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                const Side side = (rng() & 1) ? Side::BID : Side::ASK;
+                const Price price = side == Side::BID ? 1000 - offset_dist(rng) : 1000 + offset_dist(rng);
+                deltas.push_back({side, price, qty_dist(rng)});
+            }
+        }
+
+        reference.apply_deltas(deltas);
+        flat.apply_deltas(deltas);
+
+        ASSERT_EQ(flat.best_bid(), reference.best_bid()) << "batch " << batch;
+        ASSERT_EQ(flat.best_ask(), reference.best_ask()) << "batch " << batch;
+        for (Price p = 700; p <= 1300; ++p) {
+            ASSERT_EQ(flat.level_qty(Side::BID, p), reference.level_qty(Side::BID, p)) << "batch " << batch;
+            ASSERT_EQ(flat.level_qty(Side::ASK, p), reference.level_qty(Side::ASK, p)) << "batch " << batch;
+        }
+    }
 }
 
 }  // namespace signalforge
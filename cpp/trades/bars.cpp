@@ -0,0 +1,169 @@
+#include "bars.h"
+#include <algorithm>
+#include <cmath>
+#include "cpp/io/fixed_point.h"
+
+namespace signalforge {
+
+namespace {
+
+constexpr int64_t pow10(int n) { return n == 0 ? 1 : 10 * pow10(n - 1); }
+
+// Length of the prefix of ts[begin, n) before limit. Checks eight
+// timestamps per step with a branch-free count, so whole blocks inside the
+// bar are skipped in a few vector instructions.
+size_t run_end(const uint64_t* ts, size_t begin, size_t n, uint64_t limit) {
+    size_t i = begin;
+    for (; i + 8 <= n; i += 8) {
+        unsigned below = 0;
+        for (size_t k = 0; k < 8; ++k) below += ts[i + k] < limit;
+        if (below != 8) break;
+    }
+    while (i < n && ts[i] < limit) ++i;
+    return i;
+}
+
+}  // namespace
+
+void BarAccumulator::start(uint64_t open_time) {
+    bar_ = Bar{};
+    bar_.open_time = open_time;
+}
+
+void BarAccumulator::add_run(const TradeColumns& trades, size_t begin, size_t end) {
+    if (begin == end) return;
+
+    const Price* price = trades.price;
+    const Quantity* qty = trades.qty;
+    const Quantity* quote_qty = trades.quote_qty;
+    const uint8_t* buyer_maker = trades.is_buyer_maker;
+
+    if (empty()) {
+        bar_.open = bar_.high = bar_.low = price[begin];
+    }
+
+    Price high = bar_.high;
+    Price low = bar_.low;
+    Quantity volume = 0;
+    Quantity quote_volume = 0;
+    Quantity taker_buy = 0;
+    for (size_t i = begin; i < end; ++i) {
+        high = std::max(high, price[i]);
+        low = std::min(low, price[i]);
+        volume += qty[i];
+        quote_volume += quote_qty[i];
+        taker_buy += qty[i] * (1 - buyer_maker[i]);  // branch-free, the flag is unpredictable
+    }
+
+    bar_.high = high;
+    bar_.low = low;
+    bar_.close = price[end - 1];
+    bar_.close_time = trades.timestamp[end - 1];
+    bar_.volume += volume;
+    bar_.quote_volume += quote_volume;
+    bar_.taker_buy_volume += taker_buy;
+    bar_.trade_count += end - begin;
+}
+
+Bar BarAccumulator::finish() const {
+    Bar bar = bar_;
+    if (bar.volume > 0) {
+        // Both volumes carry kQtyDecimals, so their ratio is in quote units;
+        // 128 bits keep a day's quote volume times the tick scale exact
+        const __int128 scaled = static_cast<__int128>(bar.quote_volume) * pow10(kPriceDecimals);
+        bar.vwap = static_cast<Price>((scaled + bar.volume / 2) / bar.volume);
+    } else {
+        bar.vwap = bar.close;  // zero-quantity prints only
+    }
+    return bar;
+}
+
+TimeBarPolicy::TimeBarPolicy(uint64_t interval_ms) : interval_ms_(interval_ms) {
+    if (interval_ms_ == 0) throw std::runtime_error("Bar interval must be positive");
+}
+
+size_t TimeBarPolicy::take(const TradeColumns& t, size_t i, size_t n, bool& closes) {
+    const size_t j = run_end(t.timestamp, i, n, end_);
+    closes = j < n;  // t.timestamp[j] is past the bar
+    return j - i;
+}
+
+TickBarPolicy::TickBarPolicy(uint64_t ticks) : ticks_(ticks) {
+    if (ticks_ == 0) throw std::runtime_error("Bar threshold must be positive");
+}
+
+TickImbalanceBarPolicy::TickImbalanceBarPolicy(double expected_ticks, double alpha)
+    : alpha_(alpha), expected_ticks_(expected_ticks), threshold_(expected_ticks) {
+    if (!(expected_ticks > 0) || !(alpha > 0 && alpha <= 1)) {
+        throw std::runtime_error("Tick imbalance bars need expected_ticks > 0 and 0 < alpha <= 1");
+    }
+}
+
+size_t TickImbalanceBarPolicy::take(const TradeColumns& t, size_t i, size_t n, bool& closes) {
+    const uint8_t* buyer_maker = t.is_buyer_maker;
+    for (size_t j = i; j < n; ++j) {
+        imbalance_ += buyer_maker[j] ? -1 : 1;
+        ++ticks_;
+        if (static_cast<double>(std::llabs(imbalance_)) >= threshold_) {
+            // Update the expectations with the bar just closed
+            const double ticks = static_cast<double>(ticks_);
+            expected_ticks_ += alpha_ * (ticks - expected_ticks_);
+            expected_sign_ += alpha_ * (static_cast<double>(imbalance_) / ticks - expected_sign_);
+            // At least one trade per bar
+            threshold_ = std::max(1.0, expected_ticks_ * std::fabs(expected_sign_));
+            closes = true;
+            return j + 1 - i;
+        }
+    }
+    closes = false;
+    return n - i;
+}
+
+std::string BarSpec::name() const {
+    const char* type_name = "time";
+    switch (type) {
+        case BarType::TIME: type_name = "time"; break;
+        case BarType::TICK: type_name = "tick"; break;
+        case BarType::VOLUME: type_name = "volume"; break;
+        case BarType::DOLLAR: type_name = "dollar"; break;
+        case BarType::TICK_IMBALANCE: type_name = "tick_imbalance"; break;
+    }
+    return std::string(type_name) + "-" + std::to_string(threshold);
+}
+
+namespace {
+
+template <typename Policy>
+std::vector<Bar> build_with(const TradeBatch& batch, Policy policy) {
+    BarBuilder<Policy> builder(std::move(policy));
+    std::vector<Bar> bars;
+    builder.add(batch, bars);
+    builder.flush(bars);
+    return bars;
+}
+
+}  // namespace
+
+std::vector<Bar> build_bars(const TradeBatch& batch, const BarSpec& spec) {
+    if (spec.threshold <= 0) throw std::runtime_error("Bar threshold must be positive: " + spec.name());
+
+    switch (spec.type) {
+        case BarType::TIME:
+            return build_with(batch, TimeBarPolicy(static_cast<uint64_t>(spec.threshold)));
+        case BarType::TICK:
+            return build_with(batch, TickBarPolicy(static_cast<uint64_t>(spec.threshold)));
+        case BarType::VOLUME:
+            return build_with(batch, VolumeBarPolicy(spec.threshold));
+        case BarType::DOLLAR:
+            return build_with(batch, DollarBarPolicy(spec.threshold));
+        case BarType::TICK_IMBALANCE:
+            return build_with(batch, TickImbalanceBarPolicy(static_cast<double>(spec.threshold)));
+    }
+    throw std::runtime_error("Unknown bar type");
+}
+
+std::vector<Bar> build_time_bars(const TradeBatch& batch, uint64_t interval_ms) {
+    return build_with(batch, TimeBarPolicy(interval_ms));
+}
+
+}  // namespace signalforge
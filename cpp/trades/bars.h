@@ -0,0 +1,286 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "trade_batch.h"
+
+namespace signalforge {
+
+// One OHLCV bar. Quantities are fixed point at kQtyDecimals, prices in
+// ticks like Trade.price.
+struct Bar {
+    uint64_t open_time;       // ms; interval start for time bars, else the first trade's timestamp
+    uint64_t close_time;      // ms; timestamp of the bar's last trade
+    Price open;
+    Price high;
+    Price low;
+    Price close;
+    Price vwap;               // quote_volume / volume, rounded to a tick
+    Quantity volume;          // base asset traded
+    Quantity quote_volume;    // quote asset traded
+    Quantity taker_buy_volume;  // base volume where the buyer was the aggressor
+    uint64_t trade_count;
+};
+
+// The columns bar building reads, borrowed from a TradeBatch or from a
+// single trade
+struct TradeColumns {
+    const uint64_t* timestamp;
+    const Price* price;
+    const Quantity* qty;
+    const Quantity* quote_qty;
+    const uint8_t* is_buyer_maker;
+    size_t size;
+
+    static TradeColumns of(const TradeBatch& batch) {
+        return {batch.timestamp.data(), batch.price.data(), batch.qty.data(),
+                batch.quote_qty.data(), batch.is_buyer_maker.data(), batch.size()};
+    }
+};
+
+// Running OHLCV of the bar being built. Runs of trades known to belong to
+// it are folded in column by column, in loops the compiler vectorizes.
+class BarAccumulator {
+public:
+    bool empty() const { return bar_.trade_count == 0; }
+    const Bar& bar() const { return bar_; }
+
+    // Starts a new bar; open_time is chosen by the bar policy
+    void start(uint64_t open_time);
+
+    // Folds trades [begin, end) into the bar
+    void add_run(const TradeColumns& trades, size_t begin, size_t end);
+
+    // The finished bar, with vwap filled in
+    Bar finish() const;
+
+private:
+    Bar bar_{};
+};
+
+// Bar policies decide where bars end; BarBuilder does the rest. A policy
+// provides
+//   uint64_t open(const TradeColumns&, size_t i)
+//       called with the first trade of each bar; returns its open_time
+//   size_t take(const TradeColumns&, size_t i, size_t n, bool& closes)
+//       how many trades from i on belong to the open bar, at most n - i;
+//       closes is set when the bar is complete after them. It may return 0
+//       with closes set only when trade i must start the next bar.
+// and keeps whatever running state it needs between calls.
+
+// Epoch-aligned bars of a fixed interval. Trades earlier than the open bar,
+// which Binance data does not contain, are folded into it.
+class TimeBarPolicy {
+public:
+    // interval_ms must be positive
+    explicit TimeBarPolicy(uint64_t interval_ms);
+
+    uint64_t open(const TradeColumns& t, size_t i) {
+        const uint64_t open_time = t.timestamp[i] - t.timestamp[i] % interval_ms_;
+        end_ = open_time + interval_ms_;
+        return open_time;
+    }
+
+    size_t take(const TradeColumns& t, size_t i, size_t n, bool& closes);
+
+    uint64_t interval_ms() const { return interval_ms_; }
+
+private:
+    uint64_t interval_ms_;
+    uint64_t end_ = 0;  // exclusive end of the open bar's interval
+};
+
+// A bar every `ticks` trades
+class TickBarPolicy {
+public:
+    // ticks must be positive
+    explicit TickBarPolicy(uint64_t ticks);
+
+    uint64_t open(const TradeColumns& t, size_t i) {
+        left_ = ticks_;
+        return t.timestamp[i];
+    }
+
+    size_t take(const TradeColumns&, size_t i, size_t n, bool& closes) {
+        const size_t k = n - i < left_ ? n - i : static_cast<size_t>(left_);
+        left_ -= k;
+        closes = left_ == 0;
+        return k;
+    }
+
+private:
+    uint64_t ticks_;
+    uint64_t left_ = 0;
+};
+
+// A bar closes on the trade that brings the summed column to the
+// threshold: base volume for volume bars, quote volume for dollar bars
+template <const Quantity* TradeColumns::*Column>
+class SumBarPolicy {
+public:
+    // threshold must be positive
+    explicit SumBarPolicy(Quantity threshold) : threshold_(threshold) {
+        if (threshold_ <= 0) throw std::runtime_error("Bar threshold must be positive");
+    }
+
+    uint64_t open(const TradeColumns& t, size_t i) {
+        left_ = threshold_;
+        return t.timestamp[i];
+    }
+
+    size_t take(const TradeColumns& t, size_t i, size_t n, bool& closes) {
+        const Quantity* v = t.*Column;
+        size_t j = i;
+        // Skip whole blocks that stay under the threshold with vectorized
+        // sums, then find the closing trade one by one
+        for (; j + 8 <= n; j += 8) {
+            Quantity block = 0;
+            for (size_t k = 0; k < 8; ++k) block += v[j + k];
+            if (block >= left_) break;
+            left_ -= block;
+        }
+        for (; j < n; ++j) {
+            left_ -= v[j];
+            if (left_ <= 0) {
+                closes = true;
+                return j + 1 - i;
+            }
+        }
+        closes = false;
+        return n - i;
+    }
+
+private:
+    Quantity threshold_;
+    Quantity left_ = 0;
+};
+
+using VolumeBarPolicy = SumBarPolicy<&TradeColumns::qty>;
+using DollarBarPolicy = SumBarPolicy<&TradeColumns::quote_qty>;
+
+// Tick imbalance bars (Lopez de Prado): a bar closes once the signed trade
+// count |sum b_t| reaches E[T] * |E[b]|, both expectations being EWMAs over
+// past bars. b_t is +1 for a buyer-initiated trade and -1 otherwise, read
+// from the aggressor flag Binance records rather than the tick rule. The
+// first bar's threshold is expected_ticks.
+class TickImbalanceBarPolicy {
+public:
+    static constexpr double kDefaultAlpha = 0.1;
+
+    // expected_ticks must be positive; alpha is the EWMA weight of the
+    // latest bar
+    explicit TickImbalanceBarPolicy(double expected_ticks, double alpha = kDefaultAlpha);
+
+    uint64_t open(const TradeColumns& t, size_t i) {
+        imbalance_ = 0;
+        ticks_ = 0;
+        return t.timestamp[i];
+    }
+
+    size_t take(const TradeColumns& t, size_t i, size_t n, bool& closes);
+
+    // Current close threshold on |sum b_t|
+    double threshold() const { return threshold_; }
+
+private:
+    double alpha_;
+    double expected_ticks_;
+    double expected_sign_ = 1.0;  // EWMA of the mean b_t per bar
+    double threshold_;
+    int64_t imbalance_ = 0;
+    uint64_t ticks_ = 0;
+};
+
+// Streaming bar builder. Trades arrive in timestamp order, in batches of
+// any size or one at a time; every way of splitting the same trades emits
+// the same bars. Quiet periods produce no empty bars.
+template <typename Policy>
+class BarBuilder {
+public:
+    explicit BarBuilder(Policy policy) : policy_(std::move(policy)) {}
+
+    const Policy& policy() const { return policy_; }
+
+    // Adds trades, appending every bar they complete to out
+    void add(const TradeColumns& trades, std::vector<Bar>& out) {
+        size_t i = 0;
+        const size_t n = trades.size;
+        while (i < n) {
+            if (acc_.empty()) acc_.start(policy_.open(trades, i));
+
+            bool closes = false;
+            const size_t k = policy_.take(trades, i, n, closes);
+            acc_.add_run(trades, i, i + k);
+            i += k;
+            if (closes) {
+                out.push_back(acc_.finish());
+                acc_.start(0);
+            }
+        }
+    }
+
+    void add(const TradeBatch& batch, std::vector<Bar>& out) { add(TradeColumns::of(batch), out); }
+
+    // Adds one trade; returns true and sets out when a bar was completed
+    bool add(const TradeRow& trade, Bar& out) {
+        const uint8_t buyer_maker = trade.is_buyer_maker;
+        const TradeColumns one{&trade.timestamp, &trade.price, &trade.qty, &trade.quote_qty, &buyer_maker, 1};
+        scratch_.clear();
+        add(one, scratch_);
+        if (scratch_.empty()) return false;
+        out = scratch_.back();  // one trade completes at most one bar
+        return true;
+    }
+
+    // Emits the open bar, if any, e.g. at the end of a day
+    bool flush(Bar& out) {
+        if (acc_.empty()) return false;
+        out = acc_.finish();
+        acc_.start(0);
+        return true;
+    }
+
+    void flush(std::vector<Bar>& out) {
+        Bar bar;
+        if (flush(bar)) out.push_back(bar);
+    }
+
+private:
+    Policy policy_;
+    BarAccumulator acc_;
+    std::vector<Bar> scratch_;
+};
+
+class TimeBarBuilder : public BarBuilder<TimeBarPolicy> {
+public:
+    explicit TimeBarBuilder(uint64_t interval_ms) : BarBuilder(TimeBarPolicy(interval_ms)) {}
+
+    uint64_t interval_ms() const { return policy().interval_ms(); }
+};
+
+// Runtime choice of bar type, e.g. per symbol
+enum class BarType : uint32_t {
+    TIME,            // threshold: interval in ms
+    TICK,            // threshold: trades per bar
+    VOLUME,          // threshold: base volume, kQtyDecimals
+    DOLLAR,          // threshold: quote volume, kQtyDecimals
+    TICK_IMBALANCE,  // threshold: initial expected trades per bar
+};
+
+struct BarSpec {
+    BarType type = BarType::TIME;
+    int64_t threshold = 60 * 1000;  // minute bars
+
+    // e.g. "time-60000", used in cache file names
+    std::string name() const;
+};
+
+// Bars for a whole batch in one pass; the last bar is included.
+// Throws std::runtime_error on a non-positive threshold.
+std::vector<Bar> build_bars(const TradeBatch& batch, const BarSpec& spec);
+std::vector<Bar> build_time_bars(const TradeBatch& batch, uint64_t interval_ms);
+
+}  // namespace signalforge
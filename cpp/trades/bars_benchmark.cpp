@@ -0,0 +1,92 @@
+// Bar building over a day-sized TradeBatch: time bars from the batch
+// builder, which finds bar boundaries on the timestamp column and
+// aggregates runs column by column, against feeding the same trades one
+// row at a time; then every bar type at roughly minute-bar density.
+//
+// Run: bazel run -c opt //cpp/trades:bars_benchmark
+
+#include "bars.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+namespace signalforge {
+namespace {
+
+const TradeBatch& trades() {
+    static const TradeBatch batch = [] {
+        std::mt19937_64 rng(7);
+        std::uniform_int_distribution<int> step(-50, 50);
+        std::uniform_int_distribution<int> gap(0, 160);
+        std::uniform_int_distribution<Quantity> qty(1, 50000000);
+        std::bernoulli_distribution seller(0.5);
+
+        TradeBatch b;
+        const size_t n = 1000000;  // about a day of BTCUSDT
+        b.reserve(n);
+        Price price = 4250000;
+        uint64_t ts = 1705276800000;
+        for (size_t i = 0; i < n; ++i) {
+            price += step(rng);
+            ts += static_cast<uint64_t>(gap(rng));
+            const Quantity q = qty(rng);
+            b.push_back({i, price, q, price * q / 100, ts, seller(rng), true});
+        }
+        return b;
+    }();
+    return batch;
+}
+
+void BM_TimeBarsBatch(benchmark::State& state) {
+    const TradeBatch& batch = trades();
+    const uint64_t interval = static_cast<uint64_t>(state.range(0));
+    for (auto _ : state) {
+        auto bars = build_time_bars(batch, interval);
+        benchmark::DoNotOptimize(bars.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size()));
+}
+BENCHMARK(BM_TimeBarsBatch)->Arg(1000)->Arg(60000)->Arg(3600000)->Unit(benchmark::kMillisecond);
+
+void BM_TimeBarsPerTrade(benchmark::State& state) {
+    const TradeBatch& batch = trades();
+    const uint64_t interval = static_cast<uint64_t>(state.range(0));
+    for (auto _ : state) {
+        TimeBarBuilder builder(interval);
+        std::vector<Bar> bars;
+        Bar bar;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (builder.add(batch.row(i), bar)) bars.push_back(bar);
+        }
+        if (builder.flush(bar)) bars.push_back(bar);
+        benchmark::DoNotOptimize(bars.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size()));
+}
+BENCHMARK(BM_TimeBarsPerTrade)->Arg(1000)->Arg(60000)->Arg(3600000)->Unit(benchmark::kMillisecond);
+
+// Thresholds giving about 1440 bars over the day, like minute bars. The
+// synthetic flow is balanced, so imbalance bars grow long and few.
+void BM_Bars(benchmark::State& state) {
+    const TradeBatch& batch = trades();
+    static const BarSpec specs[] = {
+        {BarType::TIME, 60000},
+        {BarType::TICK, 700},
+        {BarType::VOLUME, 175 * 100000000LL},
+        {BarType::DOLLAR, 7400000 * 100000000LL},
+        {BarType::TICK_IMBALANCE, 30},
+    };
+    const BarSpec& spec = specs[state.range(0)];
+    state.SetLabel(spec.name());
+    size_t count = 0;
+    for (auto _ : state) {
+        auto bars = build_bars(batch, spec);
+        count = bars.size();
+        benchmark::DoNotOptimize(bars.data());
+    }
+    state.counters["bars"] = static_cast<double>(count);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size()));
+}
+BENCHMARK(BM_Bars)->DenseRange(0, 4)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace signalforge
@@ -0,0 +1,271 @@
+#include "bars.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <random>
+
+namespace signalforge {
+
+namespace {
+
+TradeBatch random_trades(size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> step(-20, 20);
+    std::uniform_int_distribution<int> gap(0, 40);
+    std::uniform_int_distribution<int> burst(0, 99);
+    std::uniform_int_distribution<Quantity> qty(1, 50000000);
+
+    TradeBatch batch;
+    Price price = 4250000;
+    uint64_t ts = 1705276800000;
+    for (size_t i = 0; i < n; ++i) {
+        price += step(rng);
+        ts += static_cast<uint64_t>(gap(rng));
+        if (burst(rng) == 0) ts += 5000;  // quiet stretches leave empty intervals
+        const Quantity q = qty(rng);
+        batch.push_back({1000 + i, price, q, price * q / 100, ts, (i % 3) == 0, true});
+    }
+    return batch;
+}
+
+Bar make_bar(const std::vector<TradeRow>& rows, uint64_t open_time) {
+    Bar bar{};
+    bar.open_time = open_time;
+    bar.open = rows.front().price;
+    bar.close = rows.back().price;
+    bar.close_time = rows.back().timestamp;
+    bar.high = bar.low = rows.front().price;
+    for (const TradeRow& r : rows) {
+        bar.high = std::max(bar.high, r.price);
+        bar.low = std::min(bar.low, r.price);
+        bar.volume += r.qty;
+        bar.quote_volume += r.quote_qty;
+        if (!r.is_buyer_maker) bar.taker_buy_volume += r.qty;
+    }
+    bar.trade_count = rows.size();
+    const __int128 quote = bar.quote_volume;
+    bar.vwap = bar.volume > 0 ? static_cast<Price>((quote * 100 + bar.volume / 2) / bar.volume) : bar.close;
+    return bar;
+}
+
+// Straightforward bars: group rows by bucket
+std::vector<Bar> reference_bars(const TradeBatch& batch, uint64_t interval_ms) {
+    std::map<uint64_t, std::vector<TradeRow>> buckets;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        buckets[batch.timestamp[i] / interval_ms].push_back(batch.row(i));
+    }
+
+    std::vector<Bar> bars;
+    for (const auto& [bucket, rows] : buckets) {
+        bars.push_back(make_bar(rows, bucket * interval_ms));
+    }
+    return bars;
+}
+
+// Bars closing after each row for which closes(row) is true; closes sees
+// the rows of the open bar so far
+template <typename Closes>
+std::vector<Bar> reference_threshold_bars(const TradeBatch& batch, Closes closes) {
+    std::vector<Bar> bars;
+    std::vector<TradeRow> rows;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        rows.push_back(batch.row(i));
+        if (closes(rows)) {
+            bars.push_back(make_bar(rows, rows.front().timestamp));
+            rows.clear();
+        }
+    }
+    if (!rows.empty()) bars.push_back(make_bar(rows, rows.front().timestamp));
+    return bars;
+}
+
+// Feeds batch in random chunk sizes, including empty chunks
+template <typename Policy>
+std::vector<Bar> build_chunked(const TradeBatch& batch, Policy policy, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<size_t> len(0, 300);
+    BarBuilder<Policy> builder(std::move(policy));
+    std::vector<Bar> bars;
+    for (size_t i = 0; i < batch.size();) {
+        const size_t end = std::min(batch.size(), i + len(rng));
+        TradeBatch chunk;
+        for (size_t k = i; k < end; ++k) chunk.push_back(batch.row(k));
+        builder.add(chunk, bars);
+        i = end;
+    }
+    builder.flush(bars);
+    return bars;
+}
+
+template <typename Policy>
+std::vector<Bar> build_per_trade(const TradeBatch& batch, Policy policy) {
+    BarBuilder<Policy> builder(std::move(policy));
+    std::vector<Bar> bars;
+    Bar bar;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (builder.add(batch.row(i), bar)) bars.push_back(bar);
+    }
+    if (builder.flush(bar)) bars.push_back(bar);
+    return bars;
+}
+
+void expect_same(const std::vector<Bar>& got, const std::vector<Bar>& want) {
+    ASSERT_EQ(got.size(), want.size());
+    for (size_t i = 0; i < got.size(); ++i) {
+        EXPECT_EQ(got[i].open_time, want[i].open_time) << "bar " << i;
+        EXPECT_EQ(got[i].close_time, want[i].close_time) << "bar " << i;
+        EXPECT_EQ(got[i].open, want[i].open) << "bar " << i;
+        EXPECT_EQ(got[i].high, want[i].high) << "bar " << i;
+        EXPECT_EQ(got[i].low, want[i].low) << "bar " << i;
+        EXPECT_EQ(got[i].close, want[i].close) << "bar " << i;
+        EXPECT_EQ(got[i].vwap, want[i].vwap) << "bar " << i;
+        EXPECT_EQ(got[i].volume, want[i].volume) << "bar " << i;
+        EXPECT_EQ(got[i].quote_volume, want[i].quote_volume) << "bar " << i;
+        EXPECT_EQ(got[i].taker_buy_volume, want[i].taker_buy_volume) << "bar " << i;
+        EXPECT_EQ(got[i].trade_count, want[i].trade_count) << "bar " << i;
+    }
+}
+
+}  // namespace
+
+TEST(TimeBarsTest, Ohlcv) {
+    TradeBatch batch;
+    // trade_id, price, qty, quote_qty, time, is_buyer_maker, is_best_match
+    batch.push_back({1, 10000, 100000000, 10000000000, 60000, false, true});  // 1 @ 100.00
+    batch.push_back({2, 10300, 300000000, 30900000000, 60500, true, true});   // 3 @ 103.00
+    batch.push_back({3, 9900, 100000000, 9900000000, 119999, false, true});   // 1 @ 99.00
+    batch.push_back({4, 10100, 200000000, 20200000000, 180000, false, true});  // next bar, after a gap
+
+    const auto bars = build_time_bars(batch, 60000);
+    ASSERT_EQ(bars.size(), 2);
+
+    const Bar& bar = bars[0];
+    EXPECT_EQ(bar.open_time, 60000);
+    EXPECT_EQ(bar.close_time, 119999);
+    EXPECT_EQ(bar.open, 10000);
+    EXPECT_EQ(bar.high, 10300);
+    EXPECT_EQ(bar.low, 9900);
+    EXPECT_EQ(bar.close, 9900);
+    EXPECT_EQ(bar.volume, 500000000);
+    EXPECT_EQ(bar.quote_volume, 50800000000);
+    EXPECT_EQ(bar.taker_buy_volume, 200000000);
+    EXPECT_EQ(bar.vwap, 10160);  // 508 / 5
+    EXPECT_EQ(bar.trade_count, 3);
+
+    EXPECT_EQ(bars[1].open_time, 180000);
+    EXPECT_EQ(bars[1].open, 10100);
+    EXPECT_EQ(bars[1].close, 10100);
+    EXPECT_EQ(bars[1].trade_count, 1);
+}
+
+TEST(TimeBarsTest, MatchesReferenceAtAnyInterval) {
+    const TradeBatch batch = random_trades(20000, 3);
+    for (uint64_t interval : {1ULL, 7ULL, 1000ULL, 60000ULL, 3600000ULL}) {
+        expect_same(build_time_bars(batch, interval), reference_bars(batch, interval));
+    }
+}
+
+TEST(TimeBarsTest, ChunkedAndPerTradeFeedsAgree) {
+    const TradeBatch batch = random_trades(5000, 11);
+    const auto want = build_time_bars(batch, 1000);
+
+    expect_same(build_chunked(batch, TimeBarPolicy(1000), 4), want);
+    expect_same(build_per_trade(batch, TimeBarPolicy(1000)), want);
+}
+
+TEST(TimeBarsTest, LateTradeJoinsOpenBar) {
+    TradeBatch batch;
+    batch.push_back({1, 100, 1, 1, 60500, false, true});
+    batch.push_back({2, 90, 1, 1, 59000, false, true});  // earlier than the open bar
+    batch.push_back({3, 110, 1, 1, 61000, false, true});
+
+    const auto bars = build_time_bars(batch, 60000);
+    ASSERT_EQ(bars.size(), 1);
+    EXPECT_EQ(bars[0].open_time, 60000);
+    EXPECT_EQ(bars[0].low, 90);
+    EXPECT_EQ(bars[0].trade_count, 3);
+}
+
+TEST(TimeBarsTest, EmptyInputAndZeroInterval) {
+    EXPECT_TRUE(build_time_bars(TradeBatch{}, 1000).empty());
+
+    TimeBarBuilder builder(1000);
+    Bar bar;
+    EXPECT_FALSE(builder.flush(bar));
+
+    EXPECT_THROW(TimeBarBuilder(0), std::runtime_error);
+}
+
+TEST(ThresholdBarsTest, TickBars) {
+    const TradeBatch batch = random_trades(5003, 21);
+    const auto want = reference_threshold_bars(batch, [](const auto& rows) { return rows.size() == 100; });
+    ASSERT_EQ(want.size(), 51);
+
+    expect_same(build_bars(batch, {BarType::TICK, 100}), want);
+    expect_same(build_chunked(batch, TickBarPolicy(100), 1), want);
+    expect_same(build_per_trade(batch, TickBarPolicy(100)), want);
+}
+
+TEST(ThresholdBarsTest, VolumeAndDollarBars) {
+    const TradeBatch batch = random_trades(20000, 22);
+    const Quantity volume = 5 * 100000000LL;          // 5 units of base
+    const Quantity dollars = 200000 * 100000000LL;    // 200k of quote
+
+    auto sum_reaches = [](Quantity TradeRow::*column, Quantity threshold) {
+        return [column, threshold](const std::vector<TradeRow>& rows) {
+            Quantity sum = 0;
+            for (const TradeRow& r : rows) sum += r.*column;
+            return sum >= threshold;
+        };
+    };
+
+    const auto want_volume = reference_threshold_bars(batch, sum_reaches(&TradeRow::qty, volume));
+    ASSERT_GT(want_volume.size(), 100);
+    for (size_t i = 0; i + 1 < want_volume.size(); ++i) ASSERT_GE(want_volume[i].volume, volume);
+    expect_same(build_bars(batch, {BarType::VOLUME, volume}), want_volume);
+    expect_same(build_chunked(batch, VolumeBarPolicy(volume), 2), want_volume);
+    expect_same(build_per_trade(batch, VolumeBarPolicy(volume)), want_volume);
+
+    const auto want_dollar = reference_threshold_bars(batch, sum_reaches(&TradeRow::quote_qty, dollars));
+    ASSERT_GT(want_dollar.size(), 100);
+    expect_same(build_bars(batch, {BarType::DOLLAR, dollars}), want_dollar);
+    expect_same(build_chunked(batch, DollarBarPolicy(dollars), 3), want_dollar);
+}
+
+TEST(ThresholdBarsTest, TickImbalanceBars) {
+    // One-sided flow: every trade a buy, so bars close every E[T] trades
+    TradeBatch buys;
+    for (uint64_t i = 0; i < 40; ++i) buys.push_back({i, 100, 1, 1, 1000 + i, false, true});
+    const auto bars = build_bars(buys, {BarType::TICK_IMBALANCE, 4});
+    ASSERT_EQ(bars.size(), 10);
+    for (const Bar& bar : bars) EXPECT_EQ(bar.trade_count, 4);
+
+    // Perfectly alternating flow never builds an imbalance of 4
+    TradeBatch balanced;
+    for (uint64_t i = 0; i < 40; ++i) balanced.push_back({i, 100, 1, 1, 1000 + i, i % 2 == 0, true});
+    ASSERT_EQ(build_bars(balanced, {BarType::TICK_IMBALANCE, 4}).size(), 1);
+
+    // The threshold adapts to the flow and splitting the input changes nothing
+    const TradeBatch batch = random_trades(20000, 23);
+    const auto want = build_bars(batch, {BarType::TICK_IMBALANCE, 50});
+    ASSERT_GT(want.size(), 10);
+    expect_same(build_chunked(batch, TickImbalanceBarPolicy(50), 5), want);
+    expect_same(build_per_trade(batch, TickImbalanceBarPolicy(50)), want);
+
+    TickImbalanceBarPolicy policy(50);
+    EXPECT_DOUBLE_EQ(policy.threshold(), 50);
+    EXPECT_THROW(TickImbalanceBarPolicy(0), std::runtime_error);
+    EXPECT_THROW(TickImbalanceBarPolicy(10, 0), std::runtime_error);
+}
+
+TEST(ThresholdBarsTest, SpecNamesAndValidation) {
+    EXPECT_EQ((BarSpec{BarType::TIME, 60000}.name()), "time-60000");
+    EXPECT_EQ((BarSpec{BarType::TICK_IMBALANCE, 50}.name()), "tick_imbalance-50");
+    EXPECT_EQ((BarSpec{}.name()), "time-60000");
+
+    const TradeBatch batch = random_trades(10, 1);
+    EXPECT_THROW(build_bars(batch, {BarType::VOLUME, 0}), std::runtime_error);
+    EXPECT_THROW(build_bars(batch, {BarType::TICK, -5}), std::runtime_error);
+}
+
+}  // namespace signalforge
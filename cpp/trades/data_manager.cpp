@@ -1,20 +1,102 @@
 #include "data_manager.h"
+#include "trade_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
 #include <filesystem>
+#include <optional>
 #include <stdexcept>
 #include <sstream>
+#include <thread>
 
 namespace signalforge {
 
-DataManager::DataManager(const std::string& data_dir)
-    : data_dir_(data_dir), last_stats_{0, 0, 0.0} {}
+DataManager::DataManager(const std::string& data_dir, bool use_cache)
+    : data_dir_(data_dir), use_cache_(use_cache), last_stats_{0, 0, 0.0, false} {}
 
 std::string DataManager::get_file_path(const std::string& symbol, const std::string& date) const {
-    // Build path: data_dir/SYMBOL/trades-YYYY-MM-DD.csv
+    // Build path: data_dir/SYMBOL/trades-YYYY-MM-DD.csv, or .zip when only
+    // the archive was kept
     std::ostringstream path;
-    path << data_dir_ << "/" << symbol << "/trades-" << date << ".csv";
+    path << data_dir_ << "/" << symbol << "/trades-" << date;
+    const std::string csv = path.str() + ".csv";
+    const std::string zip = path.str() + ".zip";
+    return !std::filesystem::exists(csv) && std::filesystem::exists(zip) ? zip : csv;
+}
+
+std::string DataManager::get_cache_path(const std::string& symbol, const std::string& date) const {
+    // Build path: data_dir/SYMBOL/trades-YYYY-MM-DD.sftc
+    std::ostringstream path;
+    path << data_dir_ << "/" << symbol << "/trades-" << date << ".sftc";
     return path.str();
 }
 
+std::string DataManager::get_bar_cache_path(const std::string& symbol, const std::string& date,
+                                            const BarSpec& spec) const {
+    // Build path: data_dir/SYMBOL/bars-YYYY-MM-DD-<type>-<threshold>.sfbr
+    std::ostringstream path;
+    path << data_dir_ << "/" << symbol << "/bars-" << date << "-" << spec.name() << ".sfbr";
+    return path.str();
+}
+
+const BarSpec& DataManager::bar_spec(const std::string& symbol) const {
+    const auto it = bar_specs_.find(symbol);
+    return it != bar_specs_.end() ? it->second : default_bar_spec_;
+}
+
+namespace {
+
+// Days since 1970-01-01 for a proleptic Gregorian date, and back
+int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+std::string civil_from_days(int64_t z) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+
+    char buf[48];  // sized for any int64 year, keeps -Wformat-truncation quiet
+    std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u", static_cast<long long>(y), m, d);
+    return buf;
+}
+
+int64_t parse_date(const std::string& date) {
+    unsigned y, m, d;
+    char tail;
+    if (date.size() != 10 || std::sscanf(date.c_str(), "%4u-%2u-%2u%c", &y, &m, &d, &tail) != 3 ||
+        m < 1 || m > 12 || d < 1 || d > 31) {
+        throw std::runtime_error("Invalid date (expected YYYY-MM-DD): " + date);
+    }
+    const int64_t days = days_from_civil(y, m, d);
+    if (civil_from_days(days) != date) {
+        throw std::runtime_error("Invalid date (expected YYYY-MM-DD): " + date);
+    }
+    return days;
+}
+
+}  // namespace
+
+std::vector<std::string> DataManager::dates_between(const std::string& start, const std::string& end) {
+    std::vector<std::string> dates;
+    for (int64_t day = parse_date(start), last = parse_date(end); day <= last; ++day) {
+        dates.push_back(civil_from_days(day));
+    }
+    return dates;
+}
+
 bool DataManager::has_data(const std::string& symbol, const std::string& date) const {
     return std::filesystem::exists(get_file_path(symbol, date));
 }
@@ -22,7 +104,7 @@ bool DataManager::has_data(const std::string& symbol, const std::string& date) c
 std::vector<Trade> DataManager::sample_trades(
     const std::vector<Trade>& raw_trades,
     Granularity granularity
-) {
+) const {
     if (granularity == Granularity::RAW || raw_trades.empty()) {
         return raw_trades;
     }
@@ -30,42 +112,17 @@ std::vector<Trade> DataManager::sample_trades(
     std::vector<Trade> sampled;
     sampled.reserve(raw_trades.size() / 10);  // Estimate
 
-    uint64_t time_interval_ms;
-    switch (granularity) {
-        case Granularity::PER_SECOND:
-            time_interval_ms = 1000;  // 1 second
-            break;
-        case Granularity::PER_MINUTE:
-            time_interval_ms = 60 * 1000;  // 60 seconds
-            break;
-        case Granularity::PER_HOUR:
-            time_interval_ms = 60 * 60 * 1000;  // 3600 seconds
-            break;
-        case Granularity::PER_DAY:
-            time_interval_ms = 24 * 60 * 60 * 1000;  // 86400 seconds
-            break;
-        default:
-            return raw_trades;
-    }
-
-    uint64_t last_bucket = 0;
+    TradeSampler sampler(granularity);
     for (const auto& trade : raw_trades) {
-        uint64_t current_bucket = trade.timestamp / time_interval_ms;
-
-        if (current_bucket != last_bucket) {
+        if (sampler.keep(trade)) {
             sampled.push_back(trade);
-            last_bucket = current_bucket;
         }
     }
 
     return sampled;
 }
 
-std::vector<Trade> DataManager::load_day(
-    const std::string& symbol,
-    const std::string& date,
-    Granularity granularity
-) {
+std::string DataManager::existing_file_path(const std::string& symbol, const std::string& date) const {
     std::string file_path = get_file_path(symbol, date);
 
     // Check if file exists
@@ -73,23 +130,201 @@ std::vector<Trade> DataManager::load_day(
         throw std::runtime_error(
             "Data file not found: " + file_path +
             "\n\nTo download: visit https://data.binance.vision/?prefix=data/spot/daily/trades/" + symbol + "/"
-            "\nOr run: wget https://data.binance.vision/data/spot/daily/trades/" + symbol + "/" + symbol + "-trades-" + date + ".zip"
+            "\nOr run: scripts/download_binance_data.sh " + symbol + " --start " + date + " --end " + date
         );
     }
+    return file_path;
+}
 
-    // Load raw trades
-    auto raw_trades = csv_loader_.load(file_path);
+std::vector<Trade> DataManager::load_day(
+    const std::string& symbol,
+    const std::string& date,
+    Granularity granularity
+) {
+    return load_day_with(csv_loader_, symbol, date, granularity, last_stats_);
+}
 
-    // Sample if needed
-    auto sampled_trades = sample_trades(raw_trades, granularity);
+std::vector<Trade> DataManager::load_day_with(
+    TradeCsvLoader& csv_loader,
+    const std::string& symbol,
+    const std::string& date,
+    Granularity granularity,
+    Stats& stats
+) const {
+    const std::string file_path = existing_file_path(symbol, date);
+
+    // Load raw trades, from the cache when it matches the CSV
+    std::vector<Trade> raw_trades;
+    bool from_cache = false;
+    if (use_cache_) {
+        const std::string cache_path = get_cache_path(symbol, date);
+        const TradeCacheSource source = TradeCacheSource::of(file_path);
+        from_cache = read_trade_cache(cache_path, source, raw_trades);
+        if (!from_cache) {
+            raw_trades = csv_loader.load(file_path);
+            // Best effort: an unwritable data dir just means no cache
+            write_trade_cache(cache_path, raw_trades, source);
+        }
+    } else {
+        raw_trades = csv_loader.load(file_path);
+    }
+
+    // Sample if needed; RAW hands the loaded vector over as is
+    const size_t raw_count = raw_trades.size();
+    std::vector<Trade> sampled_trades = granularity == Granularity::RAW
+        ? std::move(raw_trades)
+        : sample_trades(raw_trades, granularity);
 
     // Update stats
-    last_stats_.raw_trade_count = raw_trades.size();
-    last_stats_.sampled_trade_count = sampled_trades.size();
-    last_stats_.sampling_ratio = raw_trades.empty() ? 0.0 :
-        static_cast<double>(sampled_trades.size()) / raw_trades.size();
+    stats.raw_trade_count = raw_count;
+    stats.sampled_trade_count = sampled_trades.size();
+    stats.sampling_ratio = raw_count == 0 ? 0.0 :
+        static_cast<double>(sampled_trades.size()) / raw_count;
+    stats.from_cache = from_cache;
 
     return sampled_trades;
 }
 
+TradeBatch DataManager::load_day_batch(
+    const std::string& symbol,
+    const std::string& date,
+    Granularity granularity
+) {
+    TradeBatch trades = csv_loader_.load_batch(existing_file_path(symbol, date));
+    const size_t raw_count = trades.size();
+
+    if (granularity != Granularity::RAW) {
+        // First trade of each bucket, deciding on timestamps alone
+        std::vector<uint32_t> rows;
+        TradeSampler sampler(granularity);
+        const uint64_t* ts = trades.timestamp.data();
+        for (size_t i = 0; i < raw_count; ++i) {
+            if (sampler.keep(ts[i])) rows.push_back(static_cast<uint32_t>(i));
+        }
+        trades.keep_rows(rows);
+    }
+
+    last_stats_.raw_trade_count = raw_count;
+    last_stats_.sampled_trade_count = trades.size();
+    last_stats_.sampling_ratio = raw_count == 0 ? 0.0 :
+        static_cast<double>(trades.size()) / raw_count;
+    last_stats_.from_cache = false;
+
+    return trades;
+}
+
+std::vector<Bar> DataManager::load_bars(const std::string& symbol, const std::string& date,
+                                       const BarSpec& spec) {
+    const std::string file_path = existing_file_path(symbol, date);
+    if (spec.threshold <= 0) throw std::runtime_error("Bar threshold must be positive: " + spec.name());
+
+    std::vector<Bar> bars;
+    const std::string cache_path = get_bar_cache_path(symbol, date, spec);
+    std::optional<TradeCacheSource> source;
+    if (use_cache_) {
+        source = TradeCacheSource::of(file_path);
+        if (read_bar_cache(cache_path, spec, *source, bars)) return bars;
+    }
+
+    bars = build_bars(csv_loader_.load_batch(file_path), spec);
+
+    // Best effort, like the trade cache
+    if (source) write_bar_cache(cache_path, bars, spec, *source);
+    return bars;
+}
+
+std::vector<Trade> DataManager::load_window(const std::string& symbol, uint64_t from_ts, uint64_t to_ts) {
+    constexpr uint64_t kDayMs = 24 * 60 * 60 * 1000;
+
+    std::vector<Trade> trades;
+    bool from_cache = true;
+    for (uint64_t day = from_ts / kDayMs; from_ts < to_ts && day <= (to_ts - 1) / kDayMs; ++day) {
+        const std::string date = civil_from_days(static_cast<int64_t>(day));
+        if (!has_data(symbol, date)) continue;
+
+        if (use_cache_) {
+            TradeCacheReader reader;
+            if (reader.open(get_cache_path(symbol, date), TradeCacheSource::of(get_file_path(symbol, date)))) {
+                const size_t begin = reader.find(from_ts);
+                const size_t end = reader.find(to_ts);
+                reader.seek(begin);
+                reader.read(trades, end - begin);
+                continue;
+            }
+        }
+
+        // No usable cache: load the whole day, which also writes the cache
+        Stats day_stats{};
+        const std::vector<Trade> day_trades = load_day_with(csv_loader_, symbol, date, Granularity::RAW, day_stats);
+        from_cache = from_cache && day_stats.from_cache;
+        const auto by_time = [](const Trade& t, uint64_t ts) { return t.timestamp < ts; };
+        const auto begin = std::lower_bound(day_trades.begin(), day_trades.end(), from_ts, by_time);
+        const auto end = std::lower_bound(begin, day_trades.end(), to_ts, by_time);
+        trades.insert(trades.end(), begin, end);
+    }
+
+    last_stats_.raw_trade_count = trades.size();
+    last_stats_.sampled_trade_count = trades.size();
+    last_stats_.sampling_ratio = trades.empty() ? 0.0 : 1.0;
+    last_stats_.from_cache = from_cache;
+    return trades;
+}
+
+std::vector<DataManager::DayTrades> DataManager::load_range(
+    const std::string& symbol,
+    const std::string& start_date,
+    const std::string& end_date,
+    Granularity granularity,
+    size_t threads
+) {
+    std::vector<DayTrades> days;
+    for (const std::string& date : dates_between(start_date, end_date)) {
+        if (has_data(symbol, date)) days.push_back({date, {}, {0, 0, 0.0, false}});
+    }
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, days.size());
+
+    // Workers claim days in date order; each slot is written by one worker
+    std::atomic<size_t> next_day{0};
+    std::vector<std::exception_ptr> errors(days.size());
+    auto work = [&] {
+        TradeCsvLoader csv_loader;
+        for (size_t i; (i = next_day.fetch_add(1, std::memory_order_relaxed)) < days.size();) {
+            try {
+                days[i].trades = load_day_with(csv_loader, symbol, days[i].date, granularity, days[i].stats);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    if (threads <= 1) {
+        work();
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (size_t t = 1; t < threads; ++t) pool.emplace_back(work);
+        work();
+        for (std::thread& thread : pool) thread.join();
+    }
+
+    // The earliest failing day wins, whatever the thread timing
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    Stats total{0, 0, 0.0, !days.empty()};
+    for (const DayTrades& day : days) {
+        total.raw_trade_count += day.stats.raw_trade_count;
+        total.sampled_trade_count += day.stats.sampled_trade_count;
+        total.from_cache = total.from_cache && day.stats.from_cache;
+    }
+    total.sampling_ratio = total.raw_trade_count == 0 ? 0.0 :
+        static_cast<double>(total.sampled_trade_count) / total.raw_trade_count;
+    last_stats_ = total;
+
+    return days;
+}
+
 }  // namespace signalforge
@@ -1,61 +1,163 @@
 #pragma once
+#include <map>
 #include <string>
 #include <vector>
+#include "trade_batch.h"
 #include "trade_csv_loader.h"
+#include "trade_sampler.h"
+#include "bars.h"
 
 namespace signalforge {
 
 // Manages loading and sampling of historical trade data
 class DataManager {
 public:
-    enum class Granularity {
-        RAW,         // All trades (no sampling)
-        PER_SECOND,  // 1 trade per second
-        PER_MINUTE,  // 1 trade per minute (recommended)
-        PER_HOUR,    // 1 trade per hour
-        PER_DAY      // 1 trade per day (OHLC equivalent)
-    };
+    using Granularity = signalforge::Granularity;
 
     // Constructor with data directory path
     // Default: "data" (relative to working directory)
-    explicit DataManager(const std::string& data_dir = "data");
+    // use_cache: keep a binary trade cache next to each CSV (see trade_cache.h)
+    explicit DataManager(const std::string& data_dir = "data", bool use_cache = true);
 
     // Load trades for a specific day with optional sampling
     // date: Format "YYYY-MM-DD" (e.g., "2024-01-15")
     // symbol: Trading pair (e.g., "BTCUSDT")
     // granularity: Sampling rate
     // Returns: Vector of trades (sampled if granularity != RAW)
+    // The first load of a day writes a binary cache; later loads map the
+    // cache instead of parsing the CSV, as long as the CSV's size and mtime
+    // are unchanged.
     std::vector<Trade> load_day(
         const std::string& symbol,
         const std::string& date,
         Granularity granularity = Granularity::PER_MINUTE
     );
 
-    // Get the file path for a specific day's data
-    // Returns: Full path to CSV file (e.g., "data/BTCUSDT/trades-2024-01-15.csv")
+    // load_day keeping every column (see trade_batch.h). Sampling reads the
+    // timestamp column only. Always parses the CSV, since the binary cache
+    // holds just Trade's columns; last_load_stats().from_cache is false.
+    TradeBatch load_day_batch(
+        const std::string& symbol,
+        const std::string& date,
+        Granularity granularity = Granularity::PER_MINUTE
+    );
+
+    // Bars (OHLCV, VWAP, trade count; see bars.h) of one day. Bars are
+    // built in one pass over the day's columns and cached next to the CSV
+    // per spec, so later calls read them directly. Each day is built on
+    // its own: the last bar of a day is flushed partial, e.g. a 7-minute
+    // bar or a volume bar short of its threshold.
+    // Throws std::runtime_error if the file is missing or the threshold
+    // is not positive.
+    std::vector<Bar> load_bars(const std::string& symbol, const std::string& date, const BarSpec& spec);
+
+    // Time bars at any interval, e.g. 60000 for minute bars
+    std::vector<Bar> load_bars(const std::string& symbol, const std::string& date, uint64_t interval_ms) {
+        return load_bars(symbol, date, BarSpec{BarType::TIME, static_cast<int64_t>(interval_ms)});
+    }
+
+    // Bars with the symbol's configured spec (see set_bar_spec)
+    std::vector<Bar> load_bars(const std::string& symbol, const std::string& date) {
+        return load_bars(symbol, date, bar_spec(symbol));
+    }
+
+    // Per-symbol bar type and threshold, e.g. volume bars of 100 BTC for
+    // BTCUSDT but 1000 ETH for ETHUSDT. Symbols without one use the
+    // default spec, minute bars unless set_default_bar_spec changes it.
+    void set_bar_spec(const std::string& symbol, const BarSpec& spec) { bar_specs_[symbol] = spec; }
+    void set_default_bar_spec(const BarSpec& spec) { default_bar_spec_ = spec; }
+    const BarSpec& bar_spec(const std::string& symbol) const;
+
+    // Raw trades with from_ts <= timestamp < to_ts (Unix ms), across as
+    // many UTC days as the window spans; days without data are skipped.
+    // With the cache, each day is entered by a binary search of the
+    // cache's timestamp index, so only the pages covering the window are
+    // read; a day without a valid cache is parsed once to build it.
+    // Throws std::runtime_error if a day's file cannot be read.
+    std::vector<Trade> load_window(const std::string& symbol, uint64_t from_ts, uint64_t to_ts);
+
+    // Get the file path for a specific day's data: the CSV if present,
+    // else the Binance zip it came in, which loads stream-decompress (see
+    // TradeCsvReader); the CSV path when neither exists
+    // Returns: e.g., "data/BTCUSDT/trades-2024-01-15.csv" or
+    // "data/BTCUSDT/trades-2024-01-15.zip"
     std::string get_file_path(const std::string& symbol, const std::string& date) const;
 
+    // Get the path of the binary cache for a specific day's data
+    // Returns: e.g., "data/BTCUSDT/trades-2024-01-15.sftc"
+    std::string get_cache_path(const std::string& symbol, const std::string& date) const;
+
+    // Get the path of the bar cache for a day and spec
+    // Returns: e.g., "data/BTCUSDT/bars-2024-01-15-time-60000.sfbr"
+    std::string get_bar_cache_path(const std::string& symbol, const std::string& date, const BarSpec& spec) const;
+
     // Check if data file exists for a given day
     bool has_data(const std::string& symbol, const std::string& date) const;
 
+    bool use_cache() const { return use_cache_; }
+
+    // Every date from start to end inclusive, both "YYYY-MM-DD"
+    // Throws std::runtime_error on a malformed date
+    static std::vector<std::string> dates_between(const std::string& start, const std::string& end);
+
     // Get statistics about loaded data
     struct Stats {
         size_t raw_trade_count;
         size_t sampled_trade_count;
         double sampling_ratio;  // sampled / raw
+        bool from_cache;        // raw trades came from the binary cache
     };
+    // After load_range: totals over the range, from_cache if every day was
     Stats last_load_stats() const { return last_stats_; }
 
+    // One day of a load_range result
+    struct DayTrades {
+        std::string date;
+        std::vector<Trade> trades;
+        Stats stats;
+    };
+
+    // Load every day from start to end inclusive that has data, with up to
+    // `threads` days parsed concurrently (0: one per hardware thread).
+    // Each worker has its own CSV loader; results are in date order and
+    // identical to calling load_day for each date. Days without a data file
+    // are left out. If loading any day fails, the error of the earliest
+    // such day is rethrown once all workers are done.
+    std::vector<DayTrades> load_range(
+        const std::string& symbol,
+        const std::string& start_date,
+        const std::string& end_date,
+        Granularity granularity = Granularity::PER_MINUTE,
+        size_t threads = 0
+    );
+
 private:
     std::string data_dir_;
+    bool use_cache_;
     TradeCsvLoader csv_loader_;
     Stats last_stats_;
+    std::map<std::string, BarSpec> bar_specs_;
+    BarSpec default_bar_spec_;
+
+    // Path of the day's CSV; throws std::runtime_error with download hints
+    // when it does not exist
+    std::string existing_file_path(const std::string& symbol, const std::string& date) const;
+
+    // load_day with a caller-owned loader and stats; safe to run
+    // concurrently for different days
+    std::vector<Trade> load_day_with(
+        TradeCsvLoader& csv_loader,
+        const std::string& symbol,
+        const std::string& date,
+        Granularity granularity,
+        Stats& stats
+    ) const;
 
     // Sample trades according to granularity
     std::vector<Trade> sample_trades(
         const std::vector<Trade>& raw_trades,
         Granularity granularity
-    );
+    ) const;
 };
 
 }  // namespace signalforge
@@ -1,4 +1,5 @@
 #include "data_manager.h"
+#include "cpp/io/zip_writer.h"
 #include <gtest/gtest.h>
 #include <fstream>
 #include <filesystem>
@@ -173,4 +174,297 @@ TEST_F(DataManagerTest, EmptyFile) {
     EXPECT_DOUBLE_EQ(stats.sampling_ratio, 0.0);
 }
 
+TEST_F(DataManagerTest, SecondLoadUsesCache) {
+    DataManager dm(test_dir_.string());
+
+    auto first = dm.load_day("BTCUSDT", "2024-01-15", DataManager::Granularity::RAW);
+    EXPECT_FALSE(dm.last_load_stats().from_cache);
+    EXPECT_TRUE(std::filesystem::exists(dm.get_cache_path("BTCUSDT", "2024-01-15")));
+
+    // A different granularity reuses the cached raw trades
+    auto sampled = dm.load_day("BTCUSDT", "2024-01-15", DataManager::Granularity::PER_MINUTE);
+    EXPECT_TRUE(dm.last_load_stats().from_cache);
+    EXPECT_EQ(dm.last_load_stats().raw_trade_count, 10);
+    EXPECT_EQ(sampled.size(), 1);
+
+    auto second = dm.load_day("BTCUSDT", "2024-01-15", DataManager::Granularity::RAW);
+    EXPECT_TRUE(dm.last_load_stats().from_cache);
+    ASSERT_EQ(second.size(), first.size());
+    for (size_t i = 0; i < first.size(); ++i) {
+        EXPECT_EQ(second[i].trade_id, first[i].trade_id);
+        EXPECT_EQ(second[i].price, first[i].price);
+        EXPECT_EQ(second[i].timestamp, first[i].timestamp);
+    }
+}
+
+TEST_F(DataManagerTest, ModifiedCsvInvalidatesCache) {
+    DataManager dm(test_dir_.string());
+    dm.load_day("BTCUSDT", "2024-01-15", DataManager::Granularity::RAW);
+
+    std::ofstream file((test_dir_ / "BTCUSDT" / "trades-2024-01-15.csv").string(), std::ios::app);
+    file << "2000,43000.00,0.1,4300.0,1640000020000,true\n";
+    file.close();
+
+    auto trades = dm.load_day("BTCUSDT", "2024-01-15", DataManager::Granularity::RAW);
+    EXPECT_FALSE(dm.last_load_stats().from_cache);
+    ASSERT_EQ(trades.size(), 11);
+    EXPECT_EQ(trades.back().trade_id, 2000);
+
+    dm.load_day("BTCUSDT", "2024-01-15", DataManager::Granularity::RAW);
+    EXPECT_TRUE(dm.last_load_stats().from_cache);
+}
+
+TEST_F(DataManagerTest, CacheCanBeDisabled) {
+    DataManager dm(test_dir_.string(), false);
+
+    dm.load_day("BTCUSDT", "2024-01-15", DataManager::Granularity::RAW);
+    dm.load_day("BTCUSDT", "2024-01-15", DataManager::Granularity::RAW);
+
+    EXPECT_FALSE(dm.last_load_stats().from_cache);
+    EXPECT_FALSE(std::filesystem::exists(dm.get_cache_path("BTCUSDT", "2024-01-15")));
+}
+
+TEST_F(DataManagerTest, LoadRangeMatchesLoadDay) {
+    // 2024-01-16 stays missing; 2024-01-17..19 get 10 trades each
+    for (int d = 17; d <= 19; ++d) {
+        std::ofstream file((test_dir_ / "BTCUSDT" / ("trades-2024-01-" + std::to_string(d) + ".csv")).string());
+        file << "trade_id,price,qty,quote_qty,time,is_buyer_maker\n";
+        for (int i = 0; i < 10; i++) {
+            file << (d * 100 + i) << "," << (42500 + d) << ".00,0.1,4250.0,"
+                 << (1640000000000 + d * 86400000ULL + i * 30000) << ",true\n";
+        }
+    }
+
+    for (size_t threads : {1, 2, 3, 8}) {
+        DataManager dm(test_dir_.string(), false);
+        auto days = dm.load_range("BTCUSDT", "2024-01-14", "2024-01-19", DataManager::Granularity::PER_MINUTE, threads);
+
+        ASSERT_EQ(days.size(), 4) << threads << " threads";
+        const std::vector<std::string> dates = {"2024-01-15", "2024-01-17", "2024-01-18", "2024-01-19"};
+        size_t raw = 0, sampled = 0;
+        DataManager reference(test_dir_.string(), false);
+        for (size_t i = 0; i < days.size(); ++i) {
+            EXPECT_EQ(days[i].date, dates[i]);
+            auto want = reference.load_day("BTCUSDT", dates[i], DataManager::Granularity::PER_MINUTE);
+            ASSERT_EQ(days[i].trades.size(), want.size());
+            for (size_t k = 0; k < want.size(); ++k) {
+                EXPECT_EQ(days[i].trades[k].trade_id, want[k].trade_id);
+            }
+            EXPECT_EQ(days[i].stats.raw_trade_count, reference.last_load_stats().raw_trade_count);
+            EXPECT_EQ(days[i].stats.sampled_trade_count, want.size());
+            raw += days[i].stats.raw_trade_count;
+            sampled += want.size();
+        }
+
+        auto stats = dm.last_load_stats();
+        EXPECT_EQ(stats.raw_trade_count, raw);
+        EXPECT_EQ(stats.sampled_trade_count, sampled);
+        EXPECT_DOUBLE_EQ(stats.sampling_ratio, static_cast<double>(sampled) / raw);
+        EXPECT_FALSE(stats.from_cache);
+    }
+}
+
+TEST_F(DataManagerTest, LoadRangeUsesCache) {
+    DataManager dm(test_dir_.string());
+    dm.load_range("BTCUSDT", "2024-01-15", "2024-01-16", DataManager::Granularity::RAW, 2);
+    EXPECT_FALSE(dm.last_load_stats().from_cache);
+
+    auto days = dm.load_range("BTCUSDT", "2024-01-15", "2024-01-16", DataManager::Granularity::RAW, 2);
+    ASSERT_EQ(days.size(), 1);
+    EXPECT_TRUE(days[0].stats.from_cache);
+    EXPECT_TRUE(dm.last_load_stats().from_cache);
+    EXPECT_EQ(days[0].trades.size(), 10);
+}
+
+TEST_F(DataManagerTest, LoadRangeEmptyAndErrors) {
+    DataManager dm(test_dir_.string(), false);
+
+    EXPECT_TRUE(dm.load_range("ETHUSDT", "2024-01-15", "2024-01-20").empty());
+    EXPECT_EQ(dm.last_load_stats().raw_trade_count, 0);
+    EXPECT_THROW(dm.load_range("BTCUSDT", "2024-01-15", "20240120"), std::runtime_error);
+
+    // An unreadable day fails the whole range
+    std::filesystem::create_directories(test_dir_ / "BTCUSDT" / "trades-2024-01-16.csv");
+    EXPECT_ANY_THROW(dm.load_range("BTCUSDT", "2024-01-15", "2024-01-16", DataManager::Granularity::RAW, 2));
+}
+
+TEST_F(DataManagerTest, LoadWindowAcrossDays) {
+    // 2024-01-17 and 2024-01-18, 3000 trades each, one every 20 s
+    const uint64_t day_ms = 86400000;
+    const uint64_t jan17 = 1705449600000;
+    std::vector<Trade> all;
+    for (int d = 0; d < 2; ++d) {
+        std::ofstream file((test_dir_ / "BTCUSDT" / ("trades-2024-01-1" + std::to_string(7 + d) + ".csv")).string());
+        file << "trade_id,price,qty,quote_qty,time,is_buyer_maker\n";
+        for (uint64_t i = 0; i < 3000; i++) {
+            const uint64_t id = d * 3000 + i;
+            const uint64_t ts = jan17 + d * day_ms + i * 20000;
+            file << id << "," << (42500 + i % 50) << ".00,0.1,4250.0," << ts << ",true\n";
+            all.push_back({id, static_cast<Price>((42500 + i % 50) * 100), ts});
+        }
+    }
+    auto window = [&](uint64_t from, uint64_t to) {
+        std::vector<Trade> want;
+        for (const Trade& t : all) {
+            if (t.timestamp >= from && t.timestamp < to) want.push_back(t);
+        }
+        return want;
+    };
+    auto expect_same = [](const std::vector<Trade>& got, const std::vector<Trade>& want) {
+        ASSERT_EQ(got.size(), want.size());
+        for (size_t i = 0; i < got.size(); ++i) {
+            EXPECT_EQ(got[i].trade_id, want[i].trade_id);
+            EXPECT_EQ(got[i].price, want[i].price);
+            EXPECT_EQ(got[i].timestamp, want[i].timestamp);
+        }
+    };
+
+    const std::vector<std::pair<uint64_t, uint64_t>> windows = {
+        {jan17 + 2 * 3600000, jan17 + 4 * 3600000},  // two hours
+        {jan17 + day_ms - 3600000, jan17 + day_ms + 3600000},  // across midnight
+        {jan17 - day_ms, jan17 + 3 * day_ms},        // past both ends, 2024-01-16 has no data
+    };
+    for (bool cache : {false, true}) {
+        DataManager dm(test_dir_.string(), cache);
+        for (int pass = 0; pass < 2; ++pass) {
+            for (const auto& [from, to] : windows) {
+                expect_same(dm.load_window("BTCUSDT", from, to), window(from, to));
+                EXPECT_EQ(dm.last_load_stats().raw_trade_count, window(from, to).size());
+                // The first pass builds the caches, the second enters
+                // every day through the cache index
+                if (pass == 1) {
+                    EXPECT_EQ(dm.last_load_stats().from_cache, cache);
+                }
+            }
+        }
+        EXPECT_TRUE(dm.load_window("BTCUSDT", jan17 + 10001, jan17 + 10001).empty());
+    }
+
+    // Unreadable day
+    std::filesystem::create_directories(test_dir_ / "BTCUSDT" / "trades-2024-01-16.csv");
+    DataManager dm(test_dir_.string());
+    EXPECT_ANY_THROW(dm.load_window("BTCUSDT", jan17 - 1000, jan17 + 1000));
+}
+
+TEST_F(DataManagerTest, LoadsZipWhenNoCsv) {
+    const auto csv = test_dir_ / "BTCUSDT" / "trades-2024-01-15.csv";
+    std::string content;
+    {
+        std::ifstream in(csv.string());
+        content.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    DataManager dm(test_dir_.string());
+    const auto want = DataManager(test_dir_.string(), false).load_day("BTCUSDT", "2024-01-15", Granularity::RAW);
+
+    // Only the archive, named as the download script keeps it
+    std::filesystem::remove(csv);
+    EXPECT_FALSE(dm.has_data("BTCUSDT", "2024-01-15"));
+    write_zip((test_dir_ / "BTCUSDT" / "trades-2024-01-15.zip").string(),
+              {{"BTCUSDT-trades-2024-01-15.csv", content}});
+    EXPECT_TRUE(dm.has_data("BTCUSDT", "2024-01-15"));
+    EXPECT_EQ(dm.get_file_path("BTCUSDT", "2024-01-15"),
+              (test_dir_ / "BTCUSDT" / "trades-2024-01-15.zip").string());
+
+    for (int pass = 0; pass < 2; ++pass) {
+        const auto trades = dm.load_day("BTCUSDT", "2024-01-15", Granularity::RAW);
+        EXPECT_EQ(dm.last_load_stats().from_cache, pass == 1);  // cache validated against the zip
+        ASSERT_EQ(trades.size(), want.size());
+        for (size_t i = 0; i < want.size(); ++i) {
+            EXPECT_EQ(trades[i].trade_id, want[i].trade_id);
+            EXPECT_EQ(trades[i].price, want[i].price);
+        }
+    }
+    EXPECT_EQ(dm.load_day_batch("BTCUSDT", "2024-01-15", Granularity::RAW).size(), want.size());
+
+    // The CSV wins when both exist
+    std::ofstream(csv.string()) << content;
+    EXPECT_EQ(dm.get_file_path("BTCUSDT", "2024-01-15"), csv.string());
+}
+
+TEST_F(DataManagerTest, LoadDayBatchMatchesLoadDay) {
+    DataManager dm(test_dir_.string(), false);
+
+    for (auto g : {DataManager::Granularity::RAW, DataManager::Granularity::PER_SECOND,
+                   DataManager::Granularity::PER_MINUTE}) {
+        auto trades = dm.load_day("BTCUSDT", "2024-01-15", g);
+        TradeBatch batch = dm.load_day_batch("BTCUSDT", "2024-01-15", g);
+
+        ASSERT_EQ(batch.size(), trades.size());
+        for (size_t i = 0; i < trades.size(); ++i) {
+            EXPECT_EQ(batch.trade_id[i], trades[i].trade_id);
+            EXPECT_EQ(batch.timestamp[i], trades[i].timestamp);
+            EXPECT_EQ(batch.qty[i], 10000000);  // 0.1
+            EXPECT_EQ(batch.is_buyer_maker[i], 1);
+        }
+        EXPECT_EQ(dm.last_load_stats().raw_trade_count, 10);
+        EXPECT_EQ(dm.last_load_stats().sampled_trade_count, trades.size());
+    }
+
+    EXPECT_THROW(dm.load_day_batch("BTCUSDT", "2024-01-16"), std::runtime_error);
+}
+
+TEST_F(DataManagerTest, LoadBarsBuildsThenCaches) {
+    DataManager dm(test_dir_.string());
+
+    // 10 trades one second apart: five 2-second bars
+    auto bars = dm.load_bars("BTCUSDT", "2024-01-15", 2000);
+    ASSERT_EQ(bars.size(), 5);
+    EXPECT_EQ(bars[0].open_time, 1640000000000);
+    EXPECT_EQ(bars[0].open, 4250000);
+    EXPECT_EQ(bars[0].close, 4250100);
+    EXPECT_EQ(bars[0].high, 4250100);
+    EXPECT_EQ(bars[0].low, 4250000);
+    EXPECT_EQ(bars[0].volume, 20000000);  // 2 x 0.1
+    EXPECT_EQ(bars[0].trade_count, 2);
+    EXPECT_TRUE(std::filesystem::exists(dm.get_bar_cache_path("BTCUSDT", "2024-01-15", BarSpec{BarType::TIME, 2000})));
+
+    // Served from the cache; identical to building from the batch
+    auto cached = dm.load_bars("BTCUSDT", "2024-01-15", 2000);
+    auto built = build_time_bars(dm.load_day_batch("BTCUSDT", "2024-01-15", DataManager::Granularity::RAW), 2000);
+    ASSERT_EQ(cached.size(), built.size());
+    for (size_t i = 0; i < built.size(); ++i) {
+        EXPECT_EQ(cached[i].open_time, built[i].open_time);
+        EXPECT_EQ(cached[i].close, built[i].close);
+        EXPECT_EQ(cached[i].vwap, built[i].vwap);
+    }
+
+    // One day bar, unlike PER_DAY sampling, covers every trade
+    auto day = dm.load_bars("BTCUSDT", "2024-01-15", 24 * 60 * 60 * 1000);
+    ASSERT_EQ(day.size(), 1);
+    EXPECT_EQ(day[0].open, 4250000);
+    EXPECT_EQ(day[0].close, 4250900);
+    EXPECT_EQ(day[0].trade_count, 10);
+
+    EXPECT_THROW(dm.load_bars("BTCUSDT", "2024-01-15", 0), std::runtime_error);
+    EXPECT_THROW(dm.load_bars("BTCUSDT", "2024-01-16", 60000), std::runtime_error);
+}
+
+TEST_F(DataManagerTest, BarSpecsPerSymbol) {
+    DataManager dm(test_dir_.string());
+    EXPECT_EQ(dm.bar_spec("BTCUSDT").type, BarType::TIME);
+    EXPECT_EQ(dm.bar_spec("BTCUSDT").threshold, 60000);
+
+    // Volume bars of 0.3 BTC: three 0.1 trades each
+    dm.set_bar_spec("BTCUSDT", {BarType::VOLUME, 30000000});
+    dm.set_default_bar_spec({BarType::TICK, 5});
+    EXPECT_EQ(dm.bar_spec("ETHUSDT").type, BarType::TICK);
+
+    auto bars = dm.load_bars("BTCUSDT", "2024-01-15");
+    ASSERT_EQ(bars.size(), 4);  // 3 + 3 + 3 + the partial last bar
+    EXPECT_EQ(bars[0].trade_count, 3);
+    EXPECT_EQ(bars[0].volume, 30000000);
+    EXPECT_EQ(bars[0].open_time, 1640000000000);
+    EXPECT_EQ(bars[3].trade_count, 1);
+    EXPECT_TRUE(std::filesystem::exists(
+        dm.get_bar_cache_path("BTCUSDT", "2024-01-15", BarSpec{BarType::VOLUME, 30000000})));
+
+    // Cached per spec: another spec builds its own
+    auto ticks = dm.load_bars("BTCUSDT", "2024-01-15", BarSpec{BarType::TICK, 5});
+    ASSERT_EQ(ticks.size(), 2);
+    EXPECT_EQ(ticks[1].close, 4250900);
+    EXPECT_EQ(dm.load_bars("BTCUSDT", "2024-01-15").size(), 4);
+
+    EXPECT_THROW(dm.load_bars("BTCUSDT", "2024-01-15", BarSpec{BarType::DOLLAR, 0}), std::runtime_error);
+}
+
 }  // namespace signalforge
@@ -0,0 +1,74 @@
+#include "day_prefetcher.h"
+#include <utility>
+
+namespace signalforge {
+
+DayPrefetcher::DayPrefetcher(const DataManager& data,
+                             const std::string& symbol,
+                             const std::string& start_date,
+                             const std::string& end_date,
+                             Granularity granularity,
+                             size_t depth,
+                             DayHook on_load)
+    : dates_(DataManager::dates_between(start_date, end_date)),
+      on_load_(std::move(on_load)),
+      queue_(depth),
+      worker_(&DayPrefetcher::run, this, data, symbol, granularity) {}
+
+DayPrefetcher::~DayPrefetcher() {
+    stop_.store(true, std::memory_order_relaxed);
+    worker_.join();
+}
+
+void DayPrefetcher::run(DataManager data, std::string symbol, Granularity granularity) {
+    for (const std::string& date : dates_) {
+        // Checked before every load, not only while the queue is full, so
+        // the destructor waits for at most the day in progress
+        if (stop_.load(std::memory_order_relaxed)) return;
+        if (on_load_) on_load_(date);
+
+        Slot slot;
+        slot.day.date = date;
+        try {
+            if (data.has_data(symbol, date)) {
+                slot.day.trades = data.load_day(symbol, date, granularity);
+                slot.day.stats = data.last_load_stats();
+                slot.day.available = true;
+            }
+        } catch (...) {
+            slot.error = std::current_exception();
+        }
+        const bool failed = static_cast<bool>(slot.error);
+
+        Backoff backoff;
+        while (!queue_.try_push(slot)) {
+            if (stop_.load(std::memory_order_relaxed)) return;
+            backoff.pause();
+        }
+        if (failed) return;
+    }
+}
+
+bool DayPrefetcher::next(PrefetchedDay& out) {
+    if (failed_ || consumed_ == dates_.size()) return false;
+
+    Slot slot;
+    if (!queue_.try_pop(slot)) {
+        const auto start = std::chrono::steady_clock::now();
+        Backoff backoff;
+        do {
+            backoff.pause();
+        } while (!queue_.try_pop(slot));
+        wait_time_ += std::chrono::steady_clock::now() - start;
+    }
+    ++consumed_;
+
+    if (slot.error) {
+        failed_ = true;
+        std::rethrow_exception(slot.error);
+    }
+    out = std::move(slot.day);
+    return true;
+}
+
+}  // namespace signalforge
@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "data_manager.h"
+#include "cpp/io/spsc_queue.h"
+
+namespace signalforge {
+
+// One day of a prefetched range
+struct PrefetchedDay {
+    std::string date;
+    bool available = false;  // false when the day has no data file
+    std::vector<Trade> trades;
+    DataManager::Stats stats{};
+};
+
+// Loads the days of a range on a worker thread, ahead of the consumer.
+//
+// While day N is replayed, day N+1 (up to `depth` days) is already being
+// read, from the binary cache or the CSV, by a private copy of the
+// DataManager. Finished days are handed over through a bounded lock-free
+// queue. There is a single worker and days are queued in date order, so
+// next() returns exactly what calling load_day for each date would.
+class DayPrefetcher {
+public:
+    static constexpr size_t kDefaultDepth = 2;
+
+    // Called on the worker thread as it starts loading each day, once the
+    // worker has decided not to stop
+    using DayHook = std::function<void(const std::string& date)>;
+
+    // Starts the worker. Throws std::runtime_error on a malformed date.
+    DayPrefetcher(const DataManager& data,
+                  const std::string& symbol,
+                  const std::string& start_date,
+                  const std::string& end_date,
+                  Granularity granularity = Granularity::PER_MINUTE,
+                  size_t depth = kDefaultDepth,
+                  DayHook on_load = {});
+
+    // Stops the worker, dropping days not taken yet
+    ~DayPrefetcher();
+
+    DayPrefetcher(const DayPrefetcher&) = delete;
+    DayPrefetcher& operator=(const DayPrefetcher&) = delete;
+
+    // Waits for the next day in date order, days without data included.
+    // Returns false after the last day. Rethrows an error the worker hit
+    // loading that day; later days are not loaded.
+    bool next(PrefetchedDay& out);
+
+    const std::vector<std::string>& dates() const { return dates_; }
+
+    // True once the destructor has asked the worker to stop
+    bool stopping() const { return stop_.load(std::memory_order_relaxed); }
+
+    // Total time next() spent waiting for the worker, i.e. load latency
+    // the consumer's own work did not hide
+    std::chrono::nanoseconds wait_time() const { return wait_time_; }
+
+private:
+    struct Slot {
+        PrefetchedDay day;
+        std::exception_ptr error;
+    };
+
+    void run(DataManager data, std::string symbol, Granularity granularity);
+
+    std::vector<std::string> dates_;
+    DayHook on_load_;
+    SpscQueue<Slot> queue_;
+    std::atomic<bool> stop_{false};
+    size_t consumed_ = 0;
+    bool failed_ = false;
+    std::chrono::nanoseconds wait_time_{0};
+    std::thread worker_;  // last, so it starts after everything above
+};
+
+}  // namespace signalforge
@@ -0,0 +1,158 @@
+#include "day_prefetcher.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace signalforge {
+
+class DayPrefetcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "day_prefetcher_test";
+        std::filesystem::remove_all(test_dir_);
+        std::filesystem::create_directories(test_dir_ / "BTCUSDT");
+
+        // 2024-01-17 is left without data
+        write_day("2024-01-15", 1000, 1705276800000);
+        write_day("2024-01-16", 2000, 1705363200000);
+        write_day("2024-01-18", 3000, 1705536000000);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    void write_day(const std::string& date, uint64_t first_id, uint64_t first_ts, int rows = 300) {
+        std::ofstream file((test_dir_ / "BTCUSDT" / ("trades-" + date + ".csv")).string());
+        file << "trade_id,price,qty,quote_qty,time,is_buyer_maker\n";
+        for (int i = 0; i < rows; i++) {
+            file << (first_id + i) << "," << (42500 + i) << ".00,0.1,4250.0,"
+                 << (first_ts + i * 1000) << ",true\n";
+        }
+    }
+
+    std::filesystem::path test_dir_;
+};
+
+TEST_F(DayPrefetcherTest, MatchesLoadDayInDateOrder) {
+    for (size_t depth : {1, 2, 8}) {
+        DataManager dm(test_dir_.string(), false);
+        DayPrefetcher prefetcher(dm, "BTCUSDT", "2024-01-15", "2024-01-18",
+                                 Granularity::PER_MINUTE, depth);
+        DataManager reference(test_dir_.string(), false);
+
+        PrefetchedDay day;
+        size_t i = 0;
+        while (prefetcher.next(day)) {
+            ASSERT_LT(i, prefetcher.dates().size());
+            const std::string& date = prefetcher.dates()[i++];
+            EXPECT_EQ(day.date, date);
+
+            ASSERT_EQ(day.available, reference.has_data("BTCUSDT", date)) << date;
+            if (!day.available) {
+                EXPECT_TRUE(day.trades.empty());
+                continue;
+            }
+
+            const auto want = reference.load_day("BTCUSDT", date, Granularity::PER_MINUTE);
+            ASSERT_EQ(day.trades.size(), want.size()) << date;
+            for (size_t k = 0; k < want.size(); ++k) {
+                EXPECT_EQ(day.trades[k].trade_id, want[k].trade_id);
+                EXPECT_EQ(day.trades[k].timestamp, want[k].timestamp);
+            }
+            EXPECT_EQ(day.stats.raw_trade_count, 300);
+            EXPECT_EQ(day.stats.sampled_trade_count, want.size());
+        }
+        EXPECT_EQ(i, 4);
+        EXPECT_FALSE(prefetcher.next(day));
+    }
+}
+
+TEST_F(DayPrefetcherTest, UsesTheCache) {
+    DataManager dm(test_dir_.string());
+    dm.load_day("BTCUSDT", "2024-01-16", Granularity::RAW);
+
+    DayPrefetcher prefetcher(dm, "BTCUSDT", "2024-01-15", "2024-01-16", Granularity::RAW);
+    PrefetchedDay day;
+    ASSERT_TRUE(prefetcher.next(day));
+    EXPECT_FALSE(day.stats.from_cache);
+    ASSERT_TRUE(prefetcher.next(day));
+    EXPECT_TRUE(day.stats.from_cache);
+    EXPECT_EQ(day.trades.size(), 300);
+}
+
+TEST_F(DayPrefetcherTest, StopsEarlyWithoutHanging) {
+    DataManager dm(test_dir_.string(), false);
+    {
+        // Worker blocks on the full queue until destruction
+        DayPrefetcher prefetcher(dm, "BTCUSDT", "2024-01-15", "2024-01-18", Granularity::RAW, 1);
+        PrefetchedDay day;
+        ASSERT_TRUE(prefetcher.next(day));
+        EXPECT_EQ(day.date, "2024-01-15");
+    }
+    {
+        DayPrefetcher untouched(dm, "BTCUSDT", "2024-01-15", "2024-01-18", Granularity::RAW, 1);
+    }
+}
+
+// With room left in the queue the worker still stops at the next day:
+// it is held inside 2024-01-16 until the destructor has asked it to stop,
+// finishes that day, and never starts 2024-01-17 or 2024-01-18
+TEST_F(DayPrefetcherTest, StopsBeforeLoadingFurtherDays) {
+    DataManager dm(test_dir_.string(), false);
+    std::atomic<DayPrefetcher*> self{nullptr};
+    std::atomic<bool> holding{false};
+    std::mutex mutex;
+    std::vector<std::string> started;
+    {
+        DayPrefetcher prefetcher(
+            dm, "BTCUSDT", "2024-01-15", "2024-01-18", Granularity::RAW, 8, [&](const std::string& date) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    started.push_back(date);
+                }
+                if (date != "2024-01-16") return;
+                holding.store(true);
+                DayPrefetcher* p;
+                while (!(p = self.load()) || !p->stopping()) std::this_thread::yield();
+            });
+        self.store(&prefetcher);
+
+        PrefetchedDay day;
+        ASSERT_TRUE(prefetcher.next(day));
+        EXPECT_EQ(day.date, "2024-01-15");
+        while (!holding.load()) std::this_thread::yield();
+    }
+    const std::vector<std::string> want = {"2024-01-15", "2024-01-16"};
+    EXPECT_EQ(started, want);
+}
+
+TEST_F(DayPrefetcherTest, RethrowsLoadErrors) {
+    // A directory where the CSV should be: has_data() but unreadable
+    std::filesystem::create_directories(test_dir_ / "BTCUSDT" / "trades-2024-01-17.csv");
+
+    DataManager dm(test_dir_.string(), false);
+    DayPrefetcher prefetcher(dm, "BTCUSDT", "2024-01-15", "2024-01-18", Granularity::RAW);
+
+    PrefetchedDay day;
+    ASSERT_TRUE(prefetcher.next(day));
+    ASSERT_TRUE(prefetcher.next(day));
+    EXPECT_EQ(day.date, "2024-01-16");
+    EXPECT_THROW(prefetcher.next(day), std::exception);
+    EXPECT_FALSE(prefetcher.next(day));
+}
+
+TEST_F(DayPrefetcherTest, EmptyRangeAndBadDates) {
+    DataManager dm(test_dir_.string(), false);
+    DayPrefetcher prefetcher(dm, "BTCUSDT", "2024-01-18", "2024-01-15");
+    PrefetchedDay day;
+    EXPECT_FALSE(prefetcher.next(day));
+
+    EXPECT_THROW(DayPrefetcher(dm, "BTCUSDT", "2024-13-01", "2024-01-15"), std::runtime_error);
+}
+
+}  // namespace signalforge
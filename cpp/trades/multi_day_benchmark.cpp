@@ -0,0 +1,141 @@
+// Multi-day loading: DataManager::load_range across thread counts, and
+// replay with and without DayPrefetcher. In the replay cases each day's
+// trades are fed through a stand-in for strategy work; with prefetching,
+// parsing the next day overlaps it. Last, a two-hour window of every day
+// read through the cache index against loading whole days and filtering.
+//
+// Run: bazel run -c opt //cpp/trades:multi_day_benchmark
+
+#include "day_prefetcher.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace signalforge {
+namespace {
+
+constexpr int kDays = 6;
+constexpr size_t kRowsPerDay = 300000;
+
+const std::string& data_dir() {
+    static const std::string dir = [] {
+        const auto root = std::filesystem::temp_directory_path() / "day_prefetcher_benchmark";
+        std::filesystem::create_directories(root / "BTCUSDT");
+        char row[128];
+        for (int d = 0; d < kDays; ++d) {
+            char date[16];
+            std::snprintf(date, sizeof(date), "2024-01-%02d", 10 + d);
+            std::ofstream out((root / "BTCUSDT" / (std::string("trades-") + date + ".csv")).string());
+            out << "trade_id,price,qty,quote_qty,time,is_buyer_maker,is_best_match\n";
+            const unsigned long long day_start = 1704844800000ULL + d * 86400000ULL;
+            for (size_t i = 0; i < kRowsPerDay; ++i) {
+                std::snprintf(row, sizeof(row), "%zu,%lld.%02d000000,0.01000000,425.0,%llu,True,True\n",
+                              d * kRowsPerDay + i, 42500LL + static_cast<long long>(i % 200), static_cast<int>(i % 100),
+                              day_start + i * 250);
+                out << row;
+            }
+        }
+        return root.string();
+    }();
+    return dir;
+}
+
+// Stand-in for strategy work, roughly as long as parsing the day
+uint64_t replay(const std::vector<Trade>& trades, int rounds) {
+    uint64_t h = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (const Trade& t : trades) {
+            h = (h ^ static_cast<uint64_t>(t.price)) * 0x100000001b3ULL + t.timestamp;
+        }
+    }
+    return h;
+}
+
+void BM_LoadRange(benchmark::State& state) {
+    DataManager dm(data_dir(), false);
+    size_t trades = 0;
+    for (auto _ : state) {
+        auto days = dm.load_range("BTCUSDT", "2024-01-10", "2024-01-15", Granularity::RAW,
+                                  static_cast<size_t>(state.range(0)));
+        trades = dm.last_load_stats().raw_trade_count;
+        benchmark::DoNotOptimize(days.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * trades));
+}
+BENCHMARK(BM_LoadRange)->Arg(1)->Arg(2)->Arg(4)->Arg(kDays)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_ReplaySerial(benchmark::State& state) {
+    DataManager dm(data_dir(), false);
+    const auto dates = DataManager::dates_between("2024-01-10", "2024-01-15");
+    for (auto _ : state) {
+        for (const std::string& date : dates) {
+            auto trades = dm.load_day("BTCUSDT", date, Granularity::RAW);
+            benchmark::DoNotOptimize(replay(trades, static_cast<int>(state.range(0))));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kDays * kRowsPerDay));
+}
+BENCHMARK(BM_ReplaySerial)->Arg(0)->Arg(20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_ReplayPrefetched(benchmark::State& state) {
+    DataManager dm(data_dir(), false);
+    double waited_ms = 0;
+    for (auto _ : state) {
+        DayPrefetcher prefetcher(dm, "BTCUSDT", "2024-01-10", "2024-01-15", Granularity::RAW);
+        PrefetchedDay day;
+        while (prefetcher.next(day)) {
+            benchmark::DoNotOptimize(replay(day.trades, static_cast<int>(state.range(0))));
+        }
+        waited_ms += std::chrono::duration<double, std::milli>(prefetcher.wait_time()).count();
+    }
+    state.counters["wait_ms"] = waited_ms / static_cast<double>(state.iterations());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kDays * kRowsPerDay));
+}
+BENCHMARK(BM_ReplayPrefetched)->Arg(0)->Arg(20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 10:00 to 12:00 of each day, the per-day slice of an event study
+constexpr uint64_t kWindowStart = 1704844800000ULL + 10 * 3600000ULL;
+constexpr uint64_t kWindowMs = 2 * 3600000ULL;
+
+void BM_WindowLoadWindow(benchmark::State& state) {
+    DataManager dm(data_dir());
+    dm.load_range("BTCUSDT", "2024-01-10", "2024-01-15", Granularity::RAW);  // build caches
+    size_t trades = 0;
+    for (auto _ : state) {
+        trades = 0;
+        for (int d = 0; d < kDays; ++d) {
+            const uint64_t from = kWindowStart + d * 86400000ULL;
+            auto window = dm.load_window("BTCUSDT", from, from + kWindowMs);
+            trades += window.size();
+            benchmark::DoNotOptimize(window.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * trades));
+}
+BENCHMARK(BM_WindowLoadWindow)->Unit(benchmark::kMillisecond);
+
+void BM_WindowLoadDayAndFilter(benchmark::State& state) {
+    DataManager dm(data_dir());
+    dm.load_range("BTCUSDT", "2024-01-10", "2024-01-15", Granularity::RAW);
+    size_t trades = 0;
+    for (auto _ : state) {
+        trades = 0;
+        for (int d = 0; d < kDays; ++d) {
+            char date[16];
+            std::snprintf(date, sizeof(date), "2024-01-%02d", 10 + d);
+            const uint64_t from = kWindowStart + d * 86400000ULL;
+            std::vector<Trade> window;
+            for (const Trade& t : dm.load_day("BTCUSDT", date, Granularity::RAW)) {
+                if (t.timestamp >= from && t.timestamp < from + kWindowMs) window.push_back(t);
+            }
+            trades += window.size();
+            benchmark::DoNotOptimize(window.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * trades));
+}
+BENCHMARK(BM_WindowLoadDayAndFilter)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace signalforge
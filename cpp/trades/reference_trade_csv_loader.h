@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "trade_csv_loader.h"
+
+namespace signalforge {
+
+// The original getline/stringstream/stod loader, kept as the behavioural
+// reference for TradeCsvLoader: parity tests compare the two on the same
+// files and the loader benchmark measures against it. Not for production
+// use, it allocates several strings per row.
+class ReferenceTradeCsvLoader {
+public:
+    // Same contract as TradeCsvLoader::load
+    std::vector<Trade> load(const std::string& filepath);
+
+    size_t skipped_rows() const { return skipped_rows_; }
+
+private:
+    size_t skipped_rows_ = 0;
+};
+
+}  // namespace signalforge
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "trade_csv_loader.h"
+
+namespace signalforge {
+
+// One row of a Binance trades file with every column kept
+struct TradeRow {
+    uint64_t trade_id;
+    Price price;          // ticks, kPriceDecimals
+    Quantity qty;         // base asset, kQtyDecimals
+    Quantity quote_qty;   // quote asset, kQtyDecimals
+    uint64_t timestamp;   // Unix time in milliseconds
+    bool is_buyer_maker;  // true when the seller was the aggressor
+    bool is_best_match;
+};
+
+// Struct-of-arrays trades: one vector per Binance column, all the same
+// length. Kernels read only the columns they use, e.g. sampling touches
+// timestamps alone, so their loops stay cache-dense; Trade remains the
+// three-column row for code that wants rows.
+struct TradeBatch {
+    std::vector<uint64_t> trade_id;
+    std::vector<Price> price;
+    std::vector<Quantity> qty;
+    std::vector<Quantity> quote_qty;
+    std::vector<uint64_t> timestamp;
+    std::vector<uint8_t> is_buyer_maker;  // 0 or 1
+    std::vector<uint8_t> is_best_match;   // 0 or 1; 0 when the file has no such column
+
+    size_t size() const { return timestamp.size(); }
+    bool empty() const { return timestamp.empty(); }
+
+    void reserve(size_t n) {
+        trade_id.reserve(n);
+        price.reserve(n);
+        qty.reserve(n);
+        quote_qty.reserve(n);
+        timestamp.reserve(n);
+        is_buyer_maker.reserve(n);
+        is_best_match.reserve(n);
+    }
+
+    void clear() {
+        trade_id.clear();
+        price.clear();
+        qty.clear();
+        quote_qty.clear();
+        timestamp.clear();
+        is_buyer_maker.clear();
+        is_best_match.clear();
+    }
+
+    void push_back(const TradeRow& row) {
+        trade_id.push_back(row.trade_id);
+        price.push_back(row.price);
+        qty.push_back(row.qty);
+        quote_qty.push_back(row.quote_qty);
+        timestamp.push_back(row.timestamp);
+        is_buyer_maker.push_back(row.is_buyer_maker);
+        is_best_match.push_back(row.is_best_match);
+    }
+
+    TradeRow row(size_t i) const {
+        return {trade_id[i], price[i], qty[i], quote_qty[i], timestamp[i],
+                is_buyer_maker[i] != 0, is_best_match[i] != 0};
+    }
+
+    Trade trade(size_t i) const { return {trade_id[i], price[i], timestamp[i]}; }
+
+    // Keeps only the given rows, in increasing order, compacting in place
+    void keep_rows(const std::vector<uint32_t>& rows) {
+        keep(trade_id, rows);
+        keep(price, rows);
+        keep(qty, rows);
+        keep(quote_qty, rows);
+        keep(timestamp, rows);
+        keep(is_buyer_maker, rows);
+        keep(is_best_match, rows);
+    }
+
+private:
+    template <typename T>
+    static void keep(std::vector<T>& column, const std::vector<uint32_t>& rows) {
+        for (size_t i = 0; i < rows.size(); ++i) column[i] = column[rows[i]];
+        column.resize(rows.size());
+    }
+};
+
+}  // namespace signalforge
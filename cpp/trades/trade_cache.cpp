@@ -0,0 +1,312 @@
+#include "trade_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <utility>
+
+namespace signalforge {
+
+namespace {
+
+constexpr uint64_t kMagic = 0x5345444152544653ULL;  // "SFTRADES"
+
+struct Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t count;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t first_trade_id;
+    uint64_t first_timestamp;
+    int64_t first_price;
+};
+static_assert(sizeof(Header) == 64, "cache header layout changed");
+
+constexpr size_t kColumns = 3;
+
+size_t index_entries(uint64_t count) {
+    return static_cast<size_t>((count + kTradeCacheIndexStride - 1) / kTradeCacheIndexStride);
+}
+
+// Offset of the index from the file start, i.e. the columns' end rounded
+// up to 8 bytes
+uint64_t index_offset(uint64_t count) {
+    return (sizeof(Header) + count * kColumns * sizeof(int32_t) + 7) / 8 * 8;
+}
+
+// Deltas are taken modulo 2^64 so decoding by unsigned addition restores
+// the exact value; they only have to fit int32 once read as signed.
+bool delta32(uint64_t from, uint64_t to, int32_t& out) {
+    const int64_t d = static_cast<int64_t>(to - from);
+    if (d < std::numeric_limits<int32_t>::min() || d > std::numeric_limits<int32_t>::max()) return false;
+    out = static_cast<int32_t>(d);
+    return true;
+}
+
+// Temp file next to path, unique per process and call, so concurrent
+// writers of one cache never write into each other's file
+std::string temp_path(const std::string& path) {
+    static std::atomic<uint64_t> counter{0};
+    return path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(counter.fetch_add(1));
+}
+
+// Writes header then body to a temp file and renames it over path, so
+// readers never see a partial file
+bool write_atomically(const std::string& path, const void* header, size_t header_size,
+                      const void* body, size_t body_size) {
+    const std::string tmp = temp_path(path);
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(static_cast<const char*>(header), static_cast<std::streamsize>(header_size));
+        file.write(static_cast<const char*>(body), static_cast<std::streamsize>(body_size));
+        if (!file) {
+            file.close();
+            std::remove(tmp.c_str());
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Maps a cache file, or returns nullopt when it is missing or unreadable
+std::optional<MappedFile> map_cache(const std::string& path) {
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) return std::nullopt;
+    try {
+        return MappedFile(path);
+    } catch (const std::runtime_error&) {
+        return std::nullopt;  // unreadable cache is just a miss
+    }
+}
+
+constexpr uint64_t kBarMagic = 0x3130535241424653ULL;  // "SFBARS01"
+
+struct BarHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t count;
+    uint64_t source_size;
+    int64_t source_mtime;
+    int64_t threshold;
+    uint32_t bar_type;
+    uint32_t bar_size;
+    uint64_t reserved;
+};
+static_assert(sizeof(BarHeader) == 64, "bar cache header layout changed");
+
+}  // namespace
+
+TradeCacheSource TradeCacheSource::of(const std::string& csv_path) {
+    TradeCacheSource source;
+    source.size = std::filesystem::file_size(csv_path);
+    source.mtime = static_cast<int64_t>(std::filesystem::last_write_time(csv_path).time_since_epoch().count());
+    return source;
+}
+
+bool write_trade_cache(const std::string& path, const std::vector<Trade>& trades, const TradeCacheSource& source) {
+    const size_t n = trades.size();
+    const size_t columns_end = (index_offset(n) - sizeof(Header)) / sizeof(int32_t);
+    const size_t entries = index_entries(n);
+    std::vector<int32_t> columns(columns_end + entries * sizeof(TradeCacheIndexEntry) / sizeof(int32_t), 0);
+    int32_t* ids = columns.data();
+    int32_t* times = ids + n;
+    int32_t* prices = times + n;
+
+    for (size_t i = 1; i < n; ++i) {
+        const Trade& prev = trades[i - 1];
+        const Trade& cur = trades[i];
+        if (!delta32(prev.trade_id, cur.trade_id, ids[i]) ||
+            !delta32(prev.timestamp, cur.timestamp, times[i]) ||
+            !delta32(static_cast<uint64_t>(prev.price), static_cast<uint64_t>(cur.price), prices[i])) {
+            return false;
+        }
+    }
+    for (size_t e = 0; e < entries; ++e) {
+        const Trade& t = trades[e * kTradeCacheIndexStride];
+        const TradeCacheIndexEntry entry{t.timestamp, t.trade_id, static_cast<uint64_t>(t.price)};
+        std::memcpy(columns.data() + columns_end + e * sizeof(entry) / sizeof(int32_t), &entry, sizeof(entry));
+    }
+
+    Header header{};
+    header.magic = kMagic;
+    header.version = kTradeCacheVersion;
+    header.header_size = sizeof(Header);
+    header.count = n;
+    header.source_size = source.size;
+    header.source_mtime = source.mtime;
+    if (n > 0) {
+        header.first_trade_id = trades[0].trade_id;
+        header.first_timestamp = trades[0].timestamp;
+        header.first_price = trades[0].price;
+    }
+
+    return write_atomically(path, &header, sizeof(header), columns.data(), columns.size() * sizeof(int32_t));
+}
+
+bool TradeCacheReader::open(const std::string& path, const TradeCacheSource& source) {
+    count_ = pos_ = index_size_ = 0;
+    file_ = map_cache(path);
+    if (!file_) return false;
+
+    const MappedFile& file = *file_;
+    Header header;
+    const bool valid = [&] {
+        if (file.size() < sizeof(Header)) return false;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (header.magic != kMagic || header.version != kTradeCacheVersion ||
+            header.header_size != sizeof(Header) ||
+            header.source_size != source.size || header.source_mtime != source.mtime) {
+            return false;
+        }
+        const uint64_t n = header.count;
+        return n <= (file.size() - sizeof(Header)) / (kColumns * sizeof(int32_t)) &&
+               file.size() == index_offset(n) + index_entries(n) * sizeof(TradeCacheIndexEntry);
+    }();
+    if (!valid) {
+        file_.reset();
+        return false;
+    }
+
+    file.advise_sequential();
+    count_ = header.count;
+    ids_ = reinterpret_cast<const int32_t*>(file.data() + sizeof(Header));
+    times_ = ids_ + count_;
+    prices_ = times_ + count_;
+    index_ = reinterpret_cast<const TradeCacheIndexEntry*>(file.data() + index_offset(count_));
+    index_size_ = index_entries(count_);
+    id_ = header.first_trade_id;
+    ts_ = header.first_timestamp;
+    price_ = static_cast<uint64_t>(header.first_price);
+    return true;
+}
+
+size_t TradeCacheReader::read(std::vector<Trade>& out, size_t max) {
+    const size_t n = std::min(max, remaining());
+    const size_t base = out.size();
+    out.resize(base + n);
+    Trade* dst = out.data() + base;
+
+    uint64_t id = id_;
+    uint64_t ts = ts_;
+    uint64_t price = price_;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t k = pos_ + i;
+        id += static_cast<uint64_t>(static_cast<int64_t>(ids_[k]));
+        ts += static_cast<uint64_t>(static_cast<int64_t>(times_[k]));
+        price += static_cast<uint64_t>(static_cast<int64_t>(prices_[k]));
+        dst[i] = {id, static_cast<Price>(price), ts};
+    }
+    id_ = id;
+    ts_ = ts;
+    price_ = price;
+    pos_ += n;
+    return n;
+}
+
+size_t TradeCacheReader::find(uint64_t timestamp) const {
+    // First indexed row at or after timestamp; the answer lies in the
+    // stride before it
+    const TradeCacheIndexEntry* const end = index_ + index_size_;
+    const TradeCacheIndexEntry* const after = std::partition_point(
+        index_, end, [timestamp](const TradeCacheIndexEntry& e) { return e.timestamp < timestamp; });
+    if (after == index_) return 0;
+
+    const size_t from = static_cast<size_t>(after - index_ - 1) * kTradeCacheIndexStride;
+    const size_t to = after == end ? count_ : from + kTradeCacheIndexStride;
+    uint64_t ts = after[-1].timestamp;
+    size_t row = from + 1;
+    for (; row < to; ++row) {
+        ts += static_cast<uint64_t>(static_cast<int64_t>(times_[row]));
+        if (ts >= timestamp) break;
+    }
+    return row;
+}
+
+void TradeCacheReader::seek(size_t row) {
+    if (!file_) return;
+    file_->advise_random();
+    pos_ = std::min(row, count_);
+    if (pos_ == count_) return;
+
+    // Running values are the trade before pos_: the indexed trade minus
+    // its own delta, then forward to pos_ - 1
+    const size_t from = pos_ / kTradeCacheIndexStride * kTradeCacheIndexStride;
+    const TradeCacheIndexEntry& entry = index_[pos_ / kTradeCacheIndexStride];
+    uint64_t id = entry.trade_id - static_cast<uint64_t>(static_cast<int64_t>(ids_[from]));
+    uint64_t ts = entry.timestamp - static_cast<uint64_t>(static_cast<int64_t>(times_[from]));
+    uint64_t price = entry.price - static_cast<uint64_t>(static_cast<int64_t>(prices_[from]));
+    for (size_t k = from; k < pos_; ++k) {
+        id += static_cast<uint64_t>(static_cast<int64_t>(ids_[k]));
+        ts += static_cast<uint64_t>(static_cast<int64_t>(times_[k]));
+        price += static_cast<uint64_t>(static_cast<int64_t>(prices_[k]));
+    }
+    id_ = id;
+    ts_ = ts;
+    price_ = price;
+}
+
+bool read_trade_cache(const std::string& path, const TradeCacheSource& source, std::vector<Trade>& out) {
+    TradeCacheReader reader;
+    if (!reader.open(path, source)) return false;
+
+    std::vector<Trade> trades;
+    trades.reserve(reader.size());
+    reader.read(trades, reader.size());
+    out = std::move(trades);
+    return true;
+}
+
+bool write_bar_cache(const std::string& path, const std::vector<Bar>& bars, const BarSpec& spec,
+                     const TradeCacheSource& source) {
+    BarHeader header{};
+    header.magic = kBarMagic;
+    header.version = kBarCacheVersion;
+    header.header_size = sizeof(BarHeader);
+    header.count = bars.size();
+    header.source_size = source.size;
+    header.source_mtime = source.mtime;
+    header.threshold = spec.threshold;
+    header.bar_type = static_cast<uint32_t>(spec.type);
+    header.bar_size = sizeof(Bar);
+    return write_atomically(path, &header, sizeof(header), bars.data(), bars.size() * sizeof(Bar));
+}
+
+bool read_bar_cache(const std::string& path, const BarSpec& spec, const TradeCacheSource& source,
+                    std::vector<Bar>& out) {
+    const std::optional<MappedFile> file = map_cache(path);
+    if (!file || file->size() < sizeof(BarHeader)) return false;
+
+    BarHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (header.magic != kBarMagic || header.version != kBarCacheVersion ||
+        header.header_size != sizeof(BarHeader) || header.bar_size != sizeof(Bar) ||
+        header.bar_type != static_cast<uint32_t>(spec.type) || header.threshold != spec.threshold ||
+        header.source_size != source.size || header.source_mtime != source.mtime ||
+        header.count != (file->size() - sizeof(BarHeader)) / sizeof(Bar) ||
+        file->size() != sizeof(BarHeader) + header.count * sizeof(Bar)) {
+        return false;
+    }
+
+    std::vector<Bar> bars(header.count);
+    std::memcpy(bars.data(), file->data() + sizeof(BarHeader), header.count * sizeof(Bar));
+    out = std::move(bars);
+    return true;
+}
+
+}  // namespace signalforge
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "bars.h"
+#include "trade_csv_loader.h"
+#include "cpp/io/mapped_file.h"
+
+namespace signalforge {
+
+// Size and modification time of the CSV a cache file was built from. A
+// cache is only used while both still match.
+struct TradeCacheSource {
+    uint64_t size = 0;
+    int64_t mtime = 0;  // filesystem clock ticks
+
+    // Throws std::filesystem::filesystem_error if the file cannot be stat'ed
+    static TradeCacheSource of(const std::string& csv_path);
+
+    bool operator==(const TradeCacheSource& o) const { return size == o.size && mtime == o.mtime; }
+};
+
+// Binary columnar cache of one day of trades.
+//
+// Layout (native little-endian): a 64-byte header holding the first
+// trade's values, then three int32 columns of deltas from the previous
+// trade: trade_id, timestamp and price ticks. That is 12 bytes per trade
+// against ~60 for the CSV, and decoding is a prefix sum over memory-mapped
+// columns with no parsing.
+//
+// A sparse index follows the columns, 8-byte aligned: the absolute
+// timestamp, trade_id and price of every kTradeCacheIndexStride-th trade.
+// Seeking binary-searches it and decodes at most one stride of deltas, so
+// reading a time window touches only the pages around that window.
+constexpr uint32_t kTradeCacheVersion = 2;
+constexpr size_t kTradeCacheIndexStride = 1024;  // one 4 KiB page of each delta column
+
+struct TradeCacheIndexEntry {
+    uint64_t timestamp;
+    uint64_t trade_id;
+    uint64_t price;
+};
+
+// Writes the cache atomically (temp file + rename). Returns false when
+// the file cannot be written or a delta does not fit 32 bits; callers can
+// just keep using the CSV.
+bool write_trade_cache(const std::string& path, const std::vector<Trade>& trades, const TradeCacheSource& source);
+
+// Incremental decoder over one cache file
+class TradeCacheReader {
+public:
+    // Maps and validates the file. Returns false when it is missing,
+    // truncated, from another version or built from a different source.
+    bool open(const std::string& path, const TradeCacheSource& source);
+
+    size_t size() const { return count_; }
+    size_t remaining() const { return count_ - pos_; }
+
+    // Appends up to max decoded trades to out; returns how many
+    size_t read(std::vector<Trade>& out, size_t max);
+
+    // Row of the first trade at or after timestamp, size() if none. Trades
+    // must be in timestamp order, as Binance files are.
+    size_t find(uint64_t timestamp) const;
+
+    // Makes row the next one read (row <= size()). Switches the mapping to
+    // random access, since a seeking reader rarely reads the whole file.
+    void seek(size_t row);
+
+private:
+    std::optional<MappedFile> file_;
+    const TradeCacheIndexEntry* index_ = nullptr;
+    size_t index_size_ = 0;
+    const int32_t* ids_ = nullptr;
+    const int32_t* times_ = nullptr;
+    const int32_t* prices_ = nullptr;
+    size_t count_ = 0;
+    size_t pos_ = 0;
+
+    // Running values, i.e. the last decoded trade
+    uint64_t id_ = 0;
+    uint64_t ts_ = 0;
+    uint64_t price_ = 0;
+};
+
+// Reads a cache into out. Returns false, leaving out untouched, when the
+// file is missing, truncated, from another version or built from a
+// different source.
+bool read_trade_cache(const std::string& path, const TradeCacheSource& source, std::vector<Trade>& out);
+
+// Cache of one day's bars for one BarSpec: a 64-byte header naming the
+// spec and the source CSV, then the Bar structs as laid out in memory.
+constexpr uint32_t kBarCacheVersion = 2;
+
+// Same contract as write_trade_cache
+bool write_bar_cache(const std::string& path, const std::vector<Bar>& bars, const BarSpec& spec,
+                     const TradeCacheSource& source);
+
+// Returns false, leaving out untouched, on a miss: missing, truncated,
+// other version or spec, or built from a different source
+bool read_bar_cache(const std::string& path, const BarSpec& spec, const TradeCacheSource& source,
+                    std::vector<Bar>& out);
+
+}  // namespace signalforge
@@ -0,0 +1,217 @@
+#include "trade_cache.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace signalforge {
+
+class TradeCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "trade_cache_test";
+        std::filesystem::create_directories(test_dir_);
+        path_ = (test_dir_ / "trades.sftc").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    static void expect_same(const std::vector<Trade>& got, const std::vector<Trade>& want) {
+        ASSERT_EQ(got.size(), want.size());
+        for (size_t i = 0; i < got.size(); ++i) {
+            EXPECT_EQ(got[i].trade_id, want[i].trade_id) << "row " << i;
+            EXPECT_EQ(got[i].price, want[i].price) << "row " << i;
+            EXPECT_EQ(got[i].timestamp, want[i].timestamp) << "row " << i;
+        }
+    }
+
+    std::filesystem::path test_dir_;
+    std::string path_;
+    TradeCacheSource source_{1234, 5678};
+};
+
+TEST_F(TradeCacheTest, RoundTrip) {
+    std::vector<Trade> trades = {
+        {1000, 4250050, 1640000000000},
+        {1001, 4250100, 1640000000000},
+        {1003, 4249975, 1640000000250},
+        {1002, 1, 1639999999000},  // out of order rows still encode
+    };
+
+    ASSERT_TRUE(write_trade_cache(path_, trades, source_));
+    // Header, columns, one index entry
+    EXPECT_EQ(std::filesystem::file_size(path_), 64 + trades.size() * 12 + 24);
+
+    std::vector<Trade> loaded;
+    ASSERT_TRUE(read_trade_cache(path_, source_, loaded));
+    expect_same(loaded, trades);
+}
+
+// Writers racing on one path each use their own temp file: the survivor is
+// one whole write and no temp files are left behind
+TEST_F(TradeCacheTest, ConcurrentWritersDoNotCollide) {
+    constexpr int kWriters = 4;
+    std::vector<std::vector<Trade>> days(kWriters);
+    for (int w = 0; w < kWriters; ++w) {
+        for (uint64_t i = 0; i < 20000; ++i) {
+            days[w].push_back({i, 4250000 + w, 1640000000000 + i});
+        }
+    }
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < kWriters; ++w) {
+        writers.emplace_back([&, w] {
+            for (int i = 0; i < 10; ++i) EXPECT_TRUE(write_trade_cache(path_, days[w], source_));
+        });
+    }
+    for (auto& t : writers) t.join();
+
+    std::vector<Trade> loaded;
+    ASSERT_TRUE(read_trade_cache(path_, source_, loaded));
+    ASSERT_FALSE(loaded.empty());
+    expect_same(loaded, days[loaded[0].price - 4250000]);
+
+    size_t files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(test_dir_)) {
+        (void)entry;
+        ++files;
+    }
+    EXPECT_EQ(files, 1u);
+}
+
+TEST_F(TradeCacheTest, FindAndSeekByTimestamp) {
+    // Several index strides, an odd count (padded index) and runs of equal
+    // timestamps that straddle stride boundaries
+    const size_t n = 3 * kTradeCacheIndexStride + 77;
+    std::vector<Trade> trades;
+    uint64_t ts = 1705276800000;
+    for (size_t i = 0; i < n; ++i) {
+        ts += (i % 7 == 0) ? 0 : (i % 13);
+        trades.push_back({5000 + i * 2, static_cast<Price>(4250000 + (i * 37) % 1000), ts});
+    }
+    ASSERT_TRUE(write_trade_cache(path_, trades, source_));
+
+    TradeCacheReader reader;
+    ASSERT_TRUE(reader.open(path_, source_));
+    auto want_row = [&](uint64_t t) {
+        return static_cast<size_t>(std::lower_bound(trades.begin(), trades.end(), t,
+            [](const Trade& a, uint64_t b) { return a.timestamp < b; }) - trades.begin());
+    };
+
+    for (size_t row : {size_t{0}, size_t{1}, kTradeCacheIndexStride - 1, kTradeCacheIndexStride,
+                       kTradeCacheIndexStride + 1, 2 * kTradeCacheIndexStride + 500, n - 1}) {
+        const uint64_t t = trades[row].timestamp;
+        for (uint64_t probe : {t - 1, t, t + 1}) {
+            EXPECT_EQ(reader.find(probe), want_row(probe)) << probe;
+        }
+
+        reader.seek(row);
+        std::vector<Trade> got;
+        EXPECT_EQ(reader.read(got, 100), std::min<size_t>(100, n - row));
+        expect_same(got, std::vector<Trade>(trades.begin() + row, trades.begin() + row + got.size()));
+    }
+    EXPECT_EQ(reader.find(0), 0);
+    EXPECT_EQ(reader.find(ts + 1), n);
+
+    reader.seek(n);
+    std::vector<Trade> got;
+    EXPECT_EQ(reader.read(got, 10), 0);
+}
+
+TEST_F(TradeCacheTest, EmptyDay) {
+    ASSERT_TRUE(write_trade_cache(path_, {}, source_));
+
+    std::vector<Trade> loaded = {{1, 1, 1}};
+    ASSERT_TRUE(read_trade_cache(path_, source_, loaded));
+    EXPECT_TRUE(loaded.empty());
+}
+
+TEST_F(TradeCacheTest, MissingFileIsMiss) {
+    std::vector<Trade> loaded;
+    EXPECT_FALSE(read_trade_cache(path_, source_, loaded));
+}
+
+TEST_F(TradeCacheTest, StaleSourceIsMiss) {
+    ASSERT_TRUE(write_trade_cache(path_, {{1, 100, 1000}}, source_));
+
+    std::vector<Trade> loaded;
+    EXPECT_FALSE(read_trade_cache(path_, {source_.size + 1, source_.mtime}, loaded));
+    EXPECT_FALSE(read_trade_cache(path_, {source_.size, source_.mtime + 1}, loaded));
+    EXPECT_TRUE(loaded.empty());
+}
+
+TEST_F(TradeCacheTest, TruncatedOrForeignFileIsMiss) {
+    ASSERT_TRUE(write_trade_cache(path_, {{1, 100, 1000}, {2, 101, 1001}}, source_));
+    std::filesystem::resize_file(path_, std::filesystem::file_size(path_) - 4);
+
+    std::vector<Trade> loaded;
+    EXPECT_FALSE(read_trade_cache(path_, source_, loaded));
+
+    std::ofstream(path_, std::ios::trunc) << "trade_id,price,qty,quote_qty,time,is_buyer_maker\n";
+    EXPECT_FALSE(read_trade_cache(path_, source_, loaded));
+}
+
+TEST_F(TradeCacheTest, VersionMismatchIsMiss) {
+    ASSERT_TRUE(write_trade_cache(path_, {{1, 100, 1000}}, source_));
+
+    // Version follows the 8-byte magic
+    std::fstream file(path_, std::ios::in | std::ios::out | std::ios::binary);
+    const uint32_t other = kTradeCacheVersion + 1;
+    file.seekp(8);
+    file.write(reinterpret_cast<const char*>(&other), sizeof(other));
+    file.close();
+
+    std::vector<Trade> loaded;
+    EXPECT_FALSE(read_trade_cache(path_, source_, loaded));
+}
+
+TEST_F(TradeCacheTest, RefusesDeltasWiderThan32Bits) {
+    std::vector<Trade> trades = {{1, 100, 1000}, {1, 100, 1000 + (1ULL << 40)}};
+
+    EXPECT_FALSE(write_trade_cache(path_, trades, source_));
+    EXPECT_FALSE(std::filesystem::exists(path_));
+}
+
+TEST_F(TradeCacheTest, SourceOfFile) {
+    const std::string csv = (test_dir_ / "trades.csv").string();
+    std::ofstream(csv) << "1,42500.00,0.1,4250.0,1640000000000,true\n";
+
+    const TradeCacheSource source = TradeCacheSource::of(csv);
+    EXPECT_EQ(source.size, std::filesystem::file_size(csv));
+    EXPECT_EQ(source, TradeCacheSource::of(csv));
+}
+
+TEST_F(TradeCacheTest, BarCacheRoundTrip) {
+    std::vector<Bar> bars(3);
+    for (size_t i = 0; i < bars.size(); ++i) {
+        bars[i] = {60000 * i, 60000 * i + 59999, 100, 120, 90, 110, 105, 7, 735, 3, 2 + i};
+    }
+
+    ASSERT_TRUE(write_bar_cache(path_, bars, BarSpec{BarType::TIME, 60000}, source_));
+
+    std::vector<Bar> loaded;
+    ASSERT_TRUE(read_bar_cache(path_, BarSpec{BarType::TIME, 60000}, source_, loaded));
+    ASSERT_EQ(loaded.size(), bars.size());
+    for (size_t i = 0; i < bars.size(); ++i) {
+        EXPECT_EQ(loaded[i].open_time, bars[i].open_time);
+        EXPECT_EQ(loaded[i].vwap, bars[i].vwap);
+        EXPECT_EQ(loaded[i].trade_count, bars[i].trade_count);
+    }
+
+    std::vector<Bar> missed;
+    EXPECT_FALSE(read_bar_cache(path_, BarSpec{BarType::TIME, 1000}, source_, missed));  // other interval
+    EXPECT_FALSE(read_bar_cache(path_, BarSpec{BarType::TICK, 60000}, source_, missed));  // other type
+    EXPECT_FALSE(read_bar_cache(path_, BarSpec{BarType::TIME, 60000}, {source_.size, source_.mtime + 1}, missed));
+    EXPECT_TRUE(missed.empty());
+
+    std::vector<Trade> trades;
+    EXPECT_FALSE(read_trade_cache(path_, source_, trades));  // not a trade cache
+
+    std::filesystem::resize_file(path_, std::filesystem::file_size(path_) - 8);
+    EXPECT_FALSE(read_bar_cache(path_, BarSpec{BarType::TIME, 60000}, source_, missed));
+}
+
+}  // namespace signalforge
@@ -1,71 +1,338 @@
 #include "trade_csv_loader.h"
-#include <fstream>
-#include <sstream>
-#include <stdexcept>
+#include "trade_batch.h"
+#include <algorithm>
+#include <cerrno>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "cpp/io/fixed_point.h"
 
 namespace signalforge {
 
-std::vector<Trade> TradeCsvLoader::load(const std::string& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filepath);
+namespace {
+
+// Average Binance trades row is ~60 bytes; reserving from the file size
+// avoids most of the vector regrowth on multi-million row days.
+constexpr size_t kBytesPerRowEstimate = 64;
+
+// Separator index size. Small enough to stay in L2 with its input.
+constexpr size_t kChunkBytes = 64 * 1024;
+
+// How much parsed input the reader lets accumulate before releasing it
+constexpr size_t kReleaseBytes = 4 * 1024 * 1024;
+
+// Commas remembered per row: enough to delimit all seven Binance columns
+constexpr size_t kMaxCommas = 6;
+
+const char* next_comma(const char* p, const char* end) {
+    if (p != end && *p == ',') return p;
+    return static_cast<const char*>(std::memchr(p, ',', static_cast<size_t>(end - p)));
+}
+
+// Slow paths reproducing the std::stoull / std::stod semantics the loader
+// has always had (any leading whitespace, signs, exponents, hex floats,
+// ERANGE rejected). Only reached by fields the fast parsers do not accept.
+
+bool parse_uint_slow(const char* begin, const char* end, uint64_t& out) {
+    const std::string field(begin, end);
+    char* stop = nullptr;
+    errno = 0;
+    const unsigned long long value = std::strtoull(field.c_str(), &stop, 10);
+    if (stop == field.c_str() || errno == ERANGE) return false;
+    out = value;
+    return true;
+}
+
+bool parse_price_slow(const char* begin, const char* end, Price& out) {
+    const std::string field(begin, end);
+    char* stop = nullptr;
+    errno = 0;
+    const double value = std::strtod(field.c_str(), &stop);
+    if (stop == field.c_str() || errno == ERANGE) return false;
+
+    const double ticks = std::round(value * 100.0);
+    if (!(std::fabs(ticks) < 9.2e18)) return false;  // also rejects inf/nan
+    out = static_cast<Price>(ticks);
+    return true;
+}
+
+bool parse_qty_slow(const char* begin, const char* end, Quantity& out) {
+    const std::string field(begin, end);
+    char* stop = nullptr;
+    errno = 0;
+    const double value = std::strtod(field.c_str(), &stop);
+    if (stop == field.c_str() || errno == ERANGE) return false;
+
+    const double units = std::round(value * 1e8);
+    if (!(std::fabs(units) < 9.2e18)) return false;
+    out = static_cast<Quantity>(units);
+    return true;
+}
+
+// A number the decimal parser stopped in the middle of, e.g. 1e5 or 0x1p3
+bool more_number_follows(const char* p, const char* end) {
+    if (p == end) return false;
+    const char c = *p;
+    return c == 'e' || c == 'E' || c == 'x' || c == 'X' || c == 'p' || c == 'P';
+}
+
+bool parse_uint_field(const char* begin, const char* end, uint64_t& out) {
+    const char* p = begin;
+    // Digits are a prefix under strtoull too, so any successful fast parse
+    // gives the same value
+    if (parse_uint(p, end, out)) return true;
+    return parse_uint_slow(begin, end, out);
+}
+
+bool parse_price_field(const char* begin, const char* end, Price& out) {
+    const char* p = begin;
+    bool exact = false;
+    // Prices that are a whole number of ticks convert directly. Anything the
+    // decimal parser would round, or that strtod would read further (1e5,
+    // 0x1p3, inf), keeps the original double rounding for identical output.
+    if (parse_fixed(p, end, kPriceDecimals, out, exact) && exact && !more_number_follows(p, end)) {
+        return true;
     }
+    return parse_price_slow(begin, end, out);
+}
 
-    std::vector<Trade> trades;
-    std::string line;
-    skipped_rows_ = 0;
-    bool first_line = true;
-
-    while (std::getline(file, line)) {
-        // Skip header row if it exists (check if first field is "trade_id")
-        if (first_line) {
-            first_line = false;
-            if (line.find("trade_id") != std::string::npos) {
-                continue;
-            }
+// Quantities have no legacy double rounding to reproduce; digits past the
+// 8th, which Binance never sends, round half up
+bool parse_qty_field(const char* begin, const char* end, Quantity& out) {
+    const char* p = begin;
+    if (parse_fixed(p, end, kQtyDecimals, out) && !more_number_follows(p, end)) return true;
+    return parse_qty_slow(begin, end, out);
+}
+
+// Case-insensitive match of [p, end) against a lowercase word
+bool equals_lower(const char* p, const char* end, const char* word) {
+    for (; p != end; ++p, ++word) {
+        if (*word == '\0' || (*p | 0x20) != *word) return false;
+    }
+    return *word == '\0';
+}
+
+// The whole field is "true"/"false" in any case, or exactly 1/0. A
+// trailing '\r' (last field of a CRLF line) is ignored.
+bool parse_bool_field(const char* p, const char* end, bool& out) {
+    while (p != end && *p == ' ') ++p;
+    if (p != end && end[-1] == '\r') --end;
+    if (end - p == 1 && (*p == '1' || *p == '0')) {
+        out = *p == '1';
+        return true;
+    }
+    if (equals_lower(p, end, "true")) {
+        out = true;
+        return true;
+    }
+    if (equals_lower(p, end, "false")) {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+// Parse one line (without its '\n') given the positions of its first
+// commas: trade_id,price,qty,quote_qty,time,... Fields are delimited
+// exactly as the original getline split did, so a trailing '\r' stays part
+// of the last field and is ignored by the number parsers as trailing text.
+bool parse_fields(const char* row, const char* eol, const char* const* commas, size_t count, Trade& trade) {
+    if (count < 4) return false;
+    const char* time_end = count > 4 ? commas[4] : eol;
+
+    return parse_uint_field(row, commas[0], trade.trade_id) &&
+           parse_price_field(commas[0] + 1, commas[1], trade.price) &&
+           parse_uint_field(commas[3] + 1, time_end, trade.timestamp);
+}
+
+// Every column: trade_id,price,qty,quote_qty,time,is_buyer_maker[,is_best_match]
+bool parse_fields(const char* row, const char* eol, const char* const* commas, size_t count, TradeRow& trade) {
+    if (count < 5) return false;
+    const char* maker_end = count > 5 ? commas[5] : eol;
+    trade.is_best_match = false;
+
+    return parse_uint_field(row, commas[0], trade.trade_id) &&
+           parse_price_field(commas[0] + 1, commas[1], trade.price) &&
+           parse_qty_field(commas[1] + 1, commas[2], trade.qty) &&
+           parse_qty_field(commas[2] + 1, commas[3], trade.quote_qty) &&
+           parse_uint_field(commas[3] + 1, commas[4], trade.timestamp) &&
+           parse_bool_field(commas[4] + 1, maker_end, trade.is_buyer_maker) &&
+           (count < 6 || parse_bool_field(commas[5] + 1, eol, trade.is_best_match));
+}
+
+// Same, finding the commas itself. Used for rows longer than a scan chunk.
+template <typename Row>
+bool parse_row(const char* row, const char* eol, Row& trade) {
+    const char* commas[kMaxCommas];
+    size_t count = 0;
+    for (const char* c = next_comma(row, eol); c != nullptr && count < kMaxCommas; c = next_comma(c + 1, eol)) {
+        commas[count++] = c;
+    }
+    return parse_fields(row, eol, commas, count, trade);
+}
+
+void append(std::vector<Trade>& out, const Trade& trade) { out.push_back(trade); }
+void append(TradeBatch& out, const TradeRow& trade) { out.push_back(trade); }
+
+bool is_zip_path(const std::string& path) {
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".zip") == 0;
+}
+
+ScanIsa checked_isa(ScanIsa isa) {
+    if (!scan_isa_supported(isa)) {
+        throw std::runtime_error(std::string("Scan isa not supported by this CPU: ") + scan_isa_name(isa));
+    }
+    return isa;
+}
+
+}  // namespace
+
+TradeCsvReader::TradeCsvReader(const std::string& filepath, ScanIsa isa) : isa_(checked_isa(isa)) {
+    if (is_zip_path(filepath)) {
+        zip_ = std::make_unique<ZipBlockStream>(filepath);
+        size_ = static_cast<size_t>(zip_->size());
+        input_done_ = false;
+    } else {
+        file_.emplace(filepath);
+        file_->advise_sequential();
+        size_ = file_->size();
+        pos_ = released_ = file_->begin();
+        end_ = file_->end();
+    }
+    separators_.resize(kChunkBytes);
+}
+
+bool TradeCsvReader::refill() {
+    if (input_done_) return false;
+    const size_t tail = static_cast<size_t>(end_ - pos_);
+    if (tail > 0) std::memmove(window_.data(), pos_, tail);
+    window_.resize(tail);
+    if (zip_->next(block_)) {
+        window_.insert(window_.end(), block_.begin(), block_.end());
+    } else {
+        input_done_ = true;
+    }
+    pos_ = window_.data();
+    end_ = pos_ + window_.size();
+    return true;
+}
+
+template <typename Out>
+void TradeCsvReader::on_row(const char* row, const char* eol, const char* const* commas, size_t count, Out& out) {
+    // Skip header row if it exists (check if first field is "trade_id")
+    if (first_line_) {
+        first_line_ = false;
+        if (std::string_view(row, static_cast<size_t>(eol - row)).find("trade_id") != std::string_view::npos) {
+            return;
         }
+    }
+
+    // Skip empty lines
+    if (row == eol) {
+        return;
+    }
+
+    // Trade for the three-column vector, TradeRow for a batch
+    using Row = std::conditional_t<std::is_same_v<Out, TradeBatch>, TradeRow, Trade>;
+    Row trade;
+    const bool ok = commas != nullptr ? parse_fields(row, eol, commas, count, trade)
+                                      : parse_row(row, eol, trade);
+    if (ok) {
+        append(out, trade);
+    } else {
+        skipped_rows_++;
+    }
+}
+
+bool TradeCsvReader::read_chunk(std::vector<Trade>& out) {
+    return read_chunk_into(out);
+}
+
+bool TradeCsvReader::read_chunk(TradeBatch& out) {
+    return read_chunk_into(out);
+}
+
+template <typename Out>
+bool TradeCsvReader::read_chunk_into(Out& out) {
+    // Zip input: have a whole chunk, or the rest of the file, in the window
+    while (!input_done_ && static_cast<size_t>(end_ - pos_) < kChunkBytes) refill();
+
+    const char* p = pos_;
+    const char* end = end_;
+    if (p >= end) return false;
 
-        // Skip empty lines
-        if (line.empty()) {
+    // Index the separators of one chunk, then walk the rows using the
+    // index. A row cut by the chunk boundary starts the next chunk.
+    const size_t len = std::min(kChunkBytes, static_cast<size_t>(end - p));
+    const bool last_chunk = input_done_ && p + len == end;
+    const size_t found = scan_separators(p, len, separators_.data(), isa_);
+
+    const char* row = p;
+    const char* commas[kMaxCommas];
+    size_t count = 0;
+    for (size_t i = 0; i < found; ++i) {
+        const char* sep = p + separators_[i];
+        if (*sep == ',') {
+            if (count < kMaxCommas) commas[count++] = sep;
             continue;
         }
+        on_row(row, sep, commas, count, out);
+        row = sep + 1;
+        count = 0;
+    }
 
-        try {
-            // Parse CSV line: trade_id,price,qty,quote_qty,time,is_buyer_maker
-            std::stringstream ss(line);
-            std::string field;
-            std::vector<std::string> fields;
+    if (last_chunk) {
+        // Final line without a trailing newline
+        if (row < end) on_row(row, end, commas, count, out);
+        row = end;
+    } else if (row == p) {
+        // No newline in a whole chunk: take the line the slow way
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        while (eol == nullptr && refill()) {
+            p = pos_;
+            end = end_;
+            eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        }
+        if (eol == nullptr) eol = end;
+        on_row(p, eol, nullptr, 0, out);
+        row = eol == end ? end : eol + 1;
+    }
+    pos_ = row;
 
-            // Split by comma
-            while (std::getline(ss, field, ',')) {
-                fields.push_back(field);
-            }
+    if (file_ && static_cast<size_t>(pos_ - released_) >= kReleaseBytes) {
+        file_->release_before(pos_);
+        released_ = pos_;
+    }
+    return true;
+}
 
-            // Need at least 5 fields (trade_id, price, qty, quote_qty, time)
-            if (fields.size() < 5) {
-                skipped_rows_++;
-                continue;
-            }
+TradeCsvLoader::TradeCsvLoader(ScanIsa isa) : isa_(checked_isa(isa)) {}
 
-            // Extract and convert fields
-            Trade trade;
-            trade.trade_id = std::stoull(fields[0]);
+std::vector<Trade> TradeCsvLoader::load(const std::string& filepath) {
+    TradeCsvReader reader(filepath, isa_);
 
-            // Convert price to ticks (2 decimal precision)
-            double price_float = std::stod(fields[1]);
-            trade.price = static_cast<Price>(std::round(price_float * 100.0));
+    std::vector<Trade> trades;
+    trades.reserve(reader.file_size() / kBytesPerRowEstimate);
+    while (reader.read_chunk(trades)) {
+    }
 
-            trade.timestamp = std::stoull(fields[4]);
+    skipped_rows_ = reader.skipped_rows();
+    return trades;
+}
 
-            trades.push_back(trade);
+TradeBatch TradeCsvLoader::load_batch(const std::string& filepath) {
+    TradeCsvReader reader(filepath, isa_);
 
-        } catch (const std::exception&) {
-            // Skip malformed rows silently
-            skipped_rows_++;
-        }
+    TradeBatch trades;
+    trades.reserve(reader.file_size() / kBytesPerRowEstimate);
+    while (reader.read_chunk(trades)) {
     }
 
+    skipped_rows_ = reader.skipped_rows();
     return trades;
 }
 
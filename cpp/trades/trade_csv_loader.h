@@ -1,7 +1,12 @@
 #pragma once
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <cstdint>
+#include "cpp/io/csv_scanner.h"
+#include "cpp/io/mapped_file.h"
+#include "cpp/io/zip_reader.h"
 #include "cpp/orderbook/order_book.h"
 
 namespace signalforge {
@@ -12,18 +17,86 @@ struct Trade {
     uint64_t timestamp; // Unix time in milliseconds
 };
 
+struct TradeBatch;  // every column, struct-of-arrays (trade_batch.h)
+
+// Incremental parser over one memory-mapped trades CSV. Comma and newline
+// positions are first indexed a chunk at a time with the vectorized
+// scanner, then numbers are converted field by field. Pages already parsed
+// are released as it goes, so reading a file of any size holds only about
+// one chunk in memory besides the caller's output.
+//
+// A path ending in ".zip" is read as a Binance archive: the CSV inside is
+// inflated on a worker thread (ZipBlockStream) while this thread parses
+// the blocks already inflated, and rows cut by a block boundary are
+// carried over. Output is the same as for the extracted CSV.
+class TradeCsvReader {
+public:
+    // Throws std::runtime_error if file cannot be opened, or is a zip that
+    // cannot be read, or isa is not supported by this CPU
+    explicit TradeCsvReader(const std::string& filepath, ScanIsa isa = detect_scan_isa());
+
+    // Appends the trades of the next chunk of the file (~1000 rows) to out.
+    // Returns false once the whole file has been read.
+    bool read_chunk(std::vector<Trade>& out);
+    // Same, keeping every column. Rows whose qty, quote_qty or
+    // is_buyer_maker do not parse are skipped as malformed too.
+    bool read_chunk(TradeBatch& out);
+
+    // Uncompressed size for a zip
+    size_t file_size() const { return size_; }
+    size_t skipped_rows() const { return skipped_rows_; }
+
+private:
+    template <typename Out>
+    bool read_chunk_into(Out& out);
+
+    // commas is null when the row was not indexed by the scanner
+    template <typename Out>
+    void on_row(const char* row, const char* eol, const char* const* commas, size_t count, Out& out);
+
+    // Moves the unparsed tail to the front of window_ and appends the next
+    // inflated block. Returns false once the archive is exhausted.
+    bool refill();
+
+    std::optional<MappedFile> file_;      // CSV input
+    std::unique_ptr<ZipBlockStream> zip_;  // zip input
+    std::vector<char> window_;             // zip: unparsed tail + latest block
+    std::vector<char> block_;
+    ScanIsa isa_;
+    size_t size_ = 0;
+    const char* pos_ = nullptr;
+    const char* end_ = nullptr;     // end of the input available so far
+    bool input_done_ = true;        // end_ is the end of the file
+    const char* released_ = nullptr;
+    size_t skipped_rows_ = 0;
+    bool first_line_ = true;
+    std::vector<uint32_t> separators_;  // scan index for one chunk
+};
+
+// Loads a whole file with TradeCsvReader; parsing does not allocate per row.
+// Output, including skipped_rows(), matches the original stringstream-based
+// loader (see ReferenceTradeCsvLoader) for every isa.
 class TradeCsvLoader {
 public:
+    // Throws std::runtime_error if isa is not supported by this CPU
+    explicit TradeCsvLoader(ScanIsa isa = detect_scan_isa());
+
     // Load all trades from a Binance CSV file
     // Expected format: trade_id,price,qty,quote_qty,time,is_buyer_maker
     // Throws std::runtime_error if file cannot be opened
     // Silently skips malformed rows
     std::vector<Trade> load(const std::string& filepath);
 
+    // Load all columns (see TradeBatch). Rows are the ones load() keeps,
+    // minus any whose extra columns are malformed.
+    // Throws std::runtime_error if file cannot be opened
+    TradeBatch load_batch(const std::string& filepath);
+
     // Get the number of rows that were skipped during the last load
     size_t skipped_rows() const { return skipped_rows_; }
 
 private:
+    ScanIsa isa_;
     size_t skipped_rows_ = 0;
 };
 
@@ -0,0 +1,199 @@
+// Load throughput of the mmap TradeCsvLoader against the original
+// stringstream loader, on a synthetic file shaped like a Binance trades day;
+// then the same day from its zip, inflated on a worker thread, and from the
+// binary cache.
+//
+// Run: bazel run -c opt //cpp/trades:trade_csv_loader_benchmark
+
+#include "trade_csv_loader.h"
+#include "reference_trade_csv_loader.h"
+#include "trade_batch.h"
+#include "trade_cache.h"
+#include "cpp/io/zip_reader.h"
+#include "cpp/io/zip_writer.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace signalforge {
+namespace {
+
+constexpr size_t kRows = 1000000;
+
+const std::string& trades_file() {
+    static const std::string path = [] {
+        const std::string p = (std::filesystem::temp_directory_path() / "trade_csv_loader_benchmark.csv").string();
+        std::ofstream out(p);
+        out << "trade_id,price,qty,quote_qty,time,is_buyer_maker,is_best_match\n";
+
+        std::mt19937_64 rng(7);
+        std::uniform_int_distribution<int> step(-50, 50);
+        std::uniform_int_distribution<int> qty(1, 500000);
+        std::uniform_int_distribution<int> gap(0, 20);
+
+        long long price = 4250000;
+        unsigned long long ts = 1640000000000ULL;
+        char row[160];
+        for (size_t i = 0; i < kRows; ++i) {
+            price += step(rng);
+            ts += static_cast<unsigned long long>(gap(rng));
+            const int q = qty(rng);
+            std::snprintf(row, sizeof(row), "%zu,%lld.%02lld000000,0.%08d,%.8f,%llu,%s,True\n",
+                          1000000 + i, price / 100, price % 100, q,
+                          static_cast<double>(price) * q / 1e10, ts, (i & 1) ? "True" : "False");
+            out << row;
+        }
+        return p;
+    }();
+    return path;
+}
+
+template <typename Loader>
+void BM_LoadTrades(benchmark::State& state) {
+    const std::string& path = trades_file();
+    Loader loader;
+    size_t rows = 0;
+    for (auto _ : state) {
+        auto trades = loader.load(path);
+        rows = trades.size();
+        benchmark::DoNotOptimize(trades.data());
+    }
+    // trades/s and MB/s
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(path)));
+}
+BENCHMARK_TEMPLATE(BM_LoadTrades, ReferenceTradeCsvLoader)->Unit(benchmark::kMillisecond);
+
+// The mmap loader with each separator scanner this CPU supports
+void BM_LoadTradesScan(benchmark::State& state) {
+    const ScanIsa isa = static_cast<ScanIsa>(state.range(0));
+    if (!scan_isa_supported(isa)) {
+        state.SkipWithError("isa not supported on this CPU");
+        return;
+    }
+    state.SetLabel(scan_isa_name(isa));
+
+    const std::string& path = trades_file();
+    TradeCsvLoader loader(isa);
+    size_t rows = 0;
+    for (auto _ : state) {
+        auto trades = loader.load(path);
+        rows = trades.size();
+        benchmark::DoNotOptimize(trades.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(path)));
+}
+BENCHMARK(BM_LoadTradesScan)
+    ->Arg(static_cast<int>(ScanIsa::SCALAR))
+    ->Arg(static_cast<int>(ScanIsa::SSE2))
+    ->Arg(static_cast<int>(ScanIsa::AVX2))
+    ->Unit(benchmark::kMillisecond);
+
+// All seven columns into a TradeBatch
+void BM_LoadTradeBatch(benchmark::State& state) {
+    const std::string& path = trades_file();
+    TradeCsvLoader loader;
+    size_t rows = 0;
+    for (auto _ : state) {
+        auto batch = loader.load_batch(path);
+        rows = batch.size();
+        benchmark::DoNotOptimize(batch.qty.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(path)));
+}
+BENCHMARK(BM_LoadTradeBatch)->Unit(benchmark::kMillisecond);
+
+// Streaming the file in chunks through one reused buffer, as TradeStream
+// does, instead of materializing the whole day
+void BM_StreamTrades(benchmark::State& state) {
+    const std::string& path = trades_file();
+    std::vector<Trade> chunk;
+    size_t rows = 0;
+    for (auto _ : state) {
+        TradeCsvReader reader(path);
+        rows = 0;
+        bool more = true;
+        while (more) {
+            chunk.clear();
+            more = reader.read_chunk(chunk);
+            rows += chunk.size();
+            benchmark::DoNotOptimize(chunk.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(path)));
+}
+BENCHMARK(BM_StreamTrades)->Unit(benchmark::kMillisecond);
+
+const std::string& zip_file() {
+    static const std::string path = [] {
+        std::ifstream in(trades_file(), std::ios::binary);
+        std::string content(std::istreambuf_iterator<char>(in), {});
+        const std::string p = trades_file() + ".zip";
+        write_zip(p, {{"BTCUSDT-trades-2024-01-15.csv", content}});
+        return p;
+    }();
+    return path;
+}
+
+// Inflating alone, on the calling thread: the floor for loading a zip
+// without a second core
+void BM_InflateZip(benchmark::State& state) {
+    const std::string& path = zip_file();
+    std::vector<char> buf(ZipBlockStream::kDefaultBlockBytes);
+    for (auto _ : state) {
+        ZipEntryReader reader(path);
+        while (reader.read(buf.data(), buf.size()) > 0) {
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(trades_file())));
+}
+BENCHMARK(BM_InflateZip)->Unit(benchmark::kMillisecond);
+
+// Loading the zip: inflating on the worker overlaps parsing here. Bytes
+// are the uncompressed CSV's, comparable with BM_LoadTradesScan.
+void BM_LoadTradesZip(benchmark::State& state) {
+    const std::string& path = zip_file();
+    TradeCsvLoader loader;
+    size_t rows = 0;
+    for (auto _ : state) {
+        auto trades = loader.load(path);
+        rows = trades.size();
+        benchmark::DoNotOptimize(trades.data());
+    }
+    state.counters["ratio"] = static_cast<double>(std::filesystem::file_size(trades_file())) /
+                              static_cast<double>(std::filesystem::file_size(path));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(trades_file())));
+}
+BENCHMARK(BM_LoadTradesZip)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Reading the same day back from the binary cache
+void BM_LoadTradesCache(benchmark::State& state) {
+    const std::string& path = trades_file();
+    const std::string cache = path + ".sftc";
+    const TradeCacheSource source = TradeCacheSource::of(path);
+    if (!write_trade_cache(cache, TradeCsvLoader().load(path), source)) {
+        state.SkipWithError("could not write cache");
+        return;
+    }
+
+    size_t rows = 0;
+    for (auto _ : state) {
+        std::vector<Trade> trades;
+        read_trade_cache(cache, source, trades);
+        rows = trades.size();
+        benchmark::DoNotOptimize(trades.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(cache)));
+}
+BENCHMARK(BM_LoadTradesCache)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace signalforge
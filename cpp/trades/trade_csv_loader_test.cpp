@@ -1,7 +1,11 @@
 #include "trade_csv_loader.h"
+#include "trade_batch.h"
+#include "reference_trade_csv_loader.h"
+#include "cpp/io/zip_writer.h"
 #include <gtest/gtest.h>
 #include <fstream>
 #include <filesystem>
+#include <random>
 
 namespace signalforge {
 
@@ -119,6 +123,21 @@ TEST_F(TradeCsvLoaderTest, FileNotFound) {
     );
 }
 
+TEST_F(TradeCsvLoaderTest, UnsupportedIsaThrows) {
+    const std::string path = create_test_file("isa.csv", "1,42500.50,0.1,4250.05,1700000000000,true\n");
+    const ScanIsa bad = static_cast<ScanIsa>(99);
+    EXPECT_FALSE(scan_isa_supported(bad));
+    EXPECT_THROW(TradeCsvLoader{bad}, std::runtime_error);
+    EXPECT_THROW(TradeCsvReader(path, bad), std::runtime_error);
+    for (ScanIsa isa : {ScanIsa::SCALAR, ScanIsa::SSE2, ScanIsa::AVX2}) {
+        if (scan_isa_supported(isa)) {
+            EXPECT_EQ(TradeCsvLoader(isa).load(path).size(), 1u);
+        } else {
+            EXPECT_THROW(TradeCsvLoader{isa}, std::runtime_error);
+        }
+    }
+}
+
 // Test price conversion precision
 TEST_F(TradeCsvLoaderTest, PriceConversionPrecision) {
     std::string csv_content =
@@ -174,4 +193,304 @@ TEST_F(TradeCsvLoaderTest, IntegrationWithMarketView) {
     }
 }
 
+// The mmap loader must agree with the original loader row for row,
+// including which rows count as skipped, whichever scanner it uses
+void expect_parity(const std::string& filepath) {
+    ReferenceTradeCsvLoader reference;
+    auto want = reference.load(filepath);
+
+    for (ScanIsa isa : {ScanIsa::SCALAR, ScanIsa::SSE2, ScanIsa::AVX2}) {
+        if (!scan_isa_supported(isa)) continue;
+        SCOPED_TRACE(scan_isa_name(isa));
+
+        TradeCsvLoader fast(isa);
+        auto got = fast.load(filepath);
+
+        ASSERT_EQ(got.size(), want.size());
+        EXPECT_EQ(fast.skipped_rows(), reference.skipped_rows());
+        for (size_t i = 0; i < got.size(); ++i) {
+            EXPECT_EQ(got[i].trade_id, want[i].trade_id) << "row " << i;
+            EXPECT_EQ(got[i].price, want[i].price) << "row " << i;
+            EXPECT_EQ(got[i].timestamp, want[i].timestamp) << "row " << i;
+        }
+    }
+}
+
+// Edge cases where the hand-written parser has to fall back to the
+// original strtod/strtoull behaviour
+TEST_F(TradeCsvLoaderTest, MatchesReferenceOnEdgeCases) {
+    std::string csv_content =
+        "trade_id,price,qty,quote_qty,time,is_buyer_maker\r\n"
+        "1,42500.50000000,0.001,42.5,1640000000000,true,true\r\n"  // Binance padding, CRLF
+        "2,1.005,1,1,1640000000001,true\n"        // half tick, keeps double rounding
+        "3,4.25e4,1,1,1640000000002,true\n"       // exponent
+        "4, 42500.5,1,1, 1640000000003,true\n"    // leading spaces
+        "5,\t42500.5,1,1,1640000000004,true\n"    // leading tab
+        "6,42500.5abc,1,1,1640000000005x,true\n"  // trailing junk (prefix semantics)
+        "7,42500.5,1,1,1640000000006\n"           // five fields
+        "8,42500.5,1,1,\n"                        // empty time
+        "9,42500.5,1,1\n"                         // four fields
+        "\r\n"                                    // not empty, one field
+        "-10,+42500.5,1,1,1640000000009,true\n"   // signs
+        "99999999999999999999,1,1,1,1640000000010,true\n"  // trade_id overflow
+        "13,.,1,1,1640000000012,true\n"
+        "14,0x10,1,1,1640000000013,true\n"
+        "15,-0.004,1,1,1640000000014,true\n"
+        ",42500.5,1,1,1640000000015,true\n"
+        "17,42500.5,1,1,1640000000016";            // no trailing newline
+
+    expect_parity(create_test_file("edge.csv", csv_content));
+}
+
+// The original loader cast these to Price unchecked; they are now skipped
+TEST_F(TradeCsvLoaderTest, SkipsNonFinitePrices) {
+    std::string csv_content =
+        "1,inf,1,1,1640000000000,true\n"
+        "2,nan,1,1,1640000000001,true\n"
+        "3,1e300,1,1,1640000000002,true\n"
+        "4,42500.5,1,1,1640000000003,true\n";
+
+    std::string filepath = create_test_file("non_finite.csv", csv_content);
+    auto trades = loader.load(filepath);
+
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].trade_id, 4);
+    EXPECT_EQ(loader.skipped_rows(), 3);
+}
+
+TEST_F(TradeCsvLoaderTest, MatchesReferenceOnRandomRows) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> cents(1, 10000000);
+    std::uniform_int_distribution<int> extra(0, 99);
+    std::uniform_int_distribution<int> corrupt(0, 19);
+
+    std::string csv_content = "trade_id,price,qty,quote_qty,time,is_buyer_maker,is_best_match\n";
+    uint64_t ts = 1640000000000;
+    for (int i = 0; i < 5000; ++i) {
+        const int c = cents(rng);
+        std::string price = std::to_string(c / 100) + "." + std::to_string(100 + c % 100).substr(1);
+        if (extra(rng) < 10) price += std::to_string(extra(rng));  // off-tick
+        else price += "000000";
+        ts += static_cast<uint64_t>(extra(rng));
+
+        std::string row = std::to_string(1000000 + i) + "," + price + ",0.00100000,42.5," +
+                          std::to_string(ts) + ",True,True";
+        switch (corrupt(rng)) {
+            case 0: row = row.substr(0, row.size() / 2); break;
+            case 1: row[row.find(',') + 1] = 'x'; break;
+            case 2: row += "\r"; break;
+            default: break;
+        }
+        csv_content += row + "\n";
+    }
+
+    expect_parity(create_test_file("random.csv", csv_content));
+}
+
+// Malformed bytes anywhere, including stray separators, NULs and lines
+// longer than the loader's scan chunk
+TEST_F(TradeCsvLoaderTest, MatchesReferenceOnMalformedInput) {
+    std::mt19937_64 rng(9);
+    std::uniform_int_distribution<int> pick(0, 99);
+    // No 'e': random exponents overflow, which is the one place the loaders
+    // intentionally differ (see SkipsNonFinitePrices)
+    const std::string alphabet = "0123456789.,,\n\r -+xabc\t";
+    std::uniform_int_distribution<size_t> letter(0, alphabet.size() - 1);
+
+    std::string csv_content;
+    for (int i = 0; i < 20000; ++i) {
+        const int k = pick(rng);
+        if (k < 60) {
+            csv_content += std::to_string(i) + ",4250" + std::to_string(k) + ".5,1,1,16400000" + std::to_string(i) + ",true\n";
+        } else if (k < 99) {
+            for (int j = pick(rng) % 40; j > 0; --j) csv_content += alphabet[letter(rng)];
+        } else {
+            csv_content += std::string(70000, ',') + std::string(1, '\0') + "\n";
+        }
+    }
+
+    expect_parity(create_test_file("malformed_random.csv", csv_content));
+}
+
+// Rows cut by the scan chunk boundary, and a final row without a newline
+TEST_F(TradeCsvLoaderTest, MatchesReferenceAcrossChunks) {
+    std::string csv_content = "trade_id,price,qty,quote_qty,time,is_buyer_maker\n";
+    for (int i = 0; i < 30000; ++i) {
+        csv_content += std::to_string(i) + "," + std::to_string(40000 + i % 977) + "." +
+                       std::to_string(10 + i % 90) + ",0.001,42.5," + std::to_string(1640000000000 + i) + ",true\n";
+    }
+    csv_content += "30000,42500.00,1,1,1640000030000";
+
+    expect_parity(create_test_file("chunks.csv", csv_content));
+}
+
+TEST_F(TradeCsvLoaderTest, LoadBatchKeepsEveryColumn) {
+    std::string csv_content =
+        "trade_id,price,qty,quote_qty,time,is_buyer_maker,is_best_match\n"
+        "1234567,42500.50,0.02500000,1062.51250000,1640000000000,True,True\n"
+        "1234568,42501.00,1.5,4250.1,1640000001000,false,False\r\n"
+        "1234569,42499.75,0.00000001,0.000424997,1640000002000,1,0\n";
+
+    TradeBatch batch = loader.load_batch(create_test_file("batch.csv", csv_content));
+
+    ASSERT_EQ(batch.size(), 3);
+    EXPECT_EQ(loader.skipped_rows(), 0);
+
+    const TradeRow first = batch.row(0);
+    EXPECT_EQ(first.trade_id, 1234567);
+    EXPECT_EQ(first.price, 4250050);
+    EXPECT_EQ(first.qty, 2500000);            // 0.025 * 1e8
+    EXPECT_EQ(first.quote_qty, 106251250000);  // 1062.5125 * 1e8
+    EXPECT_EQ(first.timestamp, 1640000000000);
+    EXPECT_TRUE(first.is_buyer_maker);
+    EXPECT_TRUE(first.is_best_match);
+
+    EXPECT_EQ(batch.qty[1], 150000000);
+    EXPECT_EQ(batch.quote_qty[1], 425010000000);
+    EXPECT_EQ(batch.is_buyer_maker[1], 0);
+    EXPECT_EQ(batch.is_best_match[1], 0);
+
+    EXPECT_EQ(batch.qty[2], 1);
+    EXPECT_EQ(batch.quote_qty[2], 42500);  // 9th decimal rounds half up
+    EXPECT_EQ(batch.is_buyer_maker[2], 1);
+
+    const Trade trade = batch.trade(2);
+    EXPECT_EQ(trade.trade_id, 1234569);
+    EXPECT_EQ(trade.price, 4249975);
+    EXPECT_EQ(trade.timestamp, 1640000002000);
+}
+
+TEST_F(TradeCsvLoaderTest, LoadBatchWithoutBestMatchColumn) {
+    TradeBatch batch = loader.load_batch(create_test_file("six.csv",
+        "1,42500.00,0.1,4250.0,1640000000000,true\n"
+        "2,42500.00,1e-3,42.5,1640000000001,false"));
+
+    ASSERT_EQ(batch.size(), 2);
+    EXPECT_EQ(batch.qty[1], 100000);  // exponent forms take the slow path
+    EXPECT_EQ(batch.is_best_match[0], 0);
+    EXPECT_EQ(batch.is_best_match[1], 0);
+}
+
+TEST_F(TradeCsvLoaderTest, LoadBatchSkipsMalformedExtraColumns) {
+    std::string csv_content =
+        "1,42500.00,0.1,4250.0,1640000000000,true\n"
+        "2,42500.00,abc,4250.0,1640000000001,true\n"   // bad qty
+        "3,42500.00,0.1,,1640000000002,true\n"         // empty quote_qty
+        "4,42500.00,0.1,4250.0,1640000000003,maybe\n"  // bad side
+        "5,42500.00,0.1,4250.0,1640000000004\n"        // no side
+        "6,42500.00,0.1,4250.0,1640000000005,false\n"
+        "7,42500.00,0.1,4250.0,1640000000006,tomato\n"  // flags must match in full
+        "8,42500.00,0.1,4250.0,1640000000007,10\n"
+        "9,42500.00,0.1,4250.0,1640000000008,0.5\n"
+        "10,42500.00,0.1,4250.0,1640000000009,trueish\n"
+        "11,42500.00,0.1,4250.0,1640000000010,false,True\r\n"
+        "12,42500.00,0.1,4250.0,1640000000011,FALSE,yes\n"
+        "13,42500.00,0.1,4250.0,1640000000012,1,0\r\n";
+
+    const std::string path = create_test_file("bad_columns.csv", csv_content);
+    TradeBatch batch = loader.load_batch(path);
+    ASSERT_EQ(batch.size(), 4);
+    EXPECT_EQ(batch.trade_id[0], 1);
+    EXPECT_EQ(batch.trade_id[1], 6);
+    EXPECT_EQ(batch.trade_id[2], 11);
+    EXPECT_EQ(batch.is_best_match[2], 1);
+    EXPECT_EQ(batch.trade_id[3], 13);
+    EXPECT_EQ(batch.is_buyer_maker[3], 1);
+    EXPECT_EQ(batch.is_best_match[3], 0);
+    EXPECT_EQ(loader.skipped_rows(), 9);
+
+    // The three-column load only needs id, price and time
+    EXPECT_EQ(loader.load(path).size(), 13);
+}
+
+// On any input the batch keeps a subset of load()'s rows, in order, with
+// the same three columns
+TEST_F(TradeCsvLoaderTest, LoadBatchAgreesWithLoad) {
+    std::mt19937_64 rng(5);
+    std::uniform_int_distribution<int> pick(0, 99);
+    std::string csv_content = "trade_id,price,qty,quote_qty,time,is_buyer_maker,is_best_match\n";
+    for (int i = 0; i < 20000; ++i) {
+        const int k = pick(rng);
+        csv_content += std::to_string(i) + ",4250" + std::to_string(k) + ".5,0.0" + std::to_string(k) +
+                       ",1." + std::to_string(i) + ",16400000" + std::to_string(i) +
+                       (k < 50 ? ",True,True\n" : k < 95 ? ",False\n" : k < 98 ? ",\n" : "\n");
+    }
+    const std::string path = create_test_file("agree.csv", csv_content);
+
+    const auto trades = loader.load(path);
+    const size_t skipped = loader.skipped_rows();
+    const TradeBatch batch = loader.load_batch(path);
+    EXPECT_EQ(batch.size() + loader.skipped_rows(), trades.size() + skipped);
+    EXPECT_LT(batch.size(), trades.size());
+
+    size_t j = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        while (j < trades.size() && trades[j].trade_id != batch.trade_id[i]) ++j;
+        ASSERT_LT(j, trades.size()) << "batch row " << i << " not in load()";
+        EXPECT_EQ(trades[j].price, batch.price[i]);
+        EXPECT_EQ(trades[j].timestamp, batch.timestamp[i]);
+    }
+
+    for (ScanIsa isa : {ScanIsa::SCALAR, ScanIsa::SSE2, ScanIsa::AVX2}) {
+        if (!scan_isa_supported(isa)) continue;
+        const TradeBatch other = TradeCsvLoader(isa).load_batch(path);
+        EXPECT_EQ(other.trade_id, batch.trade_id) << scan_isa_name(isa);
+        EXPECT_EQ(other.qty, batch.qty) << scan_isa_name(isa);
+        EXPECT_EQ(other.is_best_match, batch.is_best_match) << scan_isa_name(isa);
+    }
+}
+
+// A zipped CSV loads exactly like the extracted one, including rows cut
+// by inflated block boundaries and lines longer than a scan chunk
+TEST_F(TradeCsvLoaderTest, ZipMatchesCsv) {
+    std::mt19937_64 rng(17);
+    std::uniform_int_distribution<int> pick(0, 999);
+    std::string csv_content = "trade_id,price,qty,quote_qty,time,is_buyer_maker,is_best_match\n";
+    for (int i = 0; i < 60000; ++i) {
+        const int k = pick(rng);
+        if (k == 0) {
+            csv_content += std::string(70000, '7') + "\n";
+        } else if (k < 10) {
+            csv_content += "garbage,row\n";
+        } else {
+            csv_content += std::to_string(i) + "," + std::to_string(40000 + k) + ".25,0.00" + std::to_string(k) +
+                           ",42.5," + std::to_string(1640000000000 + i) + (k % 2 ? ",True,True\n" : ",False,True\n");
+        }
+    }
+    csv_content += "60000,42500.00,1,1,1640000060000,true";  // no final newline
+
+    const std::string csv = create_test_file("day.csv", csv_content);
+    const std::string zip = (test_dir_ / "day.zip").string();
+    write_zip(zip, {{"BTCUSDT-trades-2024-01-15.csv", csv_content}});
+    ASSERT_LT(std::filesystem::file_size(zip), csv_content.size() / 3);
+
+    const auto want = loader.load(csv);
+    const size_t want_skipped = loader.skipped_rows();
+    const auto got = loader.load(zip);
+    EXPECT_EQ(loader.skipped_rows(), want_skipped);
+    ASSERT_EQ(got.size(), want.size());
+    for (size_t i = 0; i < want.size(); ++i) {
+        ASSERT_EQ(got[i].trade_id, want[i].trade_id) << i;
+        ASSERT_EQ(got[i].price, want[i].price) << i;
+        ASSERT_EQ(got[i].timestamp, want[i].timestamp) << i;
+    }
+
+    const TradeBatch want_batch = loader.load_batch(csv);
+    const TradeBatch got_batch = loader.load_batch(zip);
+    EXPECT_EQ(got_batch.trade_id, want_batch.trade_id);
+    EXPECT_EQ(got_batch.qty, want_batch.qty);
+    EXPECT_EQ(got_batch.is_buyer_maker, want_batch.is_buyer_maker);
+
+    TradeCsvReader reader(zip);
+    EXPECT_EQ(reader.file_size(), csv_content.size());
+}
+
+TEST_F(TradeCsvLoaderTest, BadZipThrows) {
+    const std::string zip = create_test_file("bad.zip", "trade_id,price\n1,2\n");
+    EXPECT_THROW(loader.load(zip), std::runtime_error);
+
+    write_zip(zip, {{"empty.csv", ""}});
+    EXPECT_TRUE(loader.load(zip).empty());
+}
+
 }  // namespace signalforge
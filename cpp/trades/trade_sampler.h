@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include "trade_csv_loader.h"
+
+namespace signalforge {
+
+// Sampling rates for historical trades. Each keeps the first trade of its
+// bucket, not an aggregate; use bars (bars.h, DataManager::load_bars) for
+// OHLCV.
+enum class Granularity {
+    RAW,         // All trades (no sampling)
+    PER_SECOND,  // 1 trade per second
+    PER_MINUTE,  // 1 trade per minute (recommended)
+    PER_HOUR,    // 1 trade per hour
+    PER_DAY      // 1 trade per day (its first; DataManager::load_bars gives true OHLC)
+};
+
+// Bucket width in milliseconds, 0 for RAW
+inline uint64_t granularity_ms(Granularity granularity) {
+    switch (granularity) {
+        case Granularity::PER_SECOND:
+            return 1000;  // 1 second
+        case Granularity::PER_MINUTE:
+            return 60 * 1000;  // 60 seconds
+        case Granularity::PER_HOUR:
+            return 60 * 60 * 1000;  // 3600 seconds
+        case Granularity::PER_DAY:
+            return 24 * 60 * 60 * 1000;  // 86400 seconds
+        default:
+            return 0;
+    }
+}
+
+// Keeps the first trade of each time bucket, one trade at a time, so both
+// DataManager and streaming readers sample identically. Reset at the start
+// of each day, as DataManager::load_day samples each day on its own.
+class TradeSampler {
+public:
+    explicit TradeSampler(Granularity granularity) : interval_ms_(granularity_ms(granularity)) {}
+
+    void reset() { last_bucket_ = 0; }
+
+    bool keep(const Trade& trade) { return keep(trade.timestamp); }
+
+    // Same decision from the timestamp alone, for columnar data
+    bool keep(uint64_t timestamp) {
+        if (interval_ms_ == 0) return true;
+
+        const uint64_t current_bucket = timestamp / interval_ms_;
+        if (current_bucket == last_bucket_) return false;
+        last_bucket_ = current_bucket;
+        return true;
+    }
+
+private:
+    uint64_t interval_ms_;
+    uint64_t last_bucket_ = 0;
+};
+
+}  // namespace signalforge
@@ -0,0 +1,191 @@
+#include "trade_stream.h"
+#include <filesystem>
+#include <optional>
+#include <utility>
+
+namespace signalforge {
+
+namespace {
+
+// Trades decoded per read from a cache file
+constexpr size_t kCacheReadTrades = 4096;
+
+struct DayFiles {
+    std::string csv_path;
+    std::string cache_path;
+};
+
+}  // namespace
+
+// Reads one symbol's days in order and hands out its sampled trades
+class TradeStream::SymbolCursor {
+public:
+    SymbolCursor(std::vector<DayFiles> days, bool use_cache, Granularity granularity)
+        : days_(std::move(days)), use_cache_(use_cache), sampler_(granularity) {}
+
+    // Next trade of this symbol, or nullptr once all its days are read
+    const Trade* head() {
+        if (pos_ == buffer_.size() && !refill()) return nullptr;
+        return &buffer_[pos_];
+    }
+
+    // Consecutive buffered trades starting at head(), valid until pop()
+    const Trade* buffered(size_t& count) const {
+        count = buffer_.size() - pos_;
+        return buffer_.data() + pos_;
+    }
+
+    void pop(size_t n = 1) { pos_ += n; }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    bool refill() {
+        buffer_.clear();
+        pos_ = 0;
+
+        while (buffer_.empty()) {
+            if (!csv_ && !in_cache_ && !open_next_day()) return false;
+
+            raw_.clear();
+            bool more;
+            if (in_cache_) {
+                cache_.read(raw_, kCacheReadTrades);
+                more = cache_.remaining() > 0;
+            } else {
+                more = csv_->read_chunk(raw_);
+            }
+            stats_.raw_trades += raw_.size();
+
+            for (const Trade& trade : raw_) {
+                if (sampler_.keep(trade)) buffer_.push_back(trade);
+            }
+
+            if (!more) {
+                if (csv_) stats_.skipped_rows += csv_->skipped_rows();
+                csv_.reset();
+                in_cache_ = false;
+            }
+        }
+        return true;
+    }
+
+    bool open_next_day() {
+        while (next_day_ < days_.size()) {
+            const DayFiles& day = days_[next_day_++];
+
+            std::error_code ec;
+            if (!std::filesystem::exists(day.csv_path, ec)) {
+                ++stats_.days_missing;
+                continue;
+            }
+
+            ++stats_.days_read;
+            sampler_.reset();  // each day is sampled on its own, like load_day
+            if (use_cache_ && cache_.open(day.cache_path, TradeCacheSource::of(day.csv_path))) {
+                ++stats_.days_from_cache;
+                in_cache_ = true;
+            } else {
+                csv_.emplace(day.csv_path);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<DayFiles> days_;
+    size_t next_day_ = 0;
+    bool use_cache_;
+    TradeSampler sampler_;
+
+    // Current day's source: at most one is active
+    std::optional<TradeCsvReader> csv_;
+    TradeCacheReader cache_;
+    bool in_cache_ = false;
+
+    std::vector<Trade> raw_;     // one read before sampling
+    std::vector<Trade> buffer_;  // sampled, waiting to be merged
+    size_t pos_ = 0;
+    Stats stats_;
+};
+
+TradeStream::TradeStream(const DataManager& data,
+                         std::vector<std::string> symbols,
+                         const std::string& start_date,
+                         const std::string& end_date,
+                         Granularity granularity,
+                         size_t chunk_trades)
+    : symbols_(std::move(symbols)),
+      dates_(DataManager::dates_between(start_date, end_date)),
+      chunk_trades_(chunk_trades > 0 ? chunk_trades : 1) {
+    for (const std::string& symbol : symbols_) {
+        std::vector<DayFiles> days;
+        days.reserve(dates_.size());
+        for (const std::string& date : dates_) {
+            days.push_back({data.get_file_path(symbol, date), data.get_cache_path(symbol, date)});
+        }
+        cursors_.push_back(std::make_unique<SymbolCursor>(std::move(days), data.use_cache(), granularity));
+    }
+}
+
+TradeStream::~TradeStream() = default;
+TradeStream::TradeStream(TradeStream&&) noexcept = default;
+TradeStream& TradeStream::operator=(TradeStream&&) noexcept = default;
+
+bool TradeStream::next_chunk(std::vector<StreamTrade>& out) {
+    out.clear();
+
+    while (out.size() < chunk_trades_) {
+        // Earliest and runner-up heads; ties go to the lower symbol index
+        size_t best = cursors_.size();
+        const Trade* best_head = nullptr;
+        const Trade* second_head = nullptr;
+        size_t second = cursors_.size();
+        for (size_t i = 0; i < cursors_.size(); ++i) {
+            const Trade* head = cursors_[i]->head();
+            if (head == nullptr) continue;
+            if (best_head == nullptr || head->timestamp < best_head->timestamp) {
+                second = best;
+                second_head = best_head;
+                best = i;
+                best_head = head;
+            } else if (second_head == nullptr || head->timestamp < second_head->timestamp) {
+                second = i;
+                second_head = head;
+            }
+        }
+        if (best_head == nullptr) break;
+
+        // Take the winner's buffered run for as long as it stays ahead
+        size_t available;
+        const Trade* run = cursors_[best]->buffered(available);
+        const size_t room = chunk_trades_ - out.size();
+        size_t n = 0;
+        while (n < available && n < room &&
+               (second_head == nullptr || run[n].timestamp < second_head->timestamp ||
+                (run[n].timestamp == second_head->timestamp && best < second))) {
+            out.push_back({run[n], static_cast<uint32_t>(best)});
+            ++n;
+        }
+        cursors_[best]->pop(n);
+    }
+
+    trades_ += out.size();
+    return !out.empty();
+}
+
+TradeStream::Stats TradeStream::stats() const {
+    Stats total;
+    total.trades = trades_;
+    for (const auto& cursor : cursors_) {
+        const Stats& s = cursor->stats();
+        total.days_read += s.days_read;
+        total.days_missing += s.days_missing;
+        total.days_from_cache += s.days_from_cache;
+        total.raw_trades += s.raw_trades;
+        total.skipped_rows += s.skipped_rows;
+    }
+    return total;
+}
+
+}  // namespace signalforge
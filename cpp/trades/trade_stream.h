@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "data_manager.h"
+#include "trade_cache.h"
+#include "trade_sampler.h"
+
+namespace signalforge {
+
+// A trade tagged with the symbol it belongs to
+struct StreamTrade {
+    Trade trade;
+    uint32_t symbol;  // index into TradeStream::symbols()
+};
+
+// Pull-based trade source over a date range and a list of symbols.
+//
+// Each (symbol, day) is read incrementally from its binary cache when one
+// is valid, otherwise straight from the CSV, and sampled on the fly exactly
+// as DataManager::load_day samples it. Symbols are merged into one stream
+// ordered by timestamp, ties going to the symbol listed first. Only a
+// chunk per symbol is held at a time, so memory stays constant however
+// long the range is. Days without data are skipped.
+//
+// The stream never writes cache files; warm them with DataManager if the
+// same range will be replayed repeatedly.
+class TradeStream {
+public:
+    static constexpr size_t kDefaultChunkTrades = 64 * 1024;
+
+    struct Stats {
+        size_t days_read = 0;      // (symbol, day) files opened
+        size_t days_missing = 0;   // (symbol, day) pairs without data
+        size_t days_from_cache = 0;
+        size_t raw_trades = 0;     // trades read before sampling
+        size_t trades = 0;         // trades handed out
+        size_t skipped_rows = 0;   // malformed CSV rows
+    };
+
+    // Throws std::runtime_error on a malformed date
+    TradeStream(const DataManager& data,
+                std::vector<std::string> symbols,
+                const std::string& start_date,
+                const std::string& end_date,
+                Granularity granularity = Granularity::RAW,
+                size_t chunk_trades = kDefaultChunkTrades);
+    ~TradeStream();
+
+    TradeStream(TradeStream&&) noexcept;
+    TradeStream& operator=(TradeStream&&) noexcept;
+
+    // Replaces out with the next chunk of up to chunk_trades trades.
+    // Returns false, with out empty, once every day has been read.
+    bool next_chunk(std::vector<StreamTrade>& out);
+
+    const std::vector<std::string>& symbols() const { return symbols_; }
+    const std::vector<std::string>& dates() const { return dates_; }
+    Stats stats() const;
+
+private:
+    class SymbolCursor;
+
+    std::vector<std::string> symbols_;
+    std::vector<std::string> dates_;
+    size_t chunk_trades_;
+    std::vector<std::unique_ptr<SymbolCursor>> cursors_;
+    size_t trades_ = 0;
+};
+
+}  // namespace signalforge
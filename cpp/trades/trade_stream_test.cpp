@@ -0,0 +1,184 @@
+#include "trade_stream.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+namespace signalforge {
+
+class TradeStreamTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "trade_stream_test";
+        std::filesystem::remove_all(test_dir_);
+
+        // BTCUSDT trades every second, ETHUSDT every 1.5 s, both starting on
+        // the same millisecond so the merge has ties to break
+        write_day("BTCUSDT", "2024-01-15", 1000, kDay15, 1000, 100);
+        write_day("BTCUSDT", "2024-01-16", 2000, kDay15 + kDayMs, 1000, 100);
+        write_day("ETHUSDT", "2024-01-15", 5000, kDay15, 1500, 80);
+        // ETHUSDT has no 2024-01-16 file
+        write_day("ETHUSDT", "2024-01-17", 6000, kDay15 + 2 * kDayMs, 1500, 80);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    void write_day(const std::string& symbol, const std::string& date,
+                   uint64_t first_id, uint64_t first_ts, uint64_t step_ms, int count) {
+        std::filesystem::create_directories(test_dir_ / symbol);
+        std::ofstream file((test_dir_ / symbol / ("trades-" + date + ".csv")).string());
+        file << "trade_id,price,qty,quote_qty,time,is_buyer_maker\n";
+        for (int i = 0; i < count; i++) {
+            file << (first_id + i) << "," << (42500 + i) << ".00,0.1,4250.0,"
+                 << (first_ts + i * step_ms) << ",true\n";
+        }
+    }
+
+    static std::vector<StreamTrade> drain(TradeStream& stream) {
+        std::vector<StreamTrade> all;
+        std::vector<StreamTrade> chunk;
+        while (stream.next_chunk(chunk)) {
+            all.insert(all.end(), chunk.begin(), chunk.end());
+        }
+        return all;
+    }
+
+    // The same trades built from per-day DataManager loads
+    std::vector<StreamTrade> expected(const std::vector<std::string>& symbols,
+                                      const std::vector<std::string>& dates,
+                                      Granularity granularity) {
+        DataManager dm(test_dir_.string(), false);
+        std::vector<StreamTrade> all;
+        for (const std::string& date : dates) {
+            for (uint32_t s = 0; s < symbols.size(); ++s) {
+                if (!dm.has_data(symbols[s], date)) continue;
+                for (const Trade& t : dm.load_day(symbols[s], date, granularity)) {
+                    all.push_back({t, s});
+                }
+            }
+        }
+        std::stable_sort(all.begin(), all.end(), [](const StreamTrade& a, const StreamTrade& b) {
+            return a.trade.timestamp < b.trade.timestamp ||
+                   (a.trade.timestamp == b.trade.timestamp && a.symbol < b.symbol);
+        });
+        return all;
+    }
+
+    static void expect_same(const std::vector<StreamTrade>& got, const std::vector<StreamTrade>& want) {
+        ASSERT_EQ(got.size(), want.size());
+        for (size_t i = 0; i < got.size(); ++i) {
+            EXPECT_EQ(got[i].symbol, want[i].symbol) << "row " << i;
+            EXPECT_EQ(got[i].trade.trade_id, want[i].trade.trade_id) << "row " << i;
+            EXPECT_EQ(got[i].trade.price, want[i].trade.price) << "row " << i;
+            EXPECT_EQ(got[i].trade.timestamp, want[i].trade.timestamp) << "row " << i;
+        }
+    }
+
+    static constexpr uint64_t kDay15 = 1705276800000;  // 2024-01-15 00:00 UTC
+    static constexpr uint64_t kDayMs = 24 * 60 * 60 * 1000;
+
+    std::filesystem::path test_dir_;
+};
+
+TEST_F(TradeStreamTest, DatesBetween) {
+    EXPECT_EQ(DataManager::dates_between("2024-02-27", "2024-03-01"),
+              (std::vector<std::string>{"2024-02-27", "2024-02-28", "2024-02-29", "2024-03-01"}));
+    EXPECT_EQ(DataManager::dates_between("2023-12-31", "2024-01-01"),
+              (std::vector<std::string>{"2023-12-31", "2024-01-01"}));
+    EXPECT_TRUE(DataManager::dates_between("2024-01-02", "2024-01-01").empty());
+    EXPECT_THROW(DataManager::dates_between("2024-1-02", "2024-01-03"), std::runtime_error);
+    EXPECT_THROW(DataManager::dates_between("2024-02-30", "2024-03-01"), std::runtime_error);
+}
+
+TEST_F(TradeStreamTest, SingleSymbolMatchesLoadDay) {
+    DataManager dm(test_dir_.string(), false);
+    TradeStream stream(dm, {"BTCUSDT"}, "2024-01-15", "2024-01-16");
+
+    expect_same(drain(stream), expected({"BTCUSDT"}, stream.dates(), Granularity::RAW));
+
+    const TradeStream::Stats stats = stream.stats();
+    EXPECT_EQ(stats.days_read, 2);
+    EXPECT_EQ(stats.days_missing, 0);
+    EXPECT_EQ(stats.raw_trades, 200);
+    EXPECT_EQ(stats.trades, 200);
+}
+
+TEST_F(TradeStreamTest, MergesSymbolsByTimestamp) {
+    DataManager dm(test_dir_.string(), false);
+    const std::vector<std::string> symbols = {"BTCUSDT", "ETHUSDT"};
+    TradeStream stream(dm, symbols, "2024-01-15", "2024-01-17", Granularity::RAW, 7);
+
+    const std::vector<StreamTrade> all = drain(stream);
+    expect_same(all, expected(symbols, stream.dates(), Granularity::RAW));
+
+    // Ties go to the symbol listed first
+    ASSERT_GE(all.size(), 2);
+    EXPECT_EQ(all[0].symbol, 0);
+    EXPECT_EQ(all[1].symbol, 1);
+    EXPECT_EQ(all[0].trade.timestamp, all[1].trade.timestamp);
+
+    const TradeStream::Stats stats = stream.stats();
+    EXPECT_EQ(stats.days_read, 4);
+    EXPECT_EQ(stats.days_missing, 2);
+    EXPECT_EQ(stats.trades, all.size());
+}
+
+TEST_F(TradeStreamTest, SamplesEachDayLikeLoadDay) {
+    DataManager dm(test_dir_.string(), false);
+    const std::vector<std::string> symbols = {"BTCUSDT", "ETHUSDT"};
+
+    for (Granularity g : {Granularity::PER_SECOND, Granularity::PER_MINUTE, Granularity::PER_DAY}) {
+        TradeStream stream(dm, symbols, "2024-01-15", "2024-01-17", g, 3);
+        const std::vector<StreamTrade> all = drain(stream);
+        expect_same(all, expected(symbols, stream.dates(), g));
+        EXPECT_EQ(stream.stats().raw_trades, 360);
+    }
+}
+
+TEST_F(TradeStreamTest, ChunksAreBounded) {
+    DataManager dm(test_dir_.string(), false);
+    TradeStream stream(dm, {"BTCUSDT", "ETHUSDT"}, "2024-01-15", "2024-01-17", Granularity::RAW, 16);
+
+    std::vector<StreamTrade> chunk;
+    size_t total = 0;
+    while (stream.next_chunk(chunk)) {
+        EXPECT_LE(chunk.size(), 16);
+        total += chunk.size();
+    }
+    EXPECT_TRUE(chunk.empty());
+    EXPECT_EQ(total, 360);
+    EXPECT_FALSE(stream.next_chunk(chunk));
+}
+
+TEST_F(TradeStreamTest, ReadsWarmCache) {
+    DataManager dm(test_dir_.string());
+    dm.load_day("BTCUSDT", "2024-01-15", Granularity::RAW);
+    dm.load_day("ETHUSDT", "2024-01-15", Granularity::RAW);
+
+    const std::vector<std::string> symbols = {"BTCUSDT", "ETHUSDT"};
+    TradeStream stream(dm, symbols, "2024-01-15", "2024-01-17", Granularity::RAW, 5);
+    expect_same(drain(stream), expected(symbols, stream.dates(), Granularity::RAW));
+
+    EXPECT_EQ(stream.stats().days_from_cache, 2);
+    EXPECT_EQ(stream.stats().days_read, 4);
+
+    // Cold days stay uncached
+    EXPECT_FALSE(std::filesystem::exists(dm.get_cache_path("BTCUSDT", "2024-01-16")));
+}
+
+TEST_F(TradeStreamTest, EmptyRangeAndUnknownSymbol) {
+    DataManager dm(test_dir_.string(), false);
+    std::vector<StreamTrade> chunk;
+
+    TradeStream none(dm, {"XRPUSDT"}, "2024-01-15", "2024-01-16");
+    EXPECT_FALSE(none.next_chunk(chunk));
+    EXPECT_EQ(none.stats().days_missing, 2);
+
+    TradeStream reversed(dm, {"BTCUSDT"}, "2024-01-16", "2024-01-15");
+    EXPECT_FALSE(reversed.next_chunk(chunk));
+
+    EXPECT_THROW(TradeStream(dm, {"BTCUSDT"}, "yesterday", "2024-01-15"), std::runtime_error);
+}
+
+}  // namespace signalforge
@@ -1,6 +1,8 @@
 #!/bin/bash
 # Download historical BTCUSDT trade data from Binance
 # Supports date ranges and skips already-downloaded files
+# Keeps the zips as downloaded (DataManager reads them directly); --extract
+# unpacks them to CSV instead
 
 set -e  # Exit on error
 
@@ -18,6 +20,8 @@ OPTIONS:
     -d, --days N          Download last N days (default: 7)
     -s, --start DATE      Start date (YYYY-MM-DD)
     -e, --end DATE        End date (YYYY-MM-DD, default: yesterday)
+    -x, --extract         Unpack to trades-DATE.csv instead of keeping
+                          trades-DATE.zip (~5x the disk space, no faster)
     -h, --help            Show this help message
 
 EXAMPLES:
@@ -42,6 +46,7 @@ DATA_DIR="data"
 DAYS=""
 START_DATE=""
 END_DATE=""
+EXTRACT=0
 
 # Shift past the symbol argument if provided
 if [[ "$1" != -* ]] && [[ -n "$1" ]]; then
@@ -63,6 +68,10 @@ while [[ $# -gt 0 ]]; do
             END_DATE="$2"
             shift 2
             ;;
+        -x|--extract)
+            EXTRACT=1
+            shift
+            ;;
         -h|--help)
             show_help
             exit 0
@@ -134,6 +143,11 @@ else
 fi
 
 echo "Data directory: $DATA_DIR"
+if [[ $EXTRACT -eq 1 ]]; then
+    echo "Format: CSV (extracted)"
+else
+    echo "Format: zip (as downloaded)"
+fi
 echo ""
 
 # Create data directory
@@ -191,8 +205,8 @@ for DATE in "${dates[@]}"; do
 
     echo "[$count/$total] Processing $DATE..."
 
-    # Check if already exists
-    if [ -f "$DATA_DIR/$SYMBOL/trades-${DATE}.csv" ]; then
+    # Check if already exists, in either format
+    if [ -f "$DATA_DIR/$SYMBOL/trades-${DATE}.csv" ] || [ -f "$DATA_DIR/$SYMBOL/trades-${DATE}.zip" ]; then
         echo "  ✓ Already exists, skipping"
         skipped=$((skipped + 1))
         continue
@@ -220,6 +234,14 @@ for DATE in "${dates[@]}"; do
         continue
     fi
 
+    # Keep the zip under the name DataManager looks for
+    if [[ $EXTRACT -eq 0 ]] && [ -f "$DATA_DIR/$SYMBOL/${FILENAME}.zip" ]; then
+        mv "$DATA_DIR/$SYMBOL/${FILENAME}.zip" "$DATA_DIR/$SYMBOL/trades-${DATE}.zip"
+        echo "  ✓ Downloaded"
+        downloaded=$((downloaded + 1))
+        continue
+    fi
+
     # Unzip
     if [ -f "$DATA_DIR/$SYMBOL/${FILENAME}.zip" ]; then
         if unzip -q -o "$DATA_DIR/$SYMBOL/${FILENAME}.zip" -d "$DATA_DIR/$SYMBOL" 2>/dev/null; then
@@ -247,16 +269,16 @@ echo ""
 
 # List downloaded files in chronological order
 if [ -d "$DATA_DIR/$SYMBOL" ]; then
-    csv_count=$(ls -1 "$DATA_DIR/$SYMBOL/"*.csv 2>/dev/null | wc -l | xargs)
-    echo "Total CSV files: $csv_count"
+    file_count=$(ls -1 "$DATA_DIR/$SYMBOL/trades-"*.csv "$DATA_DIR/$SYMBOL/trades-"*.zip 2>/dev/null | wc -l | xargs)
+    echo "Total data files: $file_count"
 
-    if [ $csv_count -gt 0 ]; then
+    if [ $file_count -gt 0 ]; then
         echo ""
         echo "Available dates:"
-        ls -1 "$DATA_DIR/$SYMBOL/trades-"*.csv 2>/dev/null | \
+        ls -1 "$DATA_DIR/$SYMBOL/trades-"*.csv "$DATA_DIR/$SYMBOL/trades-"*.zip 2>/dev/null | \
             sed 's/.*trades-/  /' | \
-            sed 's/.csv$//' | \
-            sort
+            sed -e 's/\.csv$//' -e 's/\.zip$//' | \
+            sort -u
     fi
 fi
 